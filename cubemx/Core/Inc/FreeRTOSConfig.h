@@ -45,6 +45,8 @@
 
 /* USER CODE BEGIN Includes */
 #include "core/fault_handler.h"
+#include "diagnostics/RunTimeCounter.h"
+#include "diagnostics/TraceHooks.h"
 /* USER CODE END Includes */
 
 /* Ensure definitions are only used by the compiler, and not by the assembler. */
@@ -64,6 +66,7 @@
 #define configSUPPORT_DYNAMIC_ALLOCATION         1
 #define configUSE_IDLE_HOOK                      0
 #define configUSE_TICK_HOOK                      0
+#define configUSE_MALLOC_FAILED_HOOK             1
 #define configCPU_CLOCK_HZ                       ( SystemCoreClock )
 #define configTICK_RATE_HZ                       ((TickType_t)1000)
 #define configMAX_PRIORITIES                     ( 56 )
@@ -166,6 +169,21 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+#define configGENERATE_RUN_TIME_STATS            1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() configureRunTimeCounter()
+#define portGET_RUN_TIME_COUNTER_VALUE()         getRunTimeCounterValue()
+
+/* the idle task is identified by its name for the CPU load */
+#define configIDLE_TASK_NAME                     "IDLE"
+
+/* the stack size of each task is read by freertos_tasks_c_additions.h for the stack report */
+#define configRECORD_STACK_HIGH_ADDRESS          1
+#define configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H 1
+
+/* task switches are traced if the scheduler category is enabled, see diagnostics/Trace.hpp */
+#if defined(TRACE_CATEGORIES) && (TRACE_CATEGORIES & 1)
+#define traceTASK_SWITCHED_IN()                  traceTaskSwitchedIn(pxCurrentTCB->uxTCBNumber)
+#endif
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
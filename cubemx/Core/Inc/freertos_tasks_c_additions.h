@@ -0,0 +1,11 @@
+#pragma once
+
+/* Included at the end of tasks.c with configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H, so it can access
+ * the task control block. Used by diagnostics/RunTimeStatistics.cxx */
+
+/* @return stack size in words, requires configRECORD_STACK_HIGH_ADDRESS */
+uint32_t getTaskStackSize(TaskHandle_t task)
+{
+    const TCB_t *tcb = prvGetTCBFromHandle(task);
+    return (uint32_t)(tcb->pxEndOfStack - tcb->pxStack) + 1;
+}
@@ -72,6 +72,18 @@ extern TIM_HandleTypeDef htim7;
 void NMI_Handler(void)
 {
   /* USER CODE BEGIN NonMaskableInt_IRQn 0 */
+  /* double ECC error in settings region, e.g. a record torn by a power loss */
+  /* the read data is rejected by the CRC of the record, so it is safe to continue */
+  extern uint8_t _settings_start[];
+  extern uint8_t _settings_end[];
+  const uint32_t EccAddress = FLASH_BASE + (FLASH->ECCR & FLASH_ECCR_ADDR_ECC);
+  if (__HAL_FLASH_GET_FLAG(FLASH_FLAG_ECCD) && EccAddress >= (uint32_t)_settings_start &&
+      EccAddress < (uint32_t)_settings_end)
+  {
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ECCD);
+    return;
+  }
+
   faultHandler();
   /* USER CODE END NonMaskableInt_IRQn 0 */
   /* USER CODE BEGIN NonMaskableInt_IRQn 1 */
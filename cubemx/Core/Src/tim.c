@@ -250,7 +250,9 @@ void HAL_TIM_Base_MspInit(TIM_HandleTypeDef* tim_baseHandle)
     /* TIM15 clock enable */
     __HAL_RCC_TIM15_CLK_ENABLE();
   /* USER CODE BEGIN TIM15_MspInit 1 */
-
+    /* update interrupt is enabled only while LED strip uses fractional PWM */
+    HAL_NVIC_SetPriority(TIM1_BRK_TIM15_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(TIM1_BRK_TIM15_IRQn);
   /* USER CODE END TIM15_MspInit 1 */
   }
 }
@@ -351,7 +353,7 @@ void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef* tim_baseHandle)
     /* Peripheral clock disable */
     __HAL_RCC_TIM15_CLK_DISABLE();
   /* USER CODE BEGIN TIM15_MspDeInit 1 */
-
+    HAL_NVIC_DisableIRQ(TIM1_BRK_TIM15_IRQn);
   /* USER CODE END TIM15_MspDeInit 1 */
   }
 }
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "rtc/AT24C32.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// I2C slave model of the AT24C32, with the same interface as I2cAccessor. Memory is backed by an
+/// image file, every write cycle is written through to the file.
+///
+/// Like the real device it does not acknowledge for some polls after a write, and a write crossing
+/// a page boundary wraps around to the start of the page.
+class At24c32Model
+{
+public:
+    explicit At24c32Model(std::string fileName, size_t busyPolls = 3)
+        : fileName(std::move(fileName)), busyPolls(busyPolls), memory(at24c32::Size, 0xFF)
+    {
+        std::ifstream file(this->fileName, std::ios::binary);
+        if (file)
+            file.read(reinterpret_cast<char *>(memory.data()), memory.size());
+    }
+
+    void beginTransaction(uint8_t address)
+    {
+        if (isInTransaction)
+            throw std::logic_error("nested I2C transaction");
+
+        isInTransaction = true;
+        currentAddress = address;
+    }
+
+    void endTransaction()
+    {
+        isInTransaction = false;
+    }
+
+    /// current address read
+    bool read(uint8_t *buffer, size_t length)
+    {
+        if (!acknowledge())
+            return false;
+
+        for (size_t i = 0; i < length; i++)
+        {
+            buffer[i] = memory[addressPointer];
+            addressPointer = (addressPointer + 1) % at24c32::Size;
+        }
+        return true;
+    }
+
+    template <typename RegisterAddress>
+    bool readFromRegister(RegisterAddress registerAddress, uint8_t *buffer, size_t length)
+    {
+        static_assert(sizeof(RegisterAddress) == 2, "AT24C32 has 16 bit word addresses");
+
+        if (!acknowledge())
+            return false;
+
+        addressPointer = registerAddress % at24c32::Size;
+        return read(buffer, length);
+    }
+
+    template <typename RegisterAddress>
+    bool writeToRegister(RegisterAddress registerAddress, const uint8_t *data, size_t length)
+    {
+        static_assert(sizeof(RegisterAddress) == 2, "AT24C32 has 16 bit word addresses");
+
+        if (!acknowledge())
+            return false;
+
+        const size_t PageStart = registerAddress % at24c32::Size / at24c32::PageSize * at24c32::PageSize;
+        size_t offset = registerAddress % at24c32::PageSize;
+
+        for (size_t i = 0; i < length; i++)
+        {
+            memory[PageStart + offset] = data[i];
+            offset = (offset + 1) % at24c32::PageSize;
+        }
+
+        numberOfWriteCycles++;
+        busyPollsLeft = busyPolls;
+        save();
+        return true;
+    }
+
+    bool hasError() const
+    {
+        return false;
+    }
+
+    /// simulates a module without EEPROM
+    void setPresent(bool present)
+    {
+        isPresent = present;
+    }
+
+    size_t getNumberOfWriteCycles() const
+    {
+        return numberOfWriteCycles;
+    }
+
+    size_t getNumberOfNacks() const
+    {
+        return numberOfNacks;
+    }
+
+private:
+    std::string fileName;
+    size_t busyPolls;
+    std::vector<uint8_t> memory;
+
+    bool isInTransaction = false;
+    bool isPresent = true;
+    uint8_t currentAddress = 0;
+    size_t addressPointer = 0;
+    size_t busyPollsLeft = 0;
+
+    size_t numberOfWriteCycles = 0;
+    size_t numberOfNacks = 0;
+
+    bool acknowledge()
+    {
+        if (!isInTransaction)
+            throw std::logic_error("I2C access outside of a transaction");
+
+        if (!isPresent || currentAddress != at24c32::SlaveAddress || busyPollsLeft > 0)
+        {
+            busyPollsLeft -= std::min<size_t>(busyPollsLeft, 1);
+            numberOfNacks++;
+            return false;
+        }
+        return true;
+    }
+
+    void save() const
+    {
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(memory.data()), memory.size());
+    }
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "serial/CommandShell.hpp"
+
+#include <chrono>
+#include <functional>
+#include <string_view>
+
+/// Keeps all values in memory, the clock runs with an offset to the system clock.
+class FakeShellTarget : public ShellTarget
+{
+public:
+    using Output = std::function<void(std::string_view)>;
+
+    explicit FakeShellTarget(Output output) : output(std::move(output))
+    {
+    }
+
+    void writeOutput(std::string_view text) override
+    {
+        output(text);
+    }
+
+    std::optional<ShellTime> getTime() override
+    {
+        const auto Now = std::chrono::system_clock::now() + offset;
+        const auto SecondsOfDay = std::chrono::duration_cast<std::chrono::seconds>(Now.time_since_epoch()).count() %
+                                  (24 * 60 * 60);
+
+        return ShellTime{static_cast<uint8_t>(SecondsOfDay / 3600), static_cast<uint8_t>(SecondsOfDay / 60 % 60),
+                         static_cast<uint8_t>(SecondsOfDay % 60)};
+    }
+
+    bool setTime(const ShellTime &time) override
+    {
+        const auto Current = *getTime();
+        const auto Difference = (time.hour - Current.hour) * 3600 + (time.minute - Current.minute) * 60 +
+                                (time.second - Current.second);
+        offset += std::chrono::seconds{Difference};
+        return true;
+    }
+
+    std::optional<Date> getDate() override
+    {
+        return date;
+    }
+
+    bool setDate(const Date &newDate) override
+    {
+        date = newDate;
+        return true;
+    }
+
+    Alarm getAlarm(uint8_t index) override
+    {
+        return alarms[index];
+    }
+
+    void setAlarm(uint8_t index, const Alarm &alarm) override
+    {
+        alarms[index] = alarm;
+    }
+
+    AlarmSequence getAlarmSequence() override
+    {
+        return alarmSequence;
+    }
+
+    void setAlarmSequence(const AlarmSequence &sequence) override
+    {
+        alarmSequence = sequence;
+    }
+
+    vibration::PatternId getVibrationPattern(uint8_t index) override
+    {
+        return vibrationPatterns[index];
+    }
+
+    void setVibrationPattern(uint8_t index, vibration::PatternId pattern) override
+    {
+        vibrationPatterns[index] = pattern;
+    }
+
+    uint8_t getBrightness() override
+    {
+        return brightness;
+    }
+
+    void setBrightness(uint8_t brightness) override
+    {
+        this->brightness = brightness;
+    }
+
+    uint16_t getColorTemperature() override
+    {
+        return colorTemperature;
+    }
+
+    void setColorTemperature(uint16_t kelvin) override
+    {
+        colorTemperature = kelvin;
+    }
+
+    void printStats() override
+    {
+        writeOutput("host: pseudo terminal\n");
+    }
+
+    void printStacks() override
+    {
+        writeOutput("host: no stacks\n");
+    }
+
+    bool printTrace() override
+    {
+        return false;
+    }
+
+private:
+    Output output;
+    std::chrono::seconds offset{0};
+    Date date{1, 1, calendar::FirstYear, 6};
+    Alarm alarms[MaximumAlarms]{{6 * 60 + 30, Alarm::Workdays, true}, {9 * 60, Alarm::Weekend, true}};
+    AlarmSequence alarmSequence{};
+    vibration::PatternId vibrationPatterns[MaximumAlarms]{};
+    uint8_t brightness = 50;
+    uint16_t colorTemperature = 4000;
+};
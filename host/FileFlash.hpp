@@ -0,0 +1,98 @@
+#pragma once
+
+#include "settings/FlashBackend.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Flash region backed by an image file, every change is written through to the file.
+/// It behaves like STM32L4 flash: a double word can be programmed only once after an erase.
+class FileFlash : public FlashBackend
+{
+public:
+    FileFlash(std::string fileName, size_t pageSize, size_t numberOfPages)
+        : fileName(std::move(fileName)), pageSize(pageSize), numberOfPages(numberOfPages),
+          image(pageSize * numberOfPages, 0xFF)
+    {
+        std::ifstream file(this->fileName, std::ios::binary);
+        if (file)
+            file.read(reinterpret_cast<char *>(image.data()), image.size());
+    }
+
+    size_t getPageSize() const override
+    {
+        return pageSize;
+    }
+
+    size_t getNumberOfPages() const override
+    {
+        return numberOfPages;
+    }
+
+    void read(size_t address, std::span<uint8_t> buffer) override
+    {
+        checkRange(address, buffer.size());
+        std::memcpy(buffer.data(), image.data() + address, buffer.size());
+    }
+
+    bool programDoubleWord(size_t address, uint64_t doubleWord) override
+    {
+        checkRange(address, ProgramUnit);
+
+        if (address % ProgramUnit != 0 ||
+            !std::all_of(image.begin() + address, image.begin() + address + ProgramUnit,
+                         [](uint8_t byte) { return byte == 0xFF; }))
+            return false;
+
+        std::memcpy(image.data() + address, &doubleWord, ProgramUnit);
+        numberOfPrograms++;
+        save();
+        return true;
+    }
+
+    bool erasePage(size_t page) override
+    {
+        if (page >= numberOfPages)
+            return false;
+
+        std::fill_n(image.begin() + page * pageSize, pageSize, 0xFF);
+        numberOfErases++;
+        save();
+        return true;
+    }
+
+    size_t getNumberOfPrograms() const
+    {
+        return numberOfPrograms;
+    }
+
+    size_t getNumberOfErases() const
+    {
+        return numberOfErases;
+    }
+
+private:
+    std::string fileName;
+    size_t pageSize;
+    size_t numberOfPages;
+    std::vector<uint8_t> image;
+
+    size_t numberOfPrograms = 0;
+    size_t numberOfErases = 0;
+
+    void checkRange(size_t address, size_t length) const
+    {
+        if (address + length > image.size())
+            throw std::out_of_range("flash access outside of image");
+    }
+
+    void save() const
+    {
+        std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(image.data()), image.size());
+    }
+};
@@ -0,0 +1,176 @@
+#include "FakeShellTarget.hpp"
+#include "link/LinkEndpoint.hpp"
+#include "link/SerialDemultiplexer.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+/// one direction of the serial line, which drops and flips bytes at random
+class LossyLine : public esp::LinkTransport
+{
+public:
+    LossyLine(std::mt19937 &random, double errorRate) : random(random), errorRate(errorRate)
+    {
+    }
+
+    void writeFrame(std::span<const uint8_t> frame) override
+    {
+        write(frame);
+    }
+
+    void write(std::span<const uint8_t> data)
+    {
+        std::bernoulli_distribution isBroken{errorRate};
+        std::uniform_int_distribution<int> bit{0, 7};
+
+        for (auto byte : data)
+        {
+            if (isBroken(random))
+            {
+                if (bit(random) < 4)
+                    continue; // lost
+
+                byte ^= 1 << bit(random);
+                numberOfErrors++;
+            }
+            bytes.push_back(byte);
+        }
+    }
+
+    /// takes a random amount of bytes, like the idle line interrupt does
+    std::vector<uint8_t> receive()
+    {
+        std::uniform_int_distribution<size_t> chunk{0, 16};
+        const auto Length = std::min(chunk(random), bytes.size());
+
+        std::vector<uint8_t> data(bytes.begin(), bytes.begin() + Length);
+        bytes.erase(bytes.begin(), bytes.begin() + Length);
+        return data;
+    }
+
+    size_t getNumberOfErrors() const
+    {
+        return numberOfErrors;
+    }
+
+private:
+    std::mt19937 &random;
+    double errorRate;
+    std::deque<uint8_t> bytes;
+    size_t numberOfErrors = 0;
+};
+
+/// collects the received light commands in order
+class Receiver : public esp::LinkHandler
+{
+public:
+    std::vector<uint16_t> colorTemperatures;
+    size_t telemetryRequests = 0;
+
+    void handleMessage(esp::MessageType type, std::span<const uint8_t> payload) override
+    {
+        if (type == esp::MessageType::LightControl)
+            colorTemperatures.push_back(
+                esp::LinkEndpoint::decodePayload<esp::LightControl>(payload).colorTemperature);
+
+        else if (type == esp::MessageType::TelemetryRequest)
+            telemetryRequests++;
+    }
+};
+
+void printStatistics(const char *name, const esp::LinkEndpoint::Statistics &statistics)
+{
+    std::printf("%s: %u frames, %u invalid, %u duplicates, %u retransmissions, %u lost\n", name,
+                statistics.receivedFrames, statistics.invalidFrames, statistics.duplicates,
+                statistics.retransmissions, statistics.lostMessages);
+}
+} // namespace
+
+/// Stands in for the ESP: sends light commands to a simulated clock over a lossy line, while shell
+/// commands are mixed into the same line. Time is virtual, one step equals one millisecond.
+/// usage: link-loopback [messages] [error rate]
+int main(int argc, char **argv)
+{
+    const size_t NumberOfMessages = argc > 1 ? std::atoi(argv[1]) : 1000;
+    const double ErrorRate = argc > 2 ? std::atof(argv[2]) : 0.001;
+    constexpr uint32_t RetransmitTimeout = 50;
+
+    std::mt19937 random{1};
+    LossyLine toClock{random, ErrorRate};
+    LossyLine toEsp{random, ErrorRate};
+
+    std::string shellOutput;
+    FakeShellTarget shellTarget{[&](std::string_view text) { shellOutput += text; }};
+    CommandShell shell{shellTarget};
+
+    Receiver clockReceiver;
+    Receiver espReceiver;
+    esp::LinkEndpoint clock{toEsp, clockReceiver, RetransmitTimeout};
+    esp::LinkEndpoint esp{toClock, espReceiver, RetransmitTimeout};
+    esp::SerialDemultiplexer clockSide{shell, clock};
+    esp::SerialDemultiplexer espSide{shell, esp};
+
+    std::vector<uint16_t> sent;
+    uint32_t now = 0;
+
+    while (sent.size() < NumberOfMessages || !esp.isIdle())
+    {
+        now++;
+
+        if (esp.isIdle() && sent.size() < NumberOfMessages)
+        {
+            const esp::LightControl Message{1, 50, static_cast<uint16_t>(2700 + sent.size() % 3800)};
+            esp.send(Message, now);
+            sent.push_back(Message.colorTemperature);
+
+            if (sent.size() % 100 == 0)
+            {
+                const std::string Command = "get brightness\n";
+                toClock.write({reinterpret_cast<const uint8_t *>(Command.data()), Command.size()});
+            }
+        }
+
+        clockSide.feed(toClock.receive());
+        espSide.feed(toEsp.receive());
+        clock.update(now);
+        esp.update(now);
+    }
+
+    printStatistics("clock", clock.getStatistics());
+    printStatistics("esp", esp.getStatistics());
+    std::printf("%zu byte errors, %zu shell replies, %u ms\n", toClock.getNumberOfErrors() + toEsp.getNumberOfErrors(),
+                static_cast<size_t>(std::count(shellOutput.begin(), shellOutput.end(), '\n')),
+                static_cast<unsigned>(now));
+
+    // messages may only be missing after all retries, but never be duplicated or reordered
+    size_t expected = 0;
+    for (const auto Received : clockReceiver.colorTemperatures)
+    {
+        while (expected < sent.size() && sent[expected] != Received)
+            expected++;
+
+        if (expected == sent.size())
+        {
+            std::puts("FAIL: message order broken or duplicated");
+            return EXIT_FAILURE;
+        }
+        expected++;
+    }
+
+    // a message given up by the sender may still have arrived, only its acks were lost
+    const size_t Missing = sent.size() - clockReceiver.colorTemperatures.size();
+    if (Missing > esp.getStatistics().lostMessages)
+    {
+        std::printf("FAIL: %zu messages missing, %u reported as lost\n", Missing, esp.getStatistics().lostMessages);
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%zu of %zu messages delivered\n", clockReceiver.colorTemperatures.size(), sent.size());
+    return EXIT_SUCCESS;
+}
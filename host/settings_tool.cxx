@@ -0,0 +1,117 @@
+#include "At24c32Model.hpp"
+#include "FileFlash.hpp"
+#include "rtc/AT24C32.hpp"
+#include "settings/EepromSettingsStore.hpp"
+#include "settings/SettingsStore.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+// same geometry as the settings region of the firmware
+constexpr size_t PageSize = 2048;
+constexpr size_t NumberOfPages = 4;
+
+using Eeprom = AT24C32<At24c32Model>;
+
+namespace
+{
+void printUsage()
+{
+    std::puts("usage: settings-tool [--eeprom] <image> dump\n"
+              "       settings-tool [--eeprom] <image> get <key>\n"
+              "       settings-tool [--eeprom] <image> set <key> <value> [repetitions]\n"
+              "--eeprom uses an image of the AT24C32 instead of the internal flash");
+}
+
+void dump(const SettingsStorage &store)
+{
+    for (uint8_t key = 0; key < SettingsStore::MaximumKeys; key++)
+    {
+        if (const auto Value = store.get(key))
+            std::printf("%2u: %u\n", key, static_cast<unsigned>(*Value));
+    }
+}
+
+int run(SettingsStorage &store, int argc, char **argv)
+{
+    if (!store.mount())
+    {
+        std::puts("mount failed");
+        return EXIT_FAILURE;
+    }
+
+    const std::string_view Command{argv[0]};
+
+    if (Command == "dump")
+        dump(store);
+
+    else if (Command == "get" && argc == 2)
+    {
+        const auto Value = store.get(std::atoi(argv[1]));
+        if (!Value)
+            return EXIT_FAILURE;
+
+        std::printf("%u\n", static_cast<unsigned>(*Value));
+    }
+
+    else if (Command == "set" && argc >= 3)
+    {
+        // repetitions simulate one flush per change, to show page rotation and wear
+        const int Repetitions = argc == 4 ? std::atoi(argv[3]) : 1;
+        for (int i = 0; i < Repetitions; i++)
+        {
+            store.set(std::atoi(argv[1]), std::strtoul(argv[2], nullptr, 0) + i);
+            if (!store.flush())
+            {
+                std::puts("flush failed");
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    else
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const bool UseEeprom = argc > 1 && std::string_view{argv[1]} == "--eeprom";
+    if (UseEeprom)
+    {
+        argc--;
+        argv++;
+    }
+
+    if (argc < 3)
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    if (UseEeprom)
+    {
+        At24c32Model model{argv[1]};
+        Eeprom eeprom{model, nullptr};
+        EepromSettingsStore<Eeprom, at24c32::PageSize> store{eeprom};
+
+        const auto Result = run(store, argc - 2, argv + 2);
+        std::printf("%zu write cycles, %zu NACKs while busy\n", model.getNumberOfWriteCycles(),
+                    model.getNumberOfNacks());
+        return Result;
+    }
+
+    FileFlash flash{argv[1], PageSize, NumberOfPages};
+    SettingsStore store{flash};
+
+    const auto Result = run(store, argc - 2, argv + 2);
+    std::printf("active page %zu, sequence number %u, %zu programs, %zu erases\n", store.getActivePage(),
+                static_cast<unsigned>(store.getSequenceNumber()), flash.getNumberOfPrograms(),
+                flash.getNumberOfErases());
+    return Result;
+}
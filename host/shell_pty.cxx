@@ -0,0 +1,49 @@
+#include "FakeShellTarget.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+/// Runs the command shell of the firmware on a pseudo terminal, connect to it with any terminal
+/// program, e.g. "picocom --echo /dev/pts/5"
+int main()
+{
+    const int Master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (Master < 0 || grantpt(Master) != 0 || unlockpt(Master) != 0)
+    {
+        std::perror("pseudo terminal");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("shell is listening on %s\n", ptsname(Master));
+    std::fflush(stdout);
+
+    // the terminal expects CR LF
+    FakeShellTarget target{[Master](std::string_view text)
+                           {
+                               for (const auto Character : text)
+                               {
+                                   if (Character == '\n')
+                                       ::write(Master, "\r", 1);
+
+                                   ::write(Master, &Character, 1);
+                               }
+                           }};
+    CommandShell shell{target};
+
+    while (true)
+    {
+        uint8_t buffer[64];
+        const auto Length = ::read(Master, buffer, sizeof(buffer));
+
+        // reading fails while no terminal is connected
+        if (Length <= 0)
+        {
+            usleep(100'000);
+            continue;
+        }
+
+        shell.feed({buffer, static_cast<size_t>(Length)});
+    }
+}
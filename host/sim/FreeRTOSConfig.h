@@ -0,0 +1,88 @@
+#pragma once
+
+/* FreeRTOS configuration of the host simulation. It has to be found before the one of the target in
+ * cubemx/Core/Inc. The kernel features and API functions are the same, but the time passes in
+ * ticks of the idle task, see port/port.cxx */
+
+#include "diagnostics/TraceHooks.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    extern uint32_t SystemCoreClock;
+    uint32_t getSimulationRunTimeCounter(void);
+    void simulationAssertFailed(const char *file, int line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define configUSE_PREEMPTION 1
+#define configSUPPORT_STATIC_ALLOCATION 1
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configUSE_IDLE_HOOK 1
+#define configUSE_TICK_HOOK 0
+#define configUSE_MALLOC_FAILED_HOOK 1
+#define configCPU_CLOCK_HZ (SystemCoreClock)
+#define configTICK_RATE_HZ ((TickType_t)1000)
+#define configMAX_PRIORITIES (56)
+#define configMINIMAL_STACK_SIZE ((uint16_t)128)
+#define configTOTAL_HEAP_SIZE ((size_t)(256 * 1024))
+#define configMAX_TASK_NAME_LEN (16)
+#define configUSE_TRACE_FACILITY 1
+#define configUSE_16_BIT_TICKS 0
+#define configUSE_MUTEXES 1
+#define configQUEUE_REGISTRY_SIZE 8
+#define configCHECK_FOR_STACK_OVERFLOW 0
+#define configUSE_RECURSIVE_MUTEXES 1
+#define configUSE_COUNTING_SEMAPHORES 1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configMESSAGE_BUFFER_LENGTH_TYPE size_t
+
+/* the idle task advances the time, it jumps over ticks without any event */
+#define configUSE_TICKLESS_IDLE 1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2
+
+#define configUSE_CO_ROUTINES 0
+#define configMAX_CO_ROUTINE_PRIORITIES (2)
+
+#define configUSE_TIMERS 1
+#define configTIMER_TASK_PRIORITY (2)
+#define configTIMER_QUEUE_LENGTH 10
+#define configTIMER_TASK_STACK_DEPTH 256
+
+#define INCLUDE_vTaskPrioritySet 1
+#define INCLUDE_uxTaskPriorityGet 1
+#define INCLUDE_vTaskDelete 1
+#define INCLUDE_vTaskCleanUpResources 0
+#define INCLUDE_vTaskSuspend 1
+#define INCLUDE_vTaskDelayUntil 1
+#define INCLUDE_vTaskDelay 1
+#define INCLUDE_xTaskGetSchedulerState 1
+#define INCLUDE_xTimerPendFunctionCall 1
+#define INCLUDE_xQueueGetMutexHolder 1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+#define INCLUDE_xTaskGetCurrentTaskHandle 1
+#define INCLUDE_eTaskGetState 1
+
+#define configASSERT(x)                                                                                                \
+    if ((x) == 0)                                                                                                      \
+    {                                                                                                                  \
+        simulationAssertFailed(__FILE__, __LINE__);                                                                    \
+    }
+
+#define configGENERATE_RUN_TIME_STATS 1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE() getSimulationRunTimeCounter()
+#define configIDLE_TASK_NAME "IDLE"
+
+#define configRECORD_STACK_HIGH_ADDRESS 1
+#define configINCLUDE_FREERTOS_TASK_C_ADDITIONS_H 1
+
+#if defined(TRACE_CATEGORIES) && (TRACE_CATEGORIES & 1)
+#define traceTASK_SWITCHED_IN() traceTaskSwitchedIn(pxCurrentTCB->uxTCBNumber)
+#endif
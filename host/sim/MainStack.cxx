@@ -0,0 +1,22 @@
+#include "diagnostics/MainStack.hpp"
+
+// Stands in for src/diagnostics/MainStack.cxx. The interrupts of the simulation run on the stack
+// of the idle task, so there is no main stack to measure.
+namespace diagnostics
+{
+void paintMainStack()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t getMainStackSize()
+{
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t getMainStackHighWaterMark()
+{
+    return 0;
+}
+} // namespace diagnostics
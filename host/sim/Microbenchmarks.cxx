@@ -0,0 +1,221 @@
+#include "alarm/AlarmSchedule.hpp"
+#include "display/Display.hpp"
+#include "display/font/Font.hpp"
+#include "hal/FakeHal.hpp"
+#include "LED/LedStrip.hpp"
+#include "LED/SunriseCurve.hpp"
+#include "rtc/DS3231.hpp"
+#include "rtc/Time/Time.hpp"
+#include "rtc/TimeOfDay.hpp"
+#include "tim.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+/// Microbenchmarks of the hot paths of the firmware, compiled for the host with the fake HAL.
+/// Each benchmark has a fixed number of iterations, so the results of two revisions are comparable.
+/// The best of several runs is printed as CSV, one line per benchmark:
+/// benchmark,iterations,ns_per_iteration
+namespace
+{
+constexpr int DefaultNumberOfRuns = 5;
+
+struct Benchmark
+{
+    std::string_view name;
+    uint32_t iterations;
+    void (*iteration)(uint32_t);
+};
+
+/// the compiler has to assume that the value is used
+template <typename T>
+void keep(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// the LED service is not running, changes are dropped
+class IdleLedActivity : public LedActivity
+{
+public:
+    void notifyChange() override
+    {
+    }
+
+    void setBlinking(uint32_t, bool) override
+    {
+    }
+};
+
+constexpr uint32_t WarmWhiteChannel = TIM_CHANNEL_1;
+constexpr uint32_t ColdWhiteChannel = TIM_CHANNEL_2;
+
+/// constructed after the fake peripherals have been initialized
+struct Firmware
+{
+    DisplayDimming dimming{&htim1, TIM_CHANNEL_1};
+    Display display{dimming};
+
+    IdleLedActivity ledActivity;
+    LedStrip ledStrip{ledActivity, &htim15, WarmWhiteChannel, ColdWhiteChannel};
+};
+
+Firmware *firmware = nullptr;
+
+//--------------------------------------------------------------------------------------------------
+/// all grids differ from the published ones in every iteration, so each one is encoded
+void publishFrame(uint32_t i)
+{
+    for (auto &grid : firmware->display.getGridDataArray())
+    {
+        grid.segments = font.getGlyph('0' + i % 10);
+        grid.enableDots = (i & 1) != 0;
+    }
+    firmware->display.publishFrame();
+}
+
+//--------------------------------------------------------------------------------------------------
+void showClock(uint32_t i)
+{
+    firmware->display.setClock(Time(i / 60 % 24, i % 60, i % 60));
+    firmware->display.showClock();
+    keep(firmware->display.getGridDataArray());
+}
+
+//--------------------------------------------------------------------------------------------------
+void getGlyph(uint32_t i)
+{
+    keep(font.getGlyph(static_cast<uint8_t>(i % Font::NumberOfGlyphs)));
+}
+
+//--------------------------------------------------------------------------------------------------
+void convertBcd(uint32_t i)
+{
+    const auto Bcd = ds3231::decToBcd(static_cast<uint8_t>(i % 100));
+    keep(Bcd);
+    keep(ds3231::bcdToDec(Bcd));
+}
+
+//--------------------------------------------------------------------------------------------------
+/// like RealTimeClock::checkIfAlarmShouldTrigger() for all alarms, one iteration per second
+void checkAlarmTime(uint32_t i)
+{
+    static AlarmSchedule schedule = []
+    {
+        AlarmSchedule newSchedule;
+        for (uint8_t alarm = 0; alarm < MaximumAlarms; alarm++)
+            newSchedule.setAlarm(alarm, {static_cast<uint16_t>(6 * 60 + alarm * 35), Alarm::Workdays, true});
+
+        return newSchedule;
+    }();
+
+    keep(schedule.poll(i));
+}
+
+//--------------------------------------------------------------------------------------------------
+void setColorTemperature(uint32_t i)
+{
+    const auto Kelvin = cct::WarmKelvin + i % (cct::ColdKelvin - cct::WarmKelvin);
+    firmware->ledStrip.setColorTemperature(static_cast<uint16_t>(Kelvin));
+}
+
+//--------------------------------------------------------------------------------------------------
+/// both channels of the strip are gamma corrected
+void setStripBrightness(uint32_t i)
+{
+    firmware->ledStrip.setGlobalBrightness(static_cast<uint8_t>(i % 101));
+}
+
+//--------------------------------------------------------------------------------------------------
+void calculateSunriseLuminance(uint32_t i)
+{
+    keep(sunrise::calculateLuminance(static_cast<uint16_t>(i), static_cast<uint8_t>(i % 101)));
+}
+
+const Benchmark Benchmarks[] = {
+    {"display-multiplexing", 1'000'000, [](uint32_t) { firmware->display.multiplexingInterrupt(); }},
+    {"display-publish-frame", 1'000'000, publishFrame},
+    {"display-show-clock", 1'000'000, showClock},
+    {"font-get-glyph", 10'000'000, getGlyph},
+    {"ds3231-bcd", 10'000'000, convertBcd},
+    {"rtc-alarm-check", 1'000'000, checkAlarmTime},
+    {"strip-color-temperature", 1'000'000, setColorTemperature},
+    {"strip-gamma-correction", 1'000'000, setStripBrightness},
+    {"sunrise-luminance", 10'000'000, calculateSunriseLuminance},
+};
+
+//--------------------------------------------------------------------------------------------------
+/// @return nanoseconds per iteration of the fastest run
+double measure(const Benchmark &benchmark, int numberOfRuns)
+{
+    using Clock = std::chrono::steady_clock;
+    auto fastestRun = Clock::duration::max();
+
+    for (int run = 0; run < numberOfRuns; run++)
+    {
+        const auto Start = Clock::now();
+        for (uint32_t i = 0; i < benchmark.iterations; i++)
+            benchmark.iteration(i);
+
+        fastestRun = std::min(fastestRun, Clock::now() - Start);
+    }
+
+    return std::chrono::duration<double, std::nano>(fastestRun).count() / benchmark.iterations;
+}
+
+//--------------------------------------------------------------------------------------------------
+void printUsage()
+{
+    std::fputs("usage: microbenchmarks [--runs <number>] [<name filter>]\n"
+               "Prints the best run of each benchmark as CSV: benchmark,iterations,ns_per_iteration\n",
+               stderr);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int numberOfRuns = DefaultNumberOfRuns;
+    std::string_view filter;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view Argument{argv[i]};
+
+        if (Argument == "--runs" && i + 1 < argc)
+            numberOfRuns = std::atoi(argv[++i]);
+
+        else if (Argument.starts_with("-") || !filter.empty())
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        else
+            filter = Argument;
+    }
+
+    if (numberOfRuns <= 0)
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    sim::hal::initialize();
+    static Firmware theFirmware;
+    firmware = &theFirmware;
+
+    std::puts("benchmark,iterations,ns_per_iteration");
+    for (const auto &Benchmark : Benchmarks)
+    {
+        if (Benchmark.name.find(filter) == std::string_view::npos)
+            continue;
+
+        std::printf("%.*s,%u,%.3f\n", static_cast<int>(Benchmark.name.size()), Benchmark.name.data(),
+                    static_cast<unsigned>(Benchmark.iterations), measure(Benchmark, numberOfRuns));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,464 @@
+#include "Simulator.hpp"
+#include "Application.hpp"
+#include "port/VirtualTime.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+namespace
+{
+constexpr int64_t SecondsPerDay = 24 * 60 * 60;
+constexpr int DefaultPressDuration = 100; // milliseconds
+
+struct ButtonPin
+{
+    std::string_view name;
+    Simulator::Button button;
+    GPIO_TypeDef *port;
+    uint16_t pin;
+};
+
+const std::array ButtonPins{
+    ButtonPin{"left", Simulator::Button::Left, ButtonLeft_GPIO_Port, ButtonLeft_Pin},
+    ButtonPin{"right", Simulator::Button::Right, ButtonRight_GPIO_Port, ButtonRight_Pin},
+    ButtonPin{"snooze", Simulator::Button::Snooze, ButtonSnooze_GPIO_Port, ButtonSnooze_Pin},
+    ButtonPin{"brightness+", Simulator::Button::BrightnessPlus, ButtonBrightnessPlus_GPIO_Port,
+              ButtonBrightnessPlus_Pin},
+    ButtonPin{"brightness-", Simulator::Button::BrightnessMinus, ButtonBrightnessMinus_GPIO_Port,
+              ButtonBrightnessMinus_Pin},
+    ButtonPin{"cct+", Simulator::Button::CctPlus, ButtonCCTPlus_GPIO_Port, ButtonCCTPlus_Pin},
+    ButtonPin{"cct-", Simulator::Button::CctMinus, ButtonCCTMinus_GPIO_Port, ButtonCCTMinus_Pin},
+};
+
+struct OutputName
+{
+    std::string_view name;
+    Simulator::Output output;
+};
+
+const std::array OutputNames{
+    OutputName{"display", Simulator::Output::Display}, OutputName{"alarm1", Simulator::Output::Alarm1},
+    OutputName{"alarm2", Simulator::Output::Alarm2},   OutputName{"red", Simulator::Output::Red},
+    OutputName{"green", Simulator::Output::Green},     OutputName{"strip", Simulator::Output::Strip},
+    OutputName{"vibration", Simulator::Output::Vibration},
+};
+
+const ButtonPin &getButtonPin(Simulator::Button button)
+{
+    return *std::find_if(ButtonPins.begin(), ButtonPins.end(),
+                         [button](const ButtonPin &buttonPin) { return buttonPin.button == button; });
+}
+
+//--------------------------------------------------------------------------------------------------
+std::string_view getOutputName(Simulator::Output output)
+{
+    return std::find_if(OutputNames.begin(), OutputNames.end(),
+                        [output](const OutputName &outputName) { return outputName.output == output; })
+        ->name;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// splits at whitespace, a token in double quotes may contain whitespace
+std::optional<std::vector<std::string_view>> tokenize(std::string_view line)
+{
+    constexpr std::string_view Whitespace = " \t\r\n";
+    std::vector<std::string_view> tokens;
+
+    for (auto begin = line.find_first_not_of(Whitespace); begin != std::string_view::npos;
+         begin = line.find_first_not_of(Whitespace, begin))
+    {
+        if (line[begin] == '"')
+        {
+            const auto End = line.find('"', begin + 1);
+            if (End == std::string_view::npos)
+                return {};
+
+            tokens.push_back(line.substr(begin + 1, End - begin - 1));
+            begin = End + 1;
+            continue;
+        }
+
+        const auto End = std::min(line.find_first_of(Whitespace, begin), line.size());
+        tokens.push_back(line.substr(begin, End - begin));
+        begin = End;
+    }
+
+    return tokens;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// parses `[<day>] HH:MM:SS` at the index and advances it
+std::optional<int64_t> parseClockTime(const std::vector<std::string_view> &tokens, size_t &index,
+                                      int64_t startTime)
+{
+    int day = 0;
+    if (index < tokens.size() && tokens[index].find(':') == std::string_view::npos)
+        day = std::atoi(std::string{tokens[index++]}.c_str());
+
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+    if (index == tokens.size() ||
+        std::sscanf(std::string{tokens[index++]}.c_str(), "%d:%d:%d", &hour, &minute, &second) != 3)
+        return {};
+
+    const auto StartOfDay = startTime - startTime % SecondsPerDay;
+    return StartOfDay + day * SecondsPerDay + hour * 3600 + minute * 60 + second;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<Simulator::Step> parseLine(std::string_view line, int64_t startTime)
+{
+    const auto Tokens = tokenize(line);
+    if (!Tokens)
+        return {};
+
+    size_t index = 0;
+    const auto Time = parseClockTime(*Tokens, index, startTime);
+    if (!Time || index == Tokens->size())
+        return {};
+
+    const auto Action = (*Tokens)[index++];
+    const auto NumberOfArguments = Tokens->size() - index;
+    Simulator::Step step{*Time, Simulator::Step::Action::Press};
+
+    if (Action == "press" && (NumberOfArguments == 1 || NumberOfArguments == 2))
+    {
+        const auto Name = (*Tokens)[index++];
+        const auto *Pin = std::find_if(ButtonPins.begin(), ButtonPins.end(),
+                                       [&Name](const ButtonPin &buttonPin) { return buttonPin.name == Name; });
+        const auto Duration =
+            index < Tokens->size() ? std::atoi(std::string{(*Tokens)[index]}.c_str()) : DefaultPressDuration;
+        if (Pin == ButtonPins.end() || Duration <= 0)
+            return {};
+
+        step.button = Pin->button;
+        step.duration = static_cast<uint32_t>(Duration);
+        return step;
+    }
+
+    if (Action == "expect" && NumberOfArguments == 2)
+    {
+        const auto Name = (*Tokens)[index++];
+        const auto *Output = std::find_if(OutputNames.begin(), OutputNames.end(),
+                                          [&Name](const OutputName &outputName) { return outputName.name == Name; });
+        const auto State = (*Tokens)[index];
+        if (Output == OutputNames.end() ||
+            (Output->output != Simulator::Output::Display && State != "on" && State != "off"))
+            return {};
+
+        step.action = Simulator::Step::Action::Expect;
+        step.output = Output->output;
+        step.expectedState = State;
+        return step;
+    }
+
+    if (Action == "i2c" && (NumberOfArguments == 1 || NumberOfArguments == 2))
+    {
+        const auto Fault = (*Tokens)[index++];
+        const auto Value = index < Tokens->size() ? std::atoi(std::string{(*Tokens)[index]}.c_str()) : 1;
+        if (Value <= 0 || (Fault == "stuck" && NumberOfArguments != 2))
+            return {};
+
+        if (Fault == "stuck")
+        {
+            step.action = Simulator::Step::Action::HoldBus;
+            step.duration = static_cast<uint32_t>(Value);
+            return step;
+        }
+
+        if (Fault != "nack" && Fault != "timeout")
+            return {};
+
+        step.action = Simulator::Step::Action::InjectFault;
+        step.fault = Fault == "nack" ? sim::hal::I2cFault::Nack : sim::hal::I2cFault::Timeout;
+        step.numberOfFrames = static_cast<uint32_t>(Value);
+        return step;
+    }
+
+    if (Action == "rtc" && NumberOfArguments == 2 && (*Tokens)[index] == "temperature")
+    {
+        step.action = Simulator::Step::Action::SetTemperature;
+        step.temperature = std::strtof(std::string{(*Tokens)[index + 1]}.c_str(), nullptr);
+        return step;
+    }
+
+    if (Action == "jump")
+    {
+        const auto JumpTime = parseClockTime(*Tokens, index, startTime);
+        if (!JumpTime || index != Tokens->size())
+            return {};
+
+        step.action = Simulator::Step::Action::Jump;
+        step.jumpTime = *JumpTime;
+        return step;
+    }
+
+    return {};
+}
+
+//--------------------------------------------------------------------------------------------------
+/// the dots are blinking, so they are not compared
+std::string withoutDots(std::string_view text)
+{
+    std::string result;
+    std::copy_if(text.begin(), text.end(), std::back_inserter(result), [](char c) { return c != ':'; });
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// the text of the shown grids by the font, a ':' follows a grid with dots
+std::string decodeDisplay(const std::array<Display::GridData, Display::NumberOfGrids> &grids)
+{
+    std::string text;
+    for (const auto &Grid : grids)
+    {
+        char character = '?';
+        for (int c = ' '; c < static_cast<int>(Font::NumberOfGlyphs); c++)
+        {
+            if (font.getGlyph(static_cast<uint8_t>(c)) == Grid.segments)
+            {
+                character = static_cast<char>(c);
+                break;
+            }
+        }
+
+        text += Grid.segments == 0 ? ' ' : character;
+        if (Grid.enableDots)
+            text += ':';
+    }
+
+    const auto Begin = text.find_first_not_of(' ');
+    if (Begin == std::string::npos)
+        return {};
+
+    return text.substr(Begin, text.find_last_not_of(' ') - Begin + 1);
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+std::optional<std::vector<Simulator::Step>> Simulator::parseScenario(std::FILE *file) const
+{
+    std::vector<Step> scenario;
+    std::array<char, 256> line{};
+    size_t lineNumber = 0;
+    int64_t clockTime = startTime;
+
+    while (std::fgets(line.data(), line.size(), file) != nullptr)
+    {
+        lineNumber++;
+        if (auto *comment = std::strchr(line.data(), '#'); comment != nullptr)
+            *comment = '\0';
+
+        if (std::strspn(line.data(), " \t\r\n") == std::strlen(line.data()))
+            continue;
+
+        const auto TheStep = parseLine(line.data(), startTime);
+        if (!TheStep || TheStep->time < clockTime)
+        {
+            std::fprintf(stderr, "invalid step in line %zu of the scenario\n", lineNumber);
+            return {};
+        }
+
+        clockTime = TheStep->action == Step::Action::Jump ? TheStep->jumpTime : TheStep->time;
+        scenario.push_back(*TheStep);
+    }
+
+    return scenario;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Simulator::run(std::vector<Step> scenario)
+{
+    steps = std::move(scenario);
+    nextStep = 0;
+    sim::scheduleInterrupt(sim::getTime(), [this] { executeDueSteps(); });
+}
+
+//--------------------------------------------------------------------------------------------------
+void Simulator::scheduleEnd(uint64_t time)
+{
+    sim::scheduleInterrupt(time, [this] { endSimulation(); });
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Steps are scheduled one after the other, because a jump moves the times of all following steps.
+void Simulator::executeDueSteps()
+{
+    for (; nextStep < steps.size(); nextStep++)
+    {
+        const auto &TheStep = steps[nextStep];
+        if (TheStep.time > rtcModel.getTime())
+        {
+            sim::scheduleInterrupt(rtcModel.getVirtualTime(TheStep.time), [this] { executeDueSteps(); });
+            return;
+        }
+
+        execute(TheStep);
+    }
+
+    // the last step has to be processed by the firmware before its state is reported
+    scheduleEnd(sim::getTime() + 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+void Simulator::execute(const Step &step)
+{
+    switch (step.action)
+    {
+    case Step::Action::Press:
+    {
+        const auto &Pin = getButtonPin(step.button);
+        printClockTime(rtcModel.getTime());
+        std::printf("%.*s pressed\n", static_cast<int>(Pin.name.size()), Pin.name.data());
+
+        // the buttons are low active
+        sim::hal::setInputPin(Pin.port, Pin.pin, false);
+        sim::scheduleInterrupt(sim::getTime() + step.duration,
+                               [&Pin] { sim::hal::setInputPin(Pin.port, Pin.pin, true); });
+        break;
+    }
+
+    case Step::Action::Expect:
+    {
+        const auto State = getState(step.output);
+        const bool IsMatching = step.output == Output::Display
+                                    ? withoutDots(State) == withoutDots(step.expectedState)
+                                    : State == step.expectedState;
+        numberOfExpectations++;
+        if (IsMatching)
+            break;
+
+        numberOfFailures++;
+        const auto Name = getOutputName(step.output);
+        printClockTime(rtcModel.getTime());
+        std::printf("FAILED: expected %.*s \"%s\", but it is \"%s\"\n", static_cast<int>(Name.size()), Name.data(),
+                    step.expectedState.c_str(), State.c_str());
+        break;
+    }
+
+    case Step::Action::Jump:
+        rtcModel.setTime(step.jumpTime);
+        printClockTime(rtcModel.getTime());
+        std::puts("clock set");
+        break;
+
+    case Step::Action::InjectFault:
+        sim::hal::injectI2cFault(Ds3231Model::Address, step.fault, step.numberOfFrames);
+        break;
+
+    case Step::Action::HoldBus:
+        sim::hal::holdI2cBus(step.duration);
+        break;
+
+    case Step::Action::SetTemperature:
+        rtcModel.setTemperature(step.temperature);
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+std::string Simulator::getState(Output output) const
+{
+    auto isOn = [](const TIM_HandleTypeDef *timer, uint32_t channel)
+    { return __HAL_TIM_GET_COMPARE(timer, channel) > 0; };
+
+    auto &app = Application::getApplicationInstance();
+    bool isEnabled = false;
+
+    switch (output)
+    {
+    case Output::Display:
+        if (!sim::hal::getOutputPin(enable35V_GPIO_Port, enable35V_Pin))
+            return "off";
+        return decodeDisplay(app.display.getPublishedGridDataArray());
+
+    case Output::Alarm1:
+        isEnabled = isOn(Application::StatusLedPwmTimer, Application::LedAlarm1Channel);
+        break;
+
+    case Output::Alarm2:
+        isEnabled = isOn(Application::StatusLedPwmTimer, Application::LedAlarm2Channel);
+        break;
+
+    case Output::Red:
+        isEnabled = isOn(Application::StatusLedPwmTimer, Application::LedRedChannel);
+        break;
+
+    case Output::Green:
+        isEnabled = isOn(Application::StatusLedPwmTimer, Application::LedGreenChannel);
+        break;
+
+    case Output::Strip:
+        // low levels of a sunrise are dithered by the update interrupt, which writes the compare registers
+        isEnabled = __HAL_TIM_GET_IT_SOURCE(Application::LedStripPwmTimer, TIM_IT_UPDATE) == SET ||
+                    isOn(Application::LedStripPwmTimer, Application::WarmWhiteChannel) ||
+                    isOn(Application::LedStripPwmTimer, Application::ColdWhiteChannel);
+        break;
+
+    case Output::Vibration:
+        // the pin follows the steps of the pattern, so it is off in the pauses
+        isEnabled = app.vibrationCushion.isPlaying();
+        break;
+    }
+
+    return isEnabled ? "on" : "off";
+}
+
+//--------------------------------------------------------------------------------------------------
+void Simulator::printClockTime(int64_t time) const
+{
+    const auto Day = time / SecondsPerDay - startTime / SecondsPerDay;
+    const auto SecondOfDay = time % SecondsPerDay;
+    std::printf("[%d %02d:%02d:%02d] ", static_cast<int>(Day), static_cast<int>(SecondOfDay / 3600),
+                static_cast<int>(SecondOfDay / 60 % 60), static_cast<int>(SecondOfDay % 60));
+}
+
+//--------------------------------------------------------------------------------------------------
+void Simulator::printReport()
+{
+    const auto Hours = static_cast<double>(sim::getTime()) / (3600.0 * 1000.0);
+    printClockTime(rtcModel.getTime());
+    std::printf("end of the simulation after %.1f hours\n\n", Hours);
+
+    std::vector<TaskStatus_t> tasks(uxTaskGetNumberOfTasks());
+    tasks.resize(uxTaskGetSystemState(tasks.data(), tasks.size(), nullptr));
+    std::sort(tasks.begin(), tasks.end(),
+              [](const TaskStatus_t &a, const TaskStatus_t &b) { return a.xTaskNumber < b.xTaskNumber; });
+
+    std::printf("%-16s %10s %10s\n", "task", "wakeups", "per hour");
+    for (const auto &Task : tasks)
+    {
+        const auto Wakeups = sim::getWakeups(Task.xHandle);
+        std::printf("%-16s %10u %10.0f\n", Task.pcTaskName, static_cast<unsigned>(Wakeups), Wakeups / Hours);
+    }
+
+    const auto &I2c = sim::hal::getI2cStatistics();
+    std::printf("\nI2C: %u transfers, %u bytes, %u errors, %u timeouts\n", static_cast<unsigned>(I2c.transfers),
+                static_cast<unsigned>(I2c.bytes), static_cast<unsigned>(I2c.errors),
+                static_cast<unsigned>(I2c.timeouts));
+
+    const auto &Frames = Application::getApplicationInstance().display.getFrameStatistics();
+    std::printf("display: %u frames rendered, %u skipped, %u grids published\n",
+                static_cast<unsigned>(Frames.renderedFrames), static_cast<unsigned>(Frames.skippedFrames),
+                static_cast<unsigned>(Frames.publishedGrids));
+
+    if (numberOfExpectations > 0)
+        std::printf("expectations: %u passed, %u failed\n",
+                    static_cast<unsigned>(numberOfExpectations - numberOfFailures),
+                    static_cast<unsigned>(numberOfFailures));
+}
+
+//--------------------------------------------------------------------------------------------------
+void Simulator::endSimulation()
+{
+    printReport();
+    std::fflush(stdout);
+
+    // the tasks never return, so the scheduler cannot be ended regularly
+    std::_Exit(numberOfFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
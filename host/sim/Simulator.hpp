@@ -0,0 +1,109 @@
+#pragma once
+
+#include "devices/Ds3231Model.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+/// Drives the firmware in virtual time by the steps of a scenario. Buttons are pressed at the pins,
+/// expectations are checked against the shown grids and the PWM outputs, and a report of the task
+/// wakeups, I2C transfers and rendered frames is printed at the end.
+class Simulator
+{
+public:
+    enum class Button
+    {
+        Left,
+        Right,
+        Snooze,
+        BrightnessPlus,
+        BrightnessMinus,
+        CctPlus,
+        CctMinus
+    };
+
+    enum class Output
+    {
+        Display,
+        Alarm1,
+        Alarm2,
+        Red,
+        Green,
+        Strip,
+        Vibration
+    };
+
+    struct Step
+    {
+        enum class Action
+        {
+            Press,
+            Expect,
+            Jump,
+            InjectFault,
+            HoldBus,
+            SetTemperature
+        };
+
+        int64_t time; // of the clock, seconds since 2000
+        Action action;
+
+        Button button = Button::Left;
+        uint32_t duration = 0; // milliseconds, also of a held bus
+
+        Output output = Output::Display;
+        std::string expectedState; // on, off or the text of the display
+
+        int64_t jumpTime = 0; // new time of the clock
+
+        sim::hal::I2cFault fault = sim::hal::I2cFault::Nack;
+        uint32_t numberOfFrames = 0;
+
+        float temperature = 0; // °C
+    };
+
+    Simulator(Ds3231Model &rtcModel, int64_t startTime) : rtcModel(rtcModel), startTime(startTime)
+    {
+    }
+
+    /// Lines of the scenario are `[<day>] HH:MM:SS <action>`, '#' starts a comment. The time is the
+    /// UTC time of the RTC, the display shows local time. The day counts from the start of the
+    /// simulation. Actions are
+    ///   press <button> [<milliseconds>]     left, right, snooze, brightness+, brightness-, cct+, cct-
+    ///   expect display off|"<text>"        the dots are ignored, e.g. "06:30" matches 0630
+    ///   expect <led> on|off                alarm1, alarm2, red, green, strip
+    ///   expect vibration on|off            on while a pattern is played, also in its pauses
+    ///   jump [<day>] HH:MM:SS              sets the RTC forward, the time in between is skipped
+    ///   i2c nack|timeout [<frames>]        the next frames to the RTC fail
+    ///   i2c stuck <milliseconds>           SDA is held low
+    ///   rtc temperature <°C>               measured by the next conversion of the RTC
+    /// The clock is read by the firmware once a second, so an expectation should leave it a second.
+    /// @return nothing if a line is malformed or a step is before the time of the clock
+    std::optional<std::vector<Step>> parseScenario(std::FILE *file) const;
+
+    /// the process exits after the last step
+    void run(std::vector<Step> scenario);
+
+    /// the process exits after the report
+    void scheduleEnd(uint64_t time);
+
+private:
+    Ds3231Model &rtcModel;
+    const int64_t startTime;
+
+    std::vector<Step> steps;
+    size_t nextStep = 0;
+    uint32_t numberOfExpectations = 0;
+    uint32_t numberOfFailures = 0;
+
+    void executeDueSteps();
+    void execute(const Step &step);
+    std::string getState(Output output) const;
+
+    void printClockTime(int64_t time) const;
+    void printReport();
+    [[noreturn]] void endSimulation();
+};
@@ -0,0 +1,304 @@
+#include "Ds3231Model.hpp"
+#include "port/VirtualTime.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr int64_t SecondsPerDay = 24 * 60 * 60;
+
+// days from 1970-01-01 to 2000-01-01
+constexpr int64_t EpochOffset = 10957;
+
+constexpr uint8_t Seconds = 0x00;
+constexpr uint8_t DayOfWeek = 0x03;
+constexpr uint8_t Year = 0x06;
+constexpr uint8_t Alarm1Seconds = 0x07;
+constexpr uint8_t Alarm2Minutes = 0x0b;
+constexpr uint8_t AlarmMask = 0x80;
+constexpr uint8_t DayOfWeekSelect = 0x40;
+constexpr uint8_t Control = 0x0e;
+constexpr uint8_t Status = 0x0f;
+constexpr uint8_t MsbTemperature = 0x11;
+constexpr uint8_t LsbTemperature = 0x12;
+
+constexpr uint8_t ConvertTemperature = 0x20;
+constexpr uint8_t Busy = 0x04;
+constexpr uint8_t Alarm1Flag = 0x01;
+constexpr uint8_t Alarm2Flag = 0x02;
+
+// milliseconds
+constexpr uint64_t ConversionTime = 125;
+constexpr uint64_t AutomaticConversionPeriod = 64 * 1000;
+
+struct Date
+{
+    int year;
+    int month;
+    int day;
+};
+
+uint8_t toBcd(int value)
+{
+    return static_cast<uint8_t>(((value / 10) << 4) | (value % 10));
+}
+
+int fromBcd(uint8_t value)
+{
+    return (value >> 4) * 10 + (value & 0x0f);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// days since 2000-01-01, see http://howardhinnant.github.io/date_algorithms.html
+int64_t toDays(Date date)
+{
+    const int64_t Year = date.year - (date.month <= 2 ? 1 : 0);
+    const int64_t Era = Year / 400;
+    const int64_t YearOfEra = Year - Era * 400;
+    const int64_t DayOfYear = (153 * (date.month > 2 ? date.month - 3 : date.month + 9) + 2) / 5 + date.day - 1;
+    const int64_t DayOfEra = YearOfEra * 365 + YearOfEra / 4 - YearOfEra / 100 + DayOfYear;
+    return Era * 146097 + DayOfEra - 719468 - EpochOffset;
+}
+
+//--------------------------------------------------------------------------------------------------
+Date toDate(int64_t days)
+{
+    const int64_t Z = days + EpochOffset + 719468;
+    const int64_t Era = Z / 146097;
+    const int64_t DayOfEra = Z - Era * 146097;
+    const int64_t YearOfEra = (DayOfEra - DayOfEra / 1460 + DayOfEra / 36524 - DayOfEra / 146096) / 365;
+    const int64_t DayOfYear = DayOfEra - (365 * YearOfEra + YearOfEra / 4 - YearOfEra / 100);
+    const int64_t MonthIndex = (5 * DayOfYear + 2) / 153;
+    const int Day = static_cast<int>(DayOfYear - (153 * MonthIndex + 2) / 5 + 1);
+    const int Month = static_cast<int>(MonthIndex < 10 ? MonthIndex + 3 : MonthIndex - 9);
+    return {static_cast<int>(YearOfEra + Era * 400 + (Month <= 2 ? 1 : 0)), Month, Day};
+}
+} // namespace
+
+Ds3231Model::Ds3231Model()
+{
+    // power-on values, the oscillator stop flag is set until the time is written
+    registers[Control] = 0x1c;
+    registers[Status] = 0x88;
+    registers[MsbTemperature] = 25;
+    setTime(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+void Ds3231Model::setTime(int64_t secondsSince2000)
+{
+    referenceSeconds = secondsSince2000;
+    referenceTime = sim::getTime();
+    lastMatchedSecond = secondsSince2000 - 1;
+    updateTimeRegisters();
+}
+
+//--------------------------------------------------------------------------------------------------
+int64_t Ds3231Model::getTime() const
+{
+    return referenceSeconds + static_cast<int64_t>((sim::getTime() - referenceTime) / 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint64_t Ds3231Model::getVirtualTime(int64_t secondsSince2000) const
+{
+    return referenceTime + static_cast<uint64_t>(secondsSince2000 - referenceSeconds) * 1000;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Ds3231Model::setAlarm1(int hour, int minute)
+{
+    // the day is masked, so the alarm matches every day
+    registers[Alarm1Seconds] = 0;
+    registers[Alarm1Seconds + 1] = toBcd(minute);
+    registers[Alarm1Seconds + 2] = toBcd(hour);
+    registers[Alarm1Seconds + 3] = AlarmMask;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Ds3231Model::setAlarm2(int hour, int minute)
+{
+    registers[Alarm2Minutes] = toBcd(minute);
+    registers[Alarm2Minutes + 1] = toBcd(hour);
+    registers[Alarm2Minutes + 2] = AlarmMask;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Ds3231Model::setTemperature(float celsius)
+{
+    temperature = static_cast<int16_t>(std::lround(celsius * 4));
+}
+
+//--------------------------------------------------------------------------------------------------
+bool Ds3231Model::start(bool isRead)
+{
+    updateTimeRegisters();
+    matchAlarms();
+    updateConversion();
+    isFirstWrittenByte = !isRead;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool Ds3231Model::write(uint8_t byte)
+{
+    if (isFirstWrittenByte)
+    {
+        isFirstWrittenByte = false;
+        pointer = byte % NumberOfRegisters;
+        return true;
+    }
+
+    if (pointer <= Year)
+    {
+        isTimeWritten = true;
+        isSecondsWritten |= pointer == Seconds;
+        isDayOfWeekWritten |= pointer == DayOfWeek;
+    }
+
+    if (pointer == Control && (byte & ConvertTemperature) != 0 && (registers[Control] & ConvertTemperature) == 0)
+        conversionEnd = sim::getTime() + ConversionTime;
+
+    if (pointer == Status)
+    {
+        // OSF and the alarm flags can only be cleared, busy is read-only
+        const uint8_t Old = registers[Status];
+        byte = (byte & 0x08) | (Old & byte & 0x83) | (Old & 0x04);
+    }
+
+    registers[pointer] = byte;
+    pointer = (pointer + 1) % NumberOfRegisters;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint8_t Ds3231Model::read()
+{
+    const uint8_t Value = registers[pointer];
+    pointer = (pointer + 1) % NumberOfRegisters;
+    return Value;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Ds3231Model::stop()
+{
+    if (isTimeWritten)
+        takeOverTimeRegisters();
+
+    isTimeWritten = false;
+    isSecondsWritten = false;
+    isDayOfWeekWritten = false;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Ds3231Model::updateTimeRegisters()
+{
+    const auto Time = getTime();
+    const auto Days = Time / SecondsPerDay;
+    const auto SecondOfDay = Time % SecondsPerDay;
+    const auto TheDate = toDate(Days);
+
+    registers[0] = toBcd(SecondOfDay % 60);
+    registers[1] = toBcd(SecondOfDay / 60 % 60);
+    registers[2] = toBcd(SecondOfDay / 3600);
+    registers[4] = toBcd(TheDate.day);
+    registers[5] = toBcd(TheDate.month);
+    registers[6] = toBcd(TheDate.year % 100);
+    registers[DayOfWeek] = static_cast<uint8_t>((Days + dayOfWeekOffset) % 7 + 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+void Ds3231Model::takeOverTimeRegisters()
+{
+    const Date TheDate{2000 + fromBcd(registers[6]), fromBcd(registers[5] & 0x1f), fromBcd(registers[4])};
+    const auto SecondOfDay =
+        fromBcd(registers[2] & 0x3f) * 3600 + fromBcd(registers[1]) * 60 + fromBcd(registers[0] & 0x7f);
+    const auto Days = toDays(TheDate);
+    const auto Time = Days * SecondsPerDay + SecondOfDay;
+
+    if (isDayOfWeekWritten)
+        dayOfWeekOffset = ((registers[DayOfWeek] - 1 - Days) % 7 + 7) % 7;
+
+    // only writing the seconds resets the countdown chain of the oscillator
+    const auto Elapsed = sim::getTime() - referenceTime;
+    if (isSecondsWritten)
+        setTime(Time);
+    else
+    {
+        referenceSeconds = Time - static_cast<int64_t>(Elapsed / 1000);
+        lastMatchedSecond = getTime() - 1;
+        updateTimeRegisters();
+    }
+
+    registers[Status] &= ~0x80;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Ds3231Model::matchAlarms()
+{
+    const auto Now = getTime();
+    for (auto second = lastMatchedSecond + 1; second <= Now; second++)
+    {
+        if (isAlarmMatching(Alarm1Seconds, true, second))
+            registers[Status] |= Alarm1Flag;
+
+        if (isAlarmMatching(Alarm2Minutes, false, second))
+            registers[Status] |= Alarm2Flag;
+    }
+    lastMatchedSecond = Now;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// A field matches if its mask bit is set. The masks of the datasheet always cover the lower fields,
+/// so comparing field by field gives the same rates. Alarm 2 has no seconds, it matches at 00.
+bool Ds3231Model::isAlarmMatching(uint8_t firstRegister, bool hasSeconds, int64_t time) const
+{
+    auto isMatching = [](uint8_t field, uint8_t valueMask, int64_t value)
+    { return (field & AlarmMask) != 0 || fromBcd(field & valueMask) == value; };
+
+    const auto SecondOfDay = time % SecondsPerDay;
+    const auto *alarm = &registers[firstRegister];
+
+    if (hasSeconds ? !isMatching(*alarm++, 0x7f, SecondOfDay % 60) : SecondOfDay % 60 != 0)
+        return false;
+
+    if (!isMatching(alarm[0], 0x7f, SecondOfDay / 60 % 60) || !isMatching(alarm[1], 0x3f, SecondOfDay / 3600))
+        return false;
+
+    const uint8_t DayOrDate = alarm[2];
+    if ((DayOrDate & AlarmMask) != 0)
+        return true;
+
+    const auto Days = time / SecondsPerDay;
+    if ((DayOrDate & DayOfWeekSelect) != 0)
+        return (DayOrDate & 0x07) == (Days + dayOfWeekOffset) % 7 + 1;
+
+    return fromBcd(DayOrDate & 0x3f) == toDate(Days).day;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Ds3231Model::updateConversion()
+{
+    const auto Now = sim::getTime();
+    const auto AutomaticStart = Now - Now % AutomaticConversionPeriod;
+    const bool IsForced = (registers[Control] & ConvertTemperature) != 0;
+
+    // CONV stays set until the forced conversion has finished
+    uint64_t endedConversion = AutomaticStart + ConversionTime <= Now ? AutomaticStart + ConversionTime : 0;
+    if (IsForced && conversionEnd <= Now)
+    {
+        registers[Control] &= ~ConvertTemperature;
+        endedConversion = std::max(endedConversion, conversionEnd);
+    }
+
+    const bool IsBusy = (IsForced && conversionEnd > Now) || Now < AutomaticStart + ConversionTime;
+    registers[Status] = IsBusy ? (registers[Status] | Busy) : (registers[Status] & ~Busy);
+
+    if (endedConversion > lastConversionEnd)
+    {
+        lastConversionEnd = endedConversion;
+        registers[MsbTemperature] = static_cast<uint8_t>(temperature >> 2);
+        registers[LsbTemperature] = static_cast<uint8_t>((temperature & 0x03) << 6);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "hal/FakeHal.hpp"
+
+#include <array>
+#include <cstdint>
+
+/// Register model of the DS3231. The time registers are derived from the virtual time at each start
+/// condition, like the DS3231 copies its counters into the user buffer. Writing the seconds resets
+/// the sub-second phase.
+/// The alarm flags are set for every second which matched the alarm registers since the last access.
+/// Temperature conversions take 125 ms, they are started by CONV and every 64 seconds. BSY is set
+/// while one is running, the temperature registers are updated at its end. The 12 hour mode, the
+/// aging offset and the outputs are not modeled.
+class Ds3231Model : public sim::hal::I2cDevice
+{
+public:
+    static constexpr uint8_t Address = 0x68;
+    static constexpr size_t NumberOfRegisters = 0x13;
+
+    Ds3231Model();
+
+    /// @param secondsSince2000 local time, 2000-01-01 00:00:00 is zero
+    void setTime(int64_t secondsSince2000);
+    int64_t getTime() const;
+
+    /// @return the virtual time in milliseconds at which the clock reaches the given time
+    uint64_t getVirtualTime(int64_t secondsSince2000) const;
+
+    /// presets the alarm registers like the firmware writes them, before the simulation starts
+    void setAlarm1(int hour, int minute);
+    void setAlarm2(int hour, int minute);
+
+    /// taken over by the next temperature conversion, in steps of 0.25 °C
+    void setTemperature(float celsius);
+
+    uint8_t getRegister(uint8_t address) const
+    {
+        return registers[address];
+    }
+
+    bool start(bool isRead) override;
+    bool write(uint8_t byte) override;
+    uint8_t read() override;
+    void stop() override;
+
+private:
+    std::array<uint8_t, NumberOfRegisters> registers{};
+    uint8_t pointer = 0;
+    bool isFirstWrittenByte = false;
+    bool isSecondsWritten = false;
+    bool isTimeWritten = false;
+    bool isDayOfWeekWritten = false;
+
+    // the time counters at the reference point of the virtual time
+    int64_t referenceSeconds = 0;
+    uint64_t referenceTime = 0;
+
+    // the day of week is a free running counter, which is incremented at midnight
+    int64_t dayOfWeekOffset = 0;
+
+    // the last second which has been compared with the alarms
+    int64_t lastMatchedSecond = -1;
+
+    int16_t temperature = 25 * 4; // quarter degrees
+    uint64_t conversionEnd = 0;
+    uint64_t lastConversionEnd = 0;
+
+    void updateTimeRegisters();
+    void takeOverTimeRegisters();
+    void matchAlarms();
+    bool isAlarmMatching(uint8_t firstRegister, bool hasSeconds, int64_t time) const;
+    void updateConversion();
+};
@@ -0,0 +1,672 @@
+#include "FakeHal.hpp"
+#include "adc.h"
+#include "i2c.h"
+#include "tim.h"
+#include "usart.h"
+
+#include "FreeRTOS.h"
+#include "port/VirtualTime.hpp"
+#include "settings/InternalFlash.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+uint32_t SystemCoreClock = 80'000'000;
+uint32_t simResetFlags = 0;
+uint32_t simPowerFlags = 0;
+
+DWT_Type simDwt{};
+CoreDebug_Type simCoreDebug{};
+
+GPIO_TypeDef simGpioA{}, simGpioB{}, simGpioC{}, simGpioH{};
+DMA_Channel_TypeDef simDma1Channel4{}, simDma2Channel7{};
+TIM_TypeDef simTim1{}, simTim2{}, simTim15{};
+USART_TypeDef simUsart1{};
+
+TIM_HandleTypeDef htim1{};
+TIM_HandleTypeDef htim2{};
+TIM_HandleTypeDef htim15{};
+I2C_HandleTypeDef hi2c1{};
+UART_HandleTypeDef huart1{};
+ADC_HandleTypeDef hadc1{};
+
+// symbols of the linker script on the target, erased flash reads as 0xff
+asm(R"(
+    .pushsection .data
+    .balign 2048
+    .globl _settings_start
+_settings_start:
+    .fill 8192, 1, 0xff
+    .globl _settings_end
+_settings_end:
+    .popsection
+)");
+
+extern "C" void PVD_PVM_IRQHandler(void);
+extern "C" void DMA1_Channel4_IRQHandler(void);
+extern "C" void USART1_IRQHandler(void);
+extern "C" void DMA2_Channel7_IRQHandler(void);
+
+namespace
+{
+std::set<IRQn_Type> enabledInterrupts;
+
+struct DmaChannel
+{
+    IRQn_Type interrupt;
+    DMA_HandleTypeDef *handle = nullptr;
+    uint32_t transferNumber = 0; // completions of aborted transfers are dropped
+    uint32_t length = 0;
+    bool isHalfTransferFlagged = false;
+    bool isTransferCompleteFlagged = false;
+};
+
+std::map<DMA_Channel_TypeDef *, DmaChannel> dmaChannels{
+    {DMA1_Channel4, {DMA1_Channel4_IRQn}},
+    {DMA2_Channel7, {DMA2_Channel7_IRQn}},
+};
+
+constexpr uint32_t DmaChannelEnable = 1;
+
+struct I2cBus
+{
+    std::map<uint8_t, sim::hal::I2cDevice *> devices;
+
+    // device of the last frame, if it has ended without stop condition
+    sim::hal::I2cDevice *openDevice = nullptr;
+    bool isOpenForRead = false;
+
+    struct InjectedFault
+    {
+        sim::hal::I2cFault fault;
+        uint32_t remainingFrames;
+    };
+    std::map<uint8_t, InjectedFault> injectedFaults;
+    uint64_t heldUntil = 0;
+
+    sim::hal::I2cStatistics statistics;
+};
+
+I2cBus i2cBus;
+
+std::string serialOutput;
+
+bool isFlashLocked = true;
+
+//--------------------------------------------------------------------------------------------------
+void raiseInterrupt(IRQn_Type interrupt)
+{
+    configASSERT(sim::isInInterrupt());
+    if (!enabledInterrupts.contains(interrupt))
+        return;
+
+    switch (interrupt)
+    {
+    case PVD_PVM_IRQn:
+        PVD_PVM_IRQHandler();
+        break;
+    case DMA1_Channel4_IRQn:
+        DMA1_Channel4_IRQHandler();
+        break;
+    case USART1_IRQn:
+        USART1_IRQHandler();
+        break;
+    case DMA2_Channel7_IRQn:
+        DMA2_Channel7_IRQHandler();
+        break;
+    default:
+        std::fprintf(stderr, "interrupt %d is not simulated\n", interrupt);
+        std::abort();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// the firmware passes addresses as 32 bit values, so the simulation is linked without PIE
+template <typename T>
+T *toPointer(uint32_t address)
+{
+    return reinterpret_cast<T *>(static_cast<uintptr_t>(address));
+}
+
+//--------------------------------------------------------------------------------------------------
+DmaChannel &getDmaChannel(DMA_Channel_TypeDef *instance)
+{
+    const auto It = dmaChannels.find(instance);
+    configASSERT(It != dmaChannels.end());
+    return It->second;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t getElementSize(uint32_t memoryDataAlignment)
+{
+    return memoryDataAlignment == DMA_MDATAALIGN_WORD       ? 4
+           : memoryDataAlignment == DMA_MDATAALIGN_HALFWORD ? 2
+                                                            : 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t readElement(const DMA_HandleTypeDef &dma, uint32_t index)
+{
+    const auto ElementSize = getElementSize(dma.Init.MemDataAlignment);
+    uint32_t value = 0;
+    std::memcpy(&value, toPointer<uint8_t>(dma.Instance->CMAR) + index * ElementSize, ElementSize);
+    return value;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// @return microseconds until all requests of the peripheral have been served
+uint64_t getTransferTime(const DMA_HandleTypeDef &dma, uint32_t length)
+{
+    constexpr uint64_t MicrosecondsPerSecond = 1'000'000;
+
+    // UART with 8N1
+    return length * 10 * MicrosecondsPerSecond / huart1.Init.BaudRate;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// the UART is the only peripheral written by DMA
+void writeToPeripheral(const DMA_HandleTypeDef &dma, uint32_t length)
+{
+    configASSERT(toPointer<volatile uint16_t>(dma.Instance->CPAR) == &USART1->TDR);
+
+    for (uint32_t i = 0; i < length; i++)
+        serialOutput.push_back(static_cast<char>(readElement(dma, i)));
+}
+
+//--------------------------------------------------------------------------------------------------
+void completeTransfer(DMA_Channel_TypeDef *instance, uint32_t transferNumber)
+{
+    auto &channel = getDmaChannel(instance);
+    if (channel.transferNumber != transferNumber || (instance->CCR & DmaChannelEnable) == 0)
+        return;
+
+    writeToPeripheral(*channel.handle, channel.length);
+    instance->CNDTR = 0;
+    channel.isTransferCompleteFlagged = true;
+    raiseInterrupt(channel.interrupt);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// @return DMA channel which is reading the register of a peripheral
+DmaChannel *findReadingDmaChannel(const volatile void *peripheralRegister)
+{
+    for (auto &[Instance, Channel] : dmaChannels)
+    {
+        if (Channel.handle != nullptr && (Instance->CCR & DmaChannelEnable) != 0 &&
+            Channel.handle->Init.Direction == DMA_PERIPH_TO_MEMORY &&
+            toPointer<volatile void>(Instance->CPAR) == peripheralRegister)
+            return &Channel;
+    }
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+HAL_StatusTypeDef startI2cTransfer(I2C_HandleTypeDef *hi2c, uint16_t devAddress, uint8_t *data, uint16_t size,
+                                   bool isRead, bool generatesStop)
+{
+    auto &bus = i2cBus;
+    bus.statistics.transfers++;
+
+    // the busy flag of the bus is checked before the start condition
+    if (sim::getTime() < bus.heldUntil)
+    {
+        bus.statistics.timeouts++;
+        return HAL_BUSY;
+    }
+
+    const auto Address = static_cast<uint8_t>(devAddress >> 1);
+    const auto It = bus.devices.find(Address);
+    auto *device = It != bus.devices.end() ? It->second : nullptr;
+
+    std::optional<sim::hal::I2cFault> fault;
+    if (auto faultIt = bus.injectedFaults.find(Address); faultIt != bus.injectedFaults.end())
+    {
+        fault = faultIt->second.fault;
+        if (--faultIt->second.remainingFrames == 0)
+            bus.injectedFaults.erase(faultIt);
+    }
+
+    // a repeated start to another device ends the transfer of the previous one
+    if (bus.openDevice != nullptr && (bus.openDevice != device || fault))
+    {
+        bus.openDevice->stop();
+        bus.openDevice = nullptr;
+    }
+
+    if (fault == sim::hal::I2cFault::Timeout)
+    {
+        bus.statistics.timeouts++;
+        return HAL_OK;
+    }
+
+    bool isAcknowledged = device != nullptr && !fault;
+    if (isAcknowledged && (bus.openDevice == nullptr || bus.isOpenForRead != isRead))
+        isAcknowledged = device->start(isRead);
+
+    for (uint16_t i = 0; i < size && isAcknowledged; i++)
+    {
+        if (isRead)
+            data[i] = device->read();
+        else
+            isAcknowledged = device->write(data[i]);
+
+        bus.statistics.bytes++;
+    }
+
+    if (!isAcknowledged || generatesStop)
+    {
+        if (device != nullptr && !fault)
+            device->stop();
+        bus.openDevice = nullptr;
+    }
+    else
+    {
+        bus.openDevice = device;
+        bus.isOpenForRead = isRead;
+    }
+
+    hi2c->ErrorCode = isAcknowledged ? HAL_I2C_ERROR_NONE : HAL_I2C_ERROR_AF;
+    if (!isAcknowledged)
+        bus.statistics.errors++;
+
+    // some bytes at 400 kHz take less than a tick
+    const auto Callback = !isAcknowledged ? hi2c->ErrorCallback
+                          : isRead        ? hi2c->MasterRxCpltCallback
+                                          : hi2c->MasterTxCpltCallback;
+    sim::scheduleInterrupt(sim::getTime() + 1,
+                           [hi2c, Callback]
+                           {
+                               if (Callback != nullptr)
+                                   Callback(hi2c);
+                           });
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint8_t *toSettingsFlash(uint32_t address, size_t size)
+{
+    // only the lower 32 bits of the address are known to the firmware
+    const uint32_t Offset = address - static_cast<uint32_t>(reinterpret_cast<uintptr_t>(_settings_start));
+    configASSERT(Offset + size <= static_cast<size_t>(_settings_end - _settings_start));
+    return _settings_start + Offset;
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+namespace sim::hal
+{
+void initialize()
+{
+    // 1 MHz with 250 µs period for the display multiplexing
+    htim1.Instance = TIM1;
+    htim1.Init.Prescaler = 79;
+    htim1.Init.Period = 249;
+
+    // 1024 PWM steps for the LEDs
+    htim2.Instance = TIM2;
+    htim2.Init.Period = 1023;
+    htim15.Instance = TIM15;
+    htim15.Init.Period = 1023;
+
+    for (auto *handle : {&htim1, &htim2, &htim15})
+    {
+        handle->Instance->PSC = handle->Init.Prescaler;
+        handle->Instance->ARR = handle->Init.Period;
+    }
+
+    huart1.Instance = USART1;
+    huart1.Init.BaudRate = 115200;
+
+    // all buttons have pull-ups and are released
+    for (auto *port : {GPIOA, GPIOB, GPIOC, GPIOH})
+        port->IDR = 0xffff;
+
+    configASSERT(reinterpret_cast<uintptr_t>(&serialOutput) <= UINT32_MAX);
+}
+
+//--------------------------------------------------------------------------------------------------
+void attachI2cDevice(uint8_t address, I2cDevice &device)
+{
+    i2cBus.devices[address] = &device;
+}
+
+//--------------------------------------------------------------------------------------------------
+const I2cStatistics &getI2cStatistics()
+{
+    return i2cBus.statistics;
+}
+
+//--------------------------------------------------------------------------------------------------
+void injectI2cFault(uint8_t address, I2cFault fault, uint32_t numberOfFrames)
+{
+    if (numberOfFrames > 0)
+        i2cBus.injectedFaults[address] = {fault, numberOfFrames};
+}
+
+//--------------------------------------------------------------------------------------------------
+void holdI2cBus(uint32_t duration)
+{
+    i2cBus.heldUntil = sim::getTime() + duration;
+}
+
+//--------------------------------------------------------------------------------------------------
+void setInputPin(GPIO_TypeDef *port, uint16_t pin, bool isHigh)
+{
+    port->IDR = isHigh ? (port->IDR | pin) : (port->IDR & ~pin);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool getOutputPin(GPIO_TypeDef *port, uint16_t pin)
+{
+    return (port->ODR & pin) != 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+void receiveSerial(std::span<const uint8_t> data)
+{
+    auto *channel = findReadingDmaChannel(&USART1->RDR);
+    if (channel == nullptr)
+        return;
+
+    auto *instance = channel->handle->Instance;
+    for (const auto Byte : data)
+    {
+        const uint32_t Position = channel->length - instance->CNDTR;
+        toPointer<uint8_t>(instance->CMAR)[Position] = Byte;
+        instance->CNDTR = instance->CNDTR - 1;
+
+        if (Position + 1 == channel->length / 2)
+        {
+            channel->isHalfTransferFlagged = true;
+            raiseInterrupt(channel->interrupt);
+        }
+
+        if (instance->CNDTR == 0)
+        {
+            instance->CNDTR = channel->length;
+            channel->isTransferCompleteFlagged = true;
+            raiseInterrupt(channel->interrupt);
+        }
+    }
+
+    if ((USART1->CR1 & USART_CR1_IDLEIE) != 0)
+    {
+        USART1->ISR = USART_ISR_IDLE;
+        raiseInterrupt(USART1_IRQn);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+std::string takeSerialOutput()
+{
+    return std::exchange(serialOutput, {});
+}
+} // namespace sim::hal
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void Error_Handler(void)
+{
+    std::fputs("Error_Handler called\n", stderr);
+    std::abort();
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    enabledInterrupts.insert(IRQn);
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    enabledInterrupts.erase(IRQn);
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_PWR_ConfigPVD(PWR_PVDTypeDef *sConfigPVD)
+{
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void HAL_PWR_EnablePVD(void)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    isFlashLocked = false;
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    isFlashLocked = true;
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    auto *destination = toSettingsFlash(Address, sizeof(Data));
+
+    // a double word can be programmed only once after erasing
+    const bool IsErased =
+        std::all_of(destination, destination + sizeof(Data), [](uint8_t byte) { return byte == 0xff; });
+    if (isFlashLocked || !IsErased)
+        return HAL_ERROR;
+
+    std::memcpy(destination, &Data, sizeof(Data));
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+    if (isFlashLocked)
+        return HAL_ERROR;
+
+    const uint32_t Address = FLASH_BASE + pEraseInit->Page * FLASH_PAGE_SIZE;
+    const uint32_t Size = pEraseInit->NbPages * FLASH_PAGE_SIZE;
+    std::memset(toSettingsFlash(Address, Size), 0xff, Size);
+
+    *PageError = 0xffff'ffff;
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) != 0 ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    GPIOx->ODR = PinState == GPIO_PIN_SET ? (GPIOx->ODR | GPIO_Pin) : (GPIOx->ODR & ~GPIO_Pin);
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR = GPIOx->ODR ^ GPIO_Pin;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma)
+{
+    getDmaChannel(hdma->Instance).handle = hdma;
+    hdma->Instance->CCR = 0;
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress,
+                                              uint32_t DataLength)
+{
+    auto *instance = hdma->Instance;
+    auto &channel = getDmaChannel(instance);
+    if ((instance->CCR & DmaChannelEnable) != 0)
+        return HAL_BUSY;
+
+    const bool IsReading = hdma->Init.Direction == DMA_PERIPH_TO_MEMORY;
+    channel.handle = hdma;
+    channel.length = DataLength;
+    channel.transferNumber++;
+
+    instance->CPAR = IsReading ? SrcAddress : DstAddress;
+    instance->CMAR = IsReading ? DstAddress : SrcAddress;
+    instance->CNDTR = DataLength;
+    instance->CCR = DmaChannelEnable;
+
+    // reception is driven by receiveSerial()
+    if (IsReading)
+        return HAL_OK;
+
+    const auto Milliseconds = (getTransferTime(*hdma, DataLength) + 999) / 1000;
+    sim::scheduleInterrupt(sim::getTime() + std::max<uint64_t>(Milliseconds, 1),
+                           [instance, Number = channel.transferNumber] { completeTransfer(instance, Number); });
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+    auto &channel = getDmaChannel(hdma->Instance);
+    channel.transferNumber++;
+    channel.isHalfTransferFlagged = false;
+    channel.isTransferCompleteFlagged = false;
+    hdma->Instance->CCR = 0;
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma)
+{
+    auto &channel = getDmaChannel(hdma->Instance);
+
+    if (channel.isHalfTransferFlagged)
+    {
+        channel.isHalfTransferFlagged = false;
+        if (hdma->XferHalfCpltCallback != nullptr)
+            hdma->XferHalfCpltCallback(hdma);
+    }
+
+    if (channel.isTransferCompleteFlagged)
+    {
+        channel.isTransferCompleteFlagged = false;
+        if (hdma->Init.Mode == DMA_NORMAL)
+            hdma->Instance->CCR = 0;
+
+        if (hdma->XferCpltCallback != nullptr)
+            hdma->XferCpltCallback(hdma);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+    SET_BIT(htim->Instance->DIER, TIM_DIER_UIE);
+    SET_BIT(htim->Instance->CR1, TIM_CR1_CEN);
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim)
+{
+    CLEAR_BIT(htim->Instance->DIER, TIM_DIER_UIE);
+    CLEAR_BIT(htim->Instance->CR1, TIM_CR1_CEN);
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    SET_BIT(htim->Instance->DIER, TIM_DIER_CC1IE << (Channel >> 2));
+    SET_BIT(htim->Instance->CCER, 1UL << Channel);
+    SET_BIT(htim->Instance->CR1, TIM_CR1_CEN);
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_TIM_OC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    CLEAR_BIT(htim->Instance->DIER, TIM_DIER_CC1IE << (Channel >> 2));
+    CLEAR_BIT(htim->Instance->CCER, 1UL << Channel);
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    SET_BIT(htim->Instance->CCER, 1UL << Channel);
+    SET_BIT(htim->Instance->CR1, TIM_CR1_CEN);
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+    CLEAR_BIT(htim->Instance->CCER, 1UL << Channel);
+    return HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_I2C_RegisterCallback(I2C_HandleTypeDef *hi2c, HAL_I2C_CallbackIDTypeDef CallbackID,
+                                                      pI2C_CallbackTypeDef pCallback)
+{
+    switch (CallbackID)
+    {
+    case HAL_I2C_MASTER_TX_COMPLETE_CB_ID:
+        hi2c->MasterTxCpltCallback = pCallback;
+        return HAL_OK;
+    case HAL_I2C_MASTER_RX_COMPLETE_CB_ID:
+        hi2c->MasterRxCpltCallback = pCallback;
+        return HAL_OK;
+    case HAL_I2C_ERROR_CB_ID:
+        hi2c->ErrorCallback = pCallback;
+        return HAL_OK;
+    }
+    return HAL_ERROR;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                        uint16_t Size)
+{
+    return startI2cTransfer(hi2c, DevAddress, pData, Size, false, true);
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                       uint16_t Size)
+{
+    return startI2cTransfer(hi2c, DevAddress, pData, Size, true, true);
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                                            uint8_t *pData, uint16_t Size, uint32_t XferOptions)
+{
+    return startI2cTransfer(hi2c, DevAddress, pData, Size, false, XferOptions == I2C_LAST_FRAME);
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" HAL_StatusTypeDef HAL_I2C_Master_Seq_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress,
+                                                           uint8_t *pData, uint16_t Size, uint32_t XferOptions)
+{
+    return startI2cTransfer(hi2c, DevAddress, pData, Size, true, XferOptions == I2C_LAST_FRAME);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "main.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+/// Behavior of the fake peripherals, as seen by the simulator. The firmware uses them through the
+/// HAL functions and registers of stm32l4xx_hal.h.
+///
+/// Completions are signaled by interrupts at the end of their transfer time, at least one tick later:
+/// - I2C transfers are executed byte by byte against the attached devices.
+/// - DMA transfers to the UART are collected as serial output.
+/// Periodic timer interrupts, like the display multiplexing, are not simulated. They would cost more
+/// than everything else while the time jumps over all idle ticks.
+namespace sim::hal
+{
+/// a slave on the I2C bus, addressed by 7 bits
+class I2cDevice
+{
+public:
+    virtual ~I2cDevice() = default;
+
+    /// start or repeated start condition with the address of this device
+    /// @return false if the address is not acknowledged
+    virtual bool start(bool isRead)
+    {
+        return true;
+    }
+
+    /// @return false if the byte is not acknowledged
+    virtual bool write(uint8_t byte) = 0;
+
+    virtual uint8_t read() = 0;
+
+    virtual void stop()
+    {
+    }
+};
+
+struct I2cStatistics
+{
+    uint32_t transfers = 0; // frames started by the firmware
+    uint32_t bytes = 0;
+    uint32_t errors = 0;
+    uint32_t timeouts = 0; // frames without completion
+};
+
+enum class I2cFault
+{
+    Nack,    // the address is not acknowledged
+    Timeout, // the frame never completes, like after a lost interrupt
+};
+
+/// sets up the peripherals like the generated initialization of CubeMX
+void initialize();
+
+/// addresses without a device are not acknowledged
+void attachI2cDevice(uint8_t address, I2cDevice &device);
+
+const I2cStatistics &getI2cStatistics();
+
+/// the next frames to the address fail, a frame is a single HAL_I2C_* call
+void injectI2cFault(uint8_t address, I2cFault fault, uint32_t numberOfFrames = 1);
+
+/// a slave holds SDA low for the duration in milliseconds, so the bus is busy for all frames
+void holdI2cBus(uint32_t duration);
+
+void setInputPin(GPIO_TypeDef *port, uint16_t pin, bool isHigh);
+bool getOutputPin(GPIO_TypeDef *port, uint16_t pin);
+
+/// bytes arrive at the UART within the current tick, followed by an idle line
+void receiveSerial(std::span<const uint8_t> data);
+
+/// bytes which were sent by the firmware since the last call
+std::string takeSerialOutput();
+} // namespace sim::hal
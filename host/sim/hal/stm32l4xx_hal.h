@@ -0,0 +1,487 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Stand-in for the STM32L4 HAL and CMSIS device header in the host simulation. It declares the
+ * subset which is used by the firmware, with the same names and register layouts. The peripherals
+ * are plain structs in RAM, their behavior is modelled by FakeHal.cxx. Included by main.h. */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define __IO volatile
+#define __I volatile const
+
+#define SET_BIT(REG, BIT) ((REG) = (REG) | (BIT))
+#define CLEAR_BIT(REG, BIT) ((REG) = (REG) & ~(BIT))
+#define READ_BIT(REG, BIT) ((REG) & (BIT))
+#define WRITE_REG(REG, VAL) ((REG) = (VAL))
+#define READ_REG(REG) ((REG))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) WRITE_REG((REG), (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK)))
+
+    typedef enum
+    {
+        RESET = 0,
+        SET = !RESET
+    } FlagStatus,
+        ITStatus;
+
+    typedef enum
+    {
+        DISABLE = 0,
+        ENABLE = !DISABLE
+    } FunctionalState;
+
+    typedef enum
+    {
+        HAL_OK = 0x00,
+        HAL_ERROR = 0x01,
+        HAL_BUSY = 0x02,
+        HAL_TIMEOUT = 0x03
+    } HAL_StatusTypeDef;
+
+    extern uint32_t SystemCoreClock;
+
+    void Error_Handler(void);
+
+    //----------------------------------------------------------------------------------------------
+    // core
+
+    typedef enum
+    {
+        PVD_PVM_IRQn = 1,
+        DMA1_Channel4_IRQn = 14,
+        TIM1_BRK_TIM15_IRQn = 24,
+        TIM1_UP_TIM16_IRQn = 25,
+        TIM1_CC_IRQn = 27,
+        I2C1_EV_IRQn = 31,
+        I2C1_ER_IRQn = 32,
+        USART1_IRQn = 37,
+        DMA2_Channel7_IRQn = 69,
+    } IRQn_Type;
+
+    void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+    void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+    void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+
+    typedef struct
+    {
+        __IO uint32_t CTRL;
+        __IO uint32_t CYCCNT;
+    } DWT_Type;
+
+    typedef struct
+    {
+        __IO uint32_t DHCSR;
+        __IO uint32_t DCRSR;
+        __IO uint32_t DCRDR;
+        __IO uint32_t DEMCR;
+    } CoreDebug_Type;
+
+    extern DWT_Type simDwt;
+    extern CoreDebug_Type simCoreDebug;
+#define DWT (&simDwt)
+#define CoreDebug (&simCoreDebug)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+    // there is only one task running at a time, see port/port.cxx
+    static inline void __disable_irq(void)
+    {
+    }
+
+    static inline void __enable_irq(void)
+    {
+    }
+
+    static inline uint32_t __get_PRIMASK(void)
+    {
+        return 0;
+    }
+
+    static inline void __set_PRIMASK(uint32_t priMask)
+    {
+        (void)priMask;
+    }
+
+    static inline uint32_t __get_MSP(void)
+    {
+        return 0;
+    }
+
+    //----------------------------------------------------------------------------------------------
+    // RCC, PWR and flash
+
+#define __HAL_RCC_DMA1_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_DMA2_CLK_ENABLE() ((void)0)
+
+#define RCC_FLAG_BORRST 1U
+    extern uint32_t simResetFlags;
+#define __HAL_RCC_GET_FLAG(__FLAG__) ((simResetFlags & (1U << (__FLAG__))) != 0)
+#define __HAL_RCC_CLEAR_RESET_FLAGS() (simResetFlags = 0)
+
+    typedef struct
+    {
+        uint32_t PVDLevel;
+        uint32_t Mode;
+    } PWR_PVDTypeDef;
+
+#define PWR_PVDLEVEL_6 0x0000000CU
+#define PWR_PVD_MODE_IT_RISING_FALLING 0x00010003U
+#define PWR_FLAG_PVDO 1U
+    extern uint32_t simPowerFlags;
+#define __HAL_PWR_GET_FLAG(__FLAG__) ((simPowerFlags & (__FLAG__)) != 0)
+#define __HAL_PWR_PVD_EXTI_CLEAR_FLAG() ((void)0)
+
+    HAL_StatusTypeDef HAL_PWR_ConfigPVD(PWR_PVDTypeDef *sConfigPVD);
+    void HAL_PWR_EnablePVD(void);
+
+    // the settings area of the fake flash starts at FLASH_BASE, see FakeHal.cxx
+#define FLASH_BASE 0x08000000UL
+#define FLASH_PAGE_SIZE 0x800U
+#define FLASH_BANK_1 0x01U
+#define FLASH_TYPEERASE_PAGES 0x00U
+#define FLASH_TYPEPROGRAM_DOUBLEWORD 0x00U
+#define FLASH_FLAG_ALL_ERRORS 0xC3FAU
+#define __HAL_FLASH_CLEAR_FLAG(__FLAG__) ((void)(__FLAG__))
+
+    typedef struct
+    {
+        uint32_t TypeErase;
+        uint32_t Banks;
+        uint32_t Page;
+        uint32_t NbPages;
+    } FLASH_EraseInitTypeDef;
+
+    HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+    HAL_StatusTypeDef HAL_FLASH_Lock(void);
+    HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+    HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+
+    //----------------------------------------------------------------------------------------------
+    // GPIO
+
+    typedef struct
+    {
+        __IO uint32_t MODER;
+        __IO uint32_t OTYPER;
+        __IO uint32_t OSPEEDR;
+        __IO uint32_t PUPDR;
+        __IO uint32_t IDR;
+        __IO uint32_t ODR;
+        __IO uint32_t BSRR;
+        __IO uint32_t LCKR;
+        __IO uint32_t AFR[2];
+        __IO uint32_t BRR;
+    } GPIO_TypeDef;
+
+    extern GPIO_TypeDef simGpioA, simGpioB, simGpioC, simGpioH;
+#define GPIOA (&simGpioA)
+#define GPIOB (&simGpioB)
+#define GPIOC (&simGpioC)
+#define GPIOH (&simGpioH)
+
+#define GPIO_PIN_0 ((uint16_t)0x0001)
+#define GPIO_PIN_1 ((uint16_t)0x0002)
+#define GPIO_PIN_2 ((uint16_t)0x0004)
+#define GPIO_PIN_3 ((uint16_t)0x0008)
+#define GPIO_PIN_4 ((uint16_t)0x0010)
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_7 ((uint16_t)0x0080)
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+#define GPIO_PIN_All ((uint16_t)0xFFFF)
+
+    typedef enum
+    {
+        GPIO_PIN_RESET = 0U,
+        GPIO_PIN_SET
+    } GPIO_PinState;
+
+    GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+    void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+    void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+    //----------------------------------------------------------------------------------------------
+    // DMA
+
+    typedef struct
+    {
+        __IO uint32_t CCR;
+        __IO uint32_t CNDTR;
+        __IO uint32_t CPAR;
+        __IO uint32_t CMAR;
+    } DMA_Channel_TypeDef;
+
+    extern DMA_Channel_TypeDef simDma1Channel4, simDma2Channel7;
+#define DMA1_Channel4 (&simDma1Channel4)
+#define DMA2_Channel7 (&simDma2Channel7)
+
+#define DMA_REQUEST_2 2U
+
+#define DMA_PERIPH_TO_MEMORY 0x00000000U
+#define DMA_MEMORY_TO_PERIPH 0x00000010U
+#define DMA_PINC_ENABLE 0x00000040U
+#define DMA_PINC_DISABLE 0x00000000U
+#define DMA_MINC_ENABLE 0x00000080U
+#define DMA_MINC_DISABLE 0x00000000U
+#define DMA_PDATAALIGN_BYTE 0x00000000U
+#define DMA_PDATAALIGN_HALFWORD 0x00000100U
+#define DMA_MDATAALIGN_BYTE 0x00000000U
+#define DMA_MDATAALIGN_HALFWORD 0x00000400U
+#define DMA_MDATAALIGN_WORD 0x00000800U
+#define DMA_NORMAL 0x00000000U
+#define DMA_CIRCULAR 0x00000020U
+#define DMA_PRIORITY_LOW 0x00000000U
+#define DMA_PRIORITY_MEDIUM 0x00001000U
+#define DMA_PRIORITY_HIGH 0x00002000U
+
+    typedef struct
+    {
+        uint32_t Request;
+        uint32_t Direction;
+        uint32_t PeriphInc;
+        uint32_t MemInc;
+        uint32_t PeriphDataAlignment;
+        uint32_t MemDataAlignment;
+        uint32_t Mode;
+        uint32_t Priority;
+    } DMA_InitTypeDef;
+
+    typedef struct __DMA_HandleTypeDef
+    {
+        DMA_Channel_TypeDef *Instance;
+        DMA_InitTypeDef Init;
+        void *Parent;
+        void (*XferCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+        void (*XferHalfCpltCallback)(struct __DMA_HandleTypeDef *hdma);
+        void (*XferErrorCallback)(struct __DMA_HandleTypeDef *hdma);
+        void (*XferAbortCallback)(struct __DMA_HandleTypeDef *hdma);
+        __IO uint32_t ErrorCode;
+    } DMA_HandleTypeDef;
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Instance->CNDTR)
+
+    HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+    HAL_StatusTypeDef HAL_DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress,
+                                       uint32_t DataLength);
+    HAL_StatusTypeDef HAL_DMA_Abort(DMA_HandleTypeDef *hdma);
+    void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+    //----------------------------------------------------------------------------------------------
+    // timers
+
+    typedef struct
+    {
+        __IO uint32_t CR1;
+        __IO uint32_t CR2;
+        __IO uint32_t SMCR;
+        __IO uint32_t DIER;
+        __IO uint32_t SR;
+        __IO uint32_t EGR;
+        __IO uint32_t CCMR1;
+        __IO uint32_t CCMR2;
+        __IO uint32_t CCER;
+        __IO uint32_t CNT;
+        __IO uint32_t PSC;
+        __IO uint32_t ARR;
+        __IO uint32_t RCR;
+        __IO uint32_t CCR1;
+        __IO uint32_t CCR2;
+        __IO uint32_t CCR3;
+        __IO uint32_t CCR4;
+        __IO uint32_t BDTR;
+        __IO uint32_t DCR;
+        __IO uint32_t DMAR;
+        __IO uint32_t OR1;
+        __IO uint32_t CCMR3;
+        __IO uint32_t CCR5;
+        __IO uint32_t CCR6;
+        __IO uint32_t OR2;
+        __IO uint32_t OR3;
+    } TIM_TypeDef;
+
+    extern TIM_TypeDef simTim1, simTim2, simTim15;
+#define TIM1 (&simTim1)
+#define TIM2 (&simTim2)
+#define TIM15 (&simTim15)
+
+#define TIM_CHANNEL_1 0x00000000U
+#define TIM_CHANNEL_2 0x00000004U
+#define TIM_CHANNEL_3 0x00000008U
+#define TIM_CHANNEL_4 0x0000000CU
+
+#define TIM_CR1_CEN (1UL << 0)
+#define TIM_SR_UIF (1UL << 0)
+#define TIM_SR_CC1IF (1UL << 1)
+#define TIM_DIER_UIE (1UL << 0)
+#define TIM_DIER_CC1IE (1UL << 1)
+
+#define TIM_IT_UPDATE TIM_DIER_UIE
+#define TIM_IT_CC1 TIM_DIER_CC1IE
+#define TIM_FLAG_UPDATE TIM_SR_UIF
+#define TIM_FLAG_CC1 TIM_SR_CC1IF
+
+    typedef struct
+    {
+        uint32_t Prescaler;
+        uint32_t CounterMode;
+        uint32_t Period;
+        uint32_t ClockDivision;
+        uint32_t RepetitionCounter;
+        uint32_t AutoReloadPreload;
+    } TIM_Base_InitTypeDef;
+
+    typedef struct
+    {
+        TIM_TypeDef *Instance;
+        TIM_Base_InitTypeDef Init;
+    } TIM_HandleTypeDef;
+
+#define __HAL_TIM_ENABLE_IT(__HANDLE__, __INTERRUPT__) SET_BIT((__HANDLE__)->Instance->DIER, (__INTERRUPT__))
+#define __HAL_TIM_DISABLE_IT(__HANDLE__, __INTERRUPT__) CLEAR_BIT((__HANDLE__)->Instance->DIER, (__INTERRUPT__))
+#define __HAL_TIM_GET_FLAG(__HANDLE__, __FLAG__)                                                                       \
+    ((((__HANDLE__)->Instance->SR & (__FLAG__)) == (__FLAG__)) ? SET : RESET)
+#define __HAL_TIM_CLEAR_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->SR = ~(uint32_t)(__INTERRUPT__))
+#define __HAL_TIM_GET_IT_SOURCE(__HANDLE__, __INTERRUPT__)                                                            \
+    ((((__HANDLE__)->Instance->DIER & (__INTERRUPT__)) == (__INTERRUPT__)) ? SET : RESET)
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__)                                                    \
+    ((&(__HANDLE__)->Instance->CCR1)[(__CHANNEL__) >> 2U] = (__COMPARE__))
+#define __HAL_TIM_SetCompare __HAL_TIM_SET_COMPARE
+#define __HAL_TIM_GET_COMPARE(__HANDLE__, __CHANNEL__) ((&(__HANDLE__)->Instance->CCR1)[(__CHANNEL__) >> 2U])
+#define __HAL_TIM_GET_AUTORELOAD(__HANDLE__) ((__HANDLE__)->Instance->ARR)
+#define __HAL_TIM_SET_AUTORELOAD(__HANDLE__, __AUTORELOAD__) ((__HANDLE__)->Instance->ARR = (__AUTORELOAD__))
+#define __HAL_TIM_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Instance->CNT)
+#define __HAL_TIM_SET_COUNTER(__HANDLE__, __COUNTER__) ((__HANDLE__)->Instance->CNT = (__COUNTER__))
+
+    HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+    HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef *htim);
+    HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+    HAL_StatusTypeDef HAL_TIM_OC_Stop_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+    HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+    HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t Channel);
+
+    //----------------------------------------------------------------------------------------------
+    // I2C
+
+    typedef struct
+    {
+        uint32_t Timing;
+        uint32_t OwnAddress1;
+        uint32_t AddressingMode;
+    } I2C_InitTypeDef;
+
+    typedef struct __I2C_HandleTypeDef
+    {
+        void *Instance;
+        I2C_InitTypeDef Init;
+        __IO uint32_t ErrorCode;
+        void (*MasterTxCpltCallback)(struct __I2C_HandleTypeDef *hi2c);
+        void (*MasterRxCpltCallback)(struct __I2C_HandleTypeDef *hi2c);
+        void (*ErrorCallback)(struct __I2C_HandleTypeDef *hi2c);
+    } I2C_HandleTypeDef;
+
+    typedef enum
+    {
+        HAL_I2C_MASTER_TX_COMPLETE_CB_ID = 0x00U,
+        HAL_I2C_MASTER_RX_COMPLETE_CB_ID = 0x01U,
+        HAL_I2C_ERROR_CB_ID = 0x07U,
+    } HAL_I2C_CallbackIDTypeDef;
+
+    typedef void (*pI2C_CallbackTypeDef)(I2C_HandleTypeDef *hi2c);
+
+    // a frame without stop condition is continued by the next one
+#define I2C_FIRST_FRAME 0x00000000U
+#define I2C_FIRST_AND_NEXT_FRAME 0x01000000U
+#define I2C_NEXT_FRAME 0x01000000U
+#define I2C_FIRST_AND_LAST_FRAME 0x02000000U
+#define I2C_LAST_FRAME 0x02000000U
+
+#define HAL_I2C_ERROR_NONE 0x00000000U
+#define HAL_I2C_ERROR_AF 0x00000004U
+
+    HAL_StatusTypeDef HAL_I2C_RegisterCallback(I2C_HandleTypeDef *hi2c, HAL_I2C_CallbackIDTypeDef CallbackID,
+                                               pI2C_CallbackTypeDef pCallback);
+    HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                 uint16_t Size);
+    HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                uint16_t Size);
+    HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                     uint16_t Size, uint32_t XferOptions);
+    HAL_StatusTypeDef HAL_I2C_Master_Seq_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+                                                    uint16_t Size, uint32_t XferOptions);
+
+    //----------------------------------------------------------------------------------------------
+    // USART
+
+    typedef struct
+    {
+        __IO uint32_t CR1;
+        __IO uint32_t CR2;
+        __IO uint32_t CR3;
+        __IO uint32_t BRR;
+        __IO uint16_t GTPR;
+        uint16_t RESERVED2;
+        __IO uint32_t RTOR;
+        __IO uint16_t RQR;
+        uint16_t RESERVED3;
+        __IO uint32_t ISR;
+        __IO uint32_t ICR;
+        __IO uint16_t RDR;
+        uint16_t RESERVED4;
+        __IO uint16_t TDR;
+        uint16_t RESERVED5;
+    } USART_TypeDef;
+
+    extern USART_TypeDef simUsart1;
+#define USART1 (&simUsart1)
+
+#define USART_CR1_IDLEIE (1UL << 4)
+#define USART_CR3_EIE (1UL << 0)
+#define USART_CR3_DMAR (1UL << 6)
+#define USART_CR3_DMAT (1UL << 7)
+#define USART_ISR_FE (1UL << 1)
+#define USART_ISR_NE (1UL << 2)
+#define USART_ISR_ORE (1UL << 3)
+#define USART_ISR_IDLE (1UL << 4)
+#define USART_ICR_FECF (1UL << 1)
+#define USART_ICR_NECF (1UL << 2)
+#define USART_ICR_ORECF (1UL << 3)
+#define USART_ICR_IDLECF (1UL << 4)
+
+    typedef struct
+    {
+        uint32_t BaudRate;
+        uint32_t WordLength;
+        uint32_t StopBits;
+        uint32_t Parity;
+        uint32_t Mode;
+    } UART_InitTypeDef;
+
+    typedef struct
+    {
+        USART_TypeDef *Instance;
+        UART_InitTypeDef Init;
+    } UART_HandleTypeDef;
+
+    //----------------------------------------------------------------------------------------------
+    // ADC
+
+    typedef struct
+    {
+        void *Instance;
+    } ADC_HandleTypeDef;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,164 @@
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "Simulator.hpp"
+#include "devices/Ds3231Model.hpp"
+#include "hal/FakeHal.hpp"
+#include "rtc/Calendar.hpp"
+#include "settings/InternalFlash.hpp"
+#include "settings/Settings.hpp"
+#include "settings/SettingsStore.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <utility>
+
+// stands in for cubemx/Core/Src/main.c and freertos.c
+extern "C" void StartDefaultTask(void *argument);
+
+namespace
+{
+constexpr auto DefaultTaskStackSize = 256;
+constexpr auto DefaultTaskPriority = 13; // osPriorityLow5
+
+Ds3231Model rtcModel;
+
+void printUsage()
+{
+    std::fputs("usage: alarm-clock-sim [--days <number>] [--date YYYY-MM-DD] [--start HH:MM:SS] [--alarm1 HH:MM]\n"
+               "                       [--alarm2 HH:MM] [--local-rtc] [<scenario>]\n"
+               "The simulation starts at 2000-01-01 UTC by default, see Simulator.hpp for the format of the scenario.\n"
+               "A scenario ends after its last step, otherwise the simulation runs one day.\n"
+               "--local-rtc starts like the first time after older firmware, which has kept local time in the RTC.\n",
+               stderr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// the firmware has run before, so the RTC keeps UTC and is not converted at the start
+void markRtcAsUtc()
+{
+    InternalFlash flash;
+    SettingsStore store{flash};
+
+    store.mount();
+    store.set(static_cast<uint8_t>(SettingsKey::RtcKeepsUtc), 1);
+    store.flush();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool parseAlarm(const char *text, int &hour, int &minute)
+{
+    return std::sscanf(text, "%d:%d", &hour, &minute) == 2 && hour >= 0 && hour < 24 && minute >= 0 && minute < 60;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int days = 0;
+    int64_t startDay = 0;
+    int64_t startTime = 0;
+    bool isRtcLocal = false;
+    const char *scenarioPath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string_view Argument{argv[i]};
+        const bool HasValue = i + 1 < argc;
+
+        if (Argument == "--days" && HasValue)
+            days = std::atoi(argv[++i]);
+
+        else if (Argument == "--start" && HasValue)
+        {
+            int hour = 0;
+            int minute = 0;
+            int second = 0;
+            if (std::sscanf(argv[++i], "%d:%d:%d", &hour, &minute, &second) < 2)
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            startTime = hour * 3600 + minute * 60 + second;
+        }
+        else if (Argument == "--date" && HasValue)
+        {
+            int year = 0;
+            int month = 0;
+            int day = 0;
+            const auto IsParsed = std::sscanf(argv[++i], "%d-%d-%d", &year, &month, &day) == 3;
+            const Date StartDate{static_cast<uint8_t>(day), static_cast<uint8_t>(month),
+                                 static_cast<uint16_t>(year), 0};
+
+            if (!IsParsed || day != StartDate.day || month != StartDate.month || !calendar::isValid(StartDate))
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+            startDay = calendar::toDayNumber(StartDate);
+        }
+        else if ((Argument == "--alarm1" || Argument == "--alarm2") && HasValue)
+        {
+            int hour = 0;
+            int minute = 0;
+            if (!parseAlarm(argv[++i], hour, minute))
+            {
+                printUsage();
+                return EXIT_FAILURE;
+            }
+
+            if (Argument == "--alarm1")
+                rtcModel.setAlarm1(hour, minute);
+            else
+                rtcModel.setAlarm2(hour, minute);
+        }
+        else if (Argument == "--local-rtc")
+            isRtcLocal = true;
+
+        else if (Argument.starts_with("-") || scenarioPath != nullptr)
+        {
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        else
+            scenarioPath = argv[i];
+    }
+
+    startTime += startDay * calendar::SecondsPerDay;
+    sim::hal::initialize();
+
+    if (!isRtcLocal)
+        markRtcAsUtc();
+
+    // the EEPROM of the RTC module is missing, so the settings are stored in the internal flash
+    rtcModel.setTime(startTime);
+    sim::hal::attachI2cDevice(Ds3231Model::Address, rtcModel);
+
+    static Simulator simulator{rtcModel, startTime};
+    if (scenarioPath != nullptr)
+    {
+        auto *file = std::fopen(scenarioPath, "r");
+        if (file == nullptr)
+        {
+            std::perror(scenarioPath);
+            return EXIT_FAILURE;
+        }
+
+        auto scenario = simulator.parseScenario(file);
+        std::fclose(file);
+        if (!scenario)
+            return EXIT_FAILURE;
+
+        simulator.run(std::move(*scenario));
+    }
+    else if (days == 0)
+        days = 1;
+
+    if (days > 0)
+        simulator.scheduleEnd(static_cast<uint64_t>(days) * 24 * 60 * 60 * 1000);
+
+    xTaskCreate(StartDefaultTask, "defaultTask", DefaultTaskStackSize, nullptr, DefaultTaskPriority, nullptr);
+    vTaskStartScheduler();
+
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <cstdint>
+#include <functional>
+
+/// Time of the simulation, which is advanced by the idle task only. As long as any task is ready,
+/// no time passes, so the firmware appears to run on an infinitely fast CPU. If all tasks are
+/// blocked, the time jumps to the next tick where a task unblocks or an interrupt is due.
+namespace sim
+{
+/// milliseconds since the start of the scheduler, one per tick
+uint64_t getTime();
+
+/// Runs the handler in interrupt context when the time has reached the given millisecond.
+/// Handlers of the same time are called in the order they were scheduled.
+void scheduleInterrupt(uint64_t time, std::function<void()> handler);
+
+bool isInInterrupt();
+
+/// number of times the task was switched in
+uint32_t getWakeups(TaskHandle_t task);
+} // namespace sim
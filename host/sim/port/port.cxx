@@ -0,0 +1,288 @@
+// longjmp is checked to stay on the same stack if fortified, but it switches between the task stacks
+#undef _FORTIFY_SOURCE
+
+#include "VirtualTime.hpp"
+
+#include <csetjmp>
+#include <ucontext.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace
+{
+// the firmware is compiled for the host, so its stack usage is unrelated to the target
+constexpr size_t HostStackSize = 256 * 1024;
+
+/// Execution context of a task. All tasks run as coroutines on the thread of main(), so the
+/// simulation is deterministic and a context switch needs no synchronization.
+/// A task is entered once by its ucontext, afterwards _setjmp/_longjmp switch without a system call.
+struct Context
+{
+    TaskFunction_t function;
+    void *parameter;
+    ucontext_t entry{};
+    std::jmp_buf registers{};
+    std::unique_ptr<char[]> stack;
+    bool isStarted = false;
+    uint32_t wakeups = 0;
+};
+
+std::jmp_buf schedulerRegisters{};
+Context *runningContext = nullptr;
+
+// a context switch is delayed until the end of a critical section or interrupt, like PendSV
+UBaseType_t criticalNesting = 0;
+bool isYieldPending = false;
+bool isInInterruptContext = false;
+
+uint64_t currentTime = 0;
+
+// the multimap keeps the insertion order of equal times
+std::multimap<uint64_t, std::function<void()>> pendingInterrupts;
+
+Context *getContext(TaskHandle_t task)
+{
+    // pxTopOfStack is the first member of the TCB, the context is stored where it points to
+    const auto *TopOfStack = *reinterpret_cast<StackType_t *volatile *>(task);
+    return reinterpret_cast<Context *>(*TopOfStack);
+}
+
+//--------------------------------------------------------------------------------------------------
+void runTask()
+{
+    runningContext->function(runningContext->parameter);
+
+    std::fputs("a task has returned from its function\n", stderr);
+    std::abort();
+}
+
+//--------------------------------------------------------------------------------------------------
+[[noreturn]] void resume(Context &context)
+{
+    if (context.isStarted)
+        _longjmp(context.registers, 1);
+
+    context.isStarted = true;
+    setcontext(&context.entry);
+    std::abort();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// called by the running task, returns after the scheduler has selected it again
+void switchContext()
+{
+    isYieldPending = false;
+
+    auto *previous = runningContext;
+    vTaskSwitchContext();
+    auto *next = getContext(xTaskGetCurrentTaskHandle());
+
+    if (next == previous)
+        return;
+
+    next->wakeups++;
+    runningContext = next;
+    if (_setjmp(previous->registers) == 0)
+        resume(*next);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool canSwitchContext()
+{
+    return criticalNesting == 0 && !isInInterruptContext && runningContext != nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// the SysTick of the simulation, including all peripheral interrupts which are due at the new time
+void processTick()
+{
+    currentTime++;
+    isInInterruptContext = true;
+
+    while (!pendingInterrupts.empty() && pendingInterrupts.begin()->first <= currentTime)
+    {
+        auto handler = std::move(pendingInterrupts.begin()->second);
+        pendingInterrupts.erase(pendingInterrupts.begin());
+        handler();
+    }
+
+    if (xTaskIncrementTick() != pdFALSE)
+        isYieldPending = true;
+
+    isInInterruptContext = false;
+
+    if (isYieldPending)
+        switchContext();
+}
+} // namespace
+
+//--------------------------------------------------------------------------------------------------
+namespace sim
+{
+uint64_t getTime()
+{
+    return currentTime;
+}
+
+//--------------------------------------------------------------------------------------------------
+void scheduleInterrupt(uint64_t time, std::function<void()> handler)
+{
+    pendingInterrupts.emplace(time, std::move(handler));
+}
+
+//--------------------------------------------------------------------------------------------------
+bool isInInterrupt()
+{
+    return isInInterruptContext;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t getWakeups(TaskHandle_t task)
+{
+    return getContext(task)->wakeups;
+}
+} // namespace sim
+
+//--------------------------------------------------------------------------------------------------
+extern "C" StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    auto *context = new Context{pxCode, pvParameters};
+    context->stack = std::make_unique<char[]>(HostStackSize);
+
+    getcontext(&context->entry);
+    context->entry.uc_stack.ss_sp = context->stack.get();
+    context->entry.uc_stack.ss_size = HostStackSize;
+    context->entry.uc_link = nullptr;
+    makecontext(&context->entry, &runTask, 0);
+
+    *pxTopOfStack = reinterpret_cast<StackType_t>(context);
+    return pxTopOfStack;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" BaseType_t xPortStartScheduler(void)
+{
+    runningContext = getContext(xTaskGetCurrentTaskHandle());
+    runningContext->wakeups++;
+    if (_setjmp(schedulerRegisters) == 0)
+        resume(*runningContext);
+
+    // the simulation is ended by exiting the process
+    return pdFALSE;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void vPortEndScheduler(void)
+{
+    configASSERT(false);
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void vPortYield(void)
+{
+    isYieldPending = true;
+    if (canSwitchContext())
+        switchContext();
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void vPortYieldFromIsr(BaseType_t higherPriorityTaskWoken)
+{
+    if (higherPriorityTaskWoken != pdFALSE)
+        vPortYield();
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void vPortEnterCritical(void)
+{
+    criticalNesting++;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void vPortExitCritical(void)
+{
+    configASSERT(criticalNesting > 0);
+    criticalNesting--;
+
+    if (isYieldPending && canSwitchContext())
+        switchContext();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Jumps over all ticks without any event. The last tick is processed normally by the idle hook,
+/// so the unblocked task or the interrupt handler runs at exactly the same time as on the target.
+extern "C" void vPortSuppressTicksAndSleep(TickType_t expectedIdleTime)
+{
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep)
+        return;
+
+    uint64_t ticksToJump = expectedIdleTime - 1;
+    if (!pendingInterrupts.empty())
+    {
+        const auto NextInterrupt = pendingInterrupts.begin()->first;
+        ticksToJump = NextInterrupt > currentTime ? std::min(ticksToJump, NextInterrupt - currentTime - 1) : 0;
+    }
+
+    if (ticksToJump == 0)
+        return;
+
+    vTaskStepTick(static_cast<TickType_t>(ticksToJump));
+    currentTime += ticksToJump;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void vApplicationIdleHook(void)
+{
+    // nothing else is ready, so time passes
+    processTick();
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" uint32_t getSimulationRunTimeCounter(void)
+{
+    // microseconds, but the time does not pass while tasks are running
+    return static_cast<uint32_t>(currentTime * 1000);
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void simulationAssertFailed(const char *file, int line)
+{
+    std::fprintf(stderr, "assertion failed at %s:%d after %llu ms\n", file, line,
+                 static_cast<unsigned long long>(currentTime));
+    std::abort();
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void vApplicationMallocFailedHook(void)
+{
+    configASSERT(false);
+}
+
+//--------------------------------------------------------------------------------------------------
+// provided by cmsis_os2.c on the target
+
+extern "C" void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *stackSize)
+{
+    static StaticTask_t idleTcb;
+    static StackType_t idleStack[configMINIMAL_STACK_SIZE];
+
+    *tcb = &idleTcb;
+    *stack = idleStack;
+    *stackSize = configMINIMAL_STACK_SIZE;
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *stackSize)
+{
+    static StaticTask_t timerTcb;
+    static StackType_t timerStack[configTIMER_TASK_STACK_DEPTH];
+
+    *tcb = &timerTcb;
+    *stack = timerStack;
+    *stackSize = configTIMER_TASK_STACK_DEPTH;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* FreeRTOS port of the host simulation. Every task is a coroutine on the same thread, so there is
+ * no real concurrency. Interrupts are simulated in the context of the idle task, see port.cxx */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+#define portSTACK_TYPE uintptr_t
+#define portBASE_TYPE long
+#define portPOINTER_SIZE_TYPE size_t
+
+    typedef portSTACK_TYPE StackType_t;
+    typedef long BaseType_t;
+    typedef unsigned long UBaseType_t;
+
+    typedef uint32_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC 1
+
+#define portSTACK_GROWTH (-1)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portBYTE_ALIGNMENT 16
+
+    void vPortYield(void);
+    void vPortYieldFromIsr(BaseType_t higherPriorityTaskWoken);
+    void vPortEnterCritical(void);
+    void vPortExitCritical(void);
+    void vPortSuppressTicksAndSleep(TickType_t expectedIdleTime);
+
+#define portYIELD() vPortYield()
+#define portEND_SWITCHING_ISR(xSwitchRequired) vPortYieldFromIsr(xSwitchRequired)
+#define portYIELD_FROM_ISR(x) portEND_SWITCHING_ISR(x)
+
+/* only one task runs at a time, so the interrupt masks have nothing to protect */
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portSET_INTERRUPT_MASK_FROM_ISR() 0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) (void)(x)
+#define portENTER_CRITICAL() vPortEnterCritical()
+#define portEXIT_CRITICAL() vPortExitCritical()
+
+#define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) vPortSuppressTicksAndSleep(xExpectedIdleTime)
+
+#define portTASK_FUNCTION_PROTO(vFunction, pvParameters) void vFunction(void *pvParameters)
+#define portTASK_FUNCTION(vFunction, pvParameters) void vFunction(void *pvParameters)
+
+#define portNOP()
+#define portMEMORY_BARRIER() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,285 @@
+#include "link/LinkEndpoint.hpp"
+#include "timesync/ClockDiscipline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <optional>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+namespace
+{
+int64_t getSystemTime()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+int64_t getSteadyTime()
+{
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/// UTC offset of the host in minutes
+int16_t getUtcOffset()
+{
+    const auto Now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&Now, &local);
+    return static_cast<int16_t>(local.tm_gmtoff / 60);
+}
+
+/// answers the time requests of the clock with the system time of the host
+class PtyTimeServer : public esp::LinkTransport, public esp::LinkHandler
+{
+public:
+    explicit PtyTimeServer(int fileDescriptor) : fileDescriptor(fileDescriptor)
+    {
+    }
+
+    void writeFrame(std::span<const uint8_t> frame) override
+    {
+        ::write(fileDescriptor, frame.data(), frame.size());
+    }
+
+    void handleMessage(esp::MessageType type, std::span<const uint8_t> payload) override
+    {
+        if (type != esp::MessageType::TimeRequest)
+            return;
+
+        const auto Request = esp::LinkEndpoint::decodePayload<esp::TimeRequest>(payload);
+        const auto ReceiveTime = static_cast<uint64_t>(getSystemTime());
+
+        const esp::TimeResponse Response{Request.originateTime, ReceiveTime, static_cast<uint64_t>(getSystemTime()),
+                                         getUtcOffset()};
+        if (!link.send(Response, getSteadyTime()))
+            std::puts("previous response is not acknowledged yet, request dropped");
+        else
+            std::printf("request at tick %u answered\n", static_cast<unsigned>(Request.originateTime));
+    }
+
+    void receive(std::span<const uint8_t> data)
+    {
+        for (const auto Byte : data)
+        {
+            if (Byte == 0)
+                link.finishFrame();
+            else
+                link.feed(Byte);
+        }
+    }
+
+    void update()
+    {
+        link.update(getSteadyTime());
+    }
+
+private:
+    static constexpr uint32_t RetransmitTimeout = 100;
+
+    int fileDescriptor;
+    esp::LinkEndpoint link{*this, *this, RetransmitTimeout};
+};
+
+int runPtyServer()
+{
+    const int Master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (Master < 0 || grantpt(Master) != 0 || unlockpt(Master) != 0)
+    {
+        std::perror("pseudo terminal");
+        return EXIT_FAILURE;
+    }
+
+    // the clock takes the slave as its serial port, e.g. "socat /dev/ttyUSB0,b115200,raw <pts>"
+    std::printf("time server is listening on %s\n", ptsname(Master));
+    std::fflush(stdout);
+
+    fcntl(Master, F_SETFL, O_NONBLOCK);
+    PtyTimeServer server{Master};
+
+    while (true)
+    {
+        uint8_t buffer[64];
+        const auto Length = ::read(Master, buffer, sizeof(buffer));
+
+        if (Length > 0)
+            server.receive({buffer, static_cast<size_t>(Length)});
+        else
+            usleep(1000);
+
+        server.update();
+        std::fflush(stdout);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// DS3231 with a frequency error, which is trimmed by the aging offset
+class SimulatedRtc
+{
+public:
+    explicit SimulatedRtc(double frequencyError) : frequencyError(frequencyError)
+    {
+    }
+
+    /// advances the RTC by one millisecond of real time
+    void tick()
+    {
+        time += 1.0 + (frequencyError - agingOffset * timesync::ClockDiscipline::PpmPerAgingStep) * 1e-6;
+    }
+
+    /// the countdown chain restarts with each write of the seconds register
+    void setSeconds(int64_t seconds)
+    {
+        time = seconds * 1000.0;
+    }
+
+    int64_t getSeconds() const
+    {
+        return static_cast<int64_t>(std::floor(time / 1000.0));
+    }
+
+    double getTime() const
+    {
+        return time;
+    }
+
+    int8_t agingOffset = 0;
+
+private:
+    double frequencyError; // ppm
+    double time = 0;       // milliseconds
+};
+
+/// Runs the algorithm of the TimeSyncClient in virtual time, one step equals one millisecond.
+/// The line has random asymmetric delays and the ESP needs some time to answer.
+int runSimulation(double frequencyError, int hours)
+{
+    constexpr int64_t ServerEpoch = 1'700'000'000'000; // network time at tick 0
+    constexpr int16_t UtcOffset = 60;
+    constexpr int SamplesPerSync = 4;
+    constexpr uint32_t MaximumRoundTrip = 250;
+    constexpr uint32_t SyncInterval = 60 * 60 * 1000;
+    constexpr uint32_t EdgeResolution = 1;
+
+    std::mt19937 random{1};
+    std::uniform_int_distribution<uint32_t> lineDelay{2, 40};
+    std::uniform_int_distribution<uint32_t> processingTime{0, 5};
+
+    SimulatedRtc rtc{frequencyError};
+    timesync::ClockDiscipline discipline;
+    uint32_t now = 0;
+
+    auto getServerTime = [&] { return ServerEpoch + now; };
+    auto advance = [&](uint32_t milliseconds)
+    {
+        for (uint32_t i = 0; i < milliseconds; i++)
+        {
+            now++;
+            rtc.tick();
+        }
+    };
+
+    // the RTC starts 7 seconds and a fraction off
+    rtc.setSeconds(timesync::toLocalTimeOfDay(getServerTime(), UtcOffset) / 1000 + 7);
+    advance(rtc.getSeconds() % 3 * 100 + 333);
+
+    std::printf("%5s %9s %6s %5s %s\n", "hour", "error/ms", "rtt/ms", "aging", "action");
+    double worstError = 0;
+
+    for (int hour = 0; hour <= hours; hour++)
+    {
+        std::optional<timesync::Sample> best;
+        uint32_t bestTick = 0;
+
+        for (int i = 0; i < SamplesPerSync; i++)
+        {
+            const uint32_t Originate = now;
+            advance(lineDelay(random));
+            const int64_t Receive = getServerTime();
+            advance(processingTime(random));
+            const int64_t Transmit = getServerTime();
+            advance(lineDelay(random));
+
+            const auto Sample = timesync::calculateSample(Originate, Receive, Transmit, now);
+            if (!best || Sample.roundTrip < best->roundTrip)
+            {
+                best = Sample;
+                bestTick = now;
+            }
+        }
+
+        if (best->roundTrip > MaximumRoundTrip)
+            return EXIT_FAILURE;
+
+        auto getEstimatedServerTime = [&](uint32_t tick)
+        { return bestTick + best->offset + static_cast<int64_t>(tick - bestTick); };
+
+        // the RTC is polled every tick, plus a bit for the I2C transfer
+        const auto StartSecond = rtc.getSeconds();
+        while (rtc.getSeconds() == StartSecond)
+            advance(1);
+
+        const int64_t RtcTime = timesync::wrapToDay(rtc.getSeconds() * 1000);
+        const auto NetworkTime = timesync::toLocalTimeOfDay(getEstimatedServerTime(now), UtcOffset);
+        const auto Error = static_cast<int32_t>(timesync::getDifferenceOfDay(RtcTime, NetworkTime));
+
+        // real error for the report, the client only knows its estimate
+        const auto TrueError = static_cast<double>(timesync::getDifferenceOfDay(
+            std::llround(rtc.getTime()), timesync::toLocalTimeOfDay(getServerTime(), UtcOffset)));
+
+        const uint32_t Uncertainty = best->roundTrip / 2 + EdgeResolution;
+        const auto Decision = discipline.update(Error, Uncertainty, now, rtc.agingOffset);
+        std::string action;
+        if (Decision.newAgingOffset)
+        {
+            action += "aging " + std::to_string(*Decision.newAgingOffset) + " ";
+            rtc.agingOffset = *Decision.newAgingOffset;
+        }
+
+        if (Decision.shouldAlign)
+        {
+            advance(timesync::getTicksToNextSecond(getEstimatedServerTime(now)));
+            rtc.setSeconds((timesync::toLocalTimeOfDay(getEstimatedServerTime(now), UtcOffset) + 500) / 1000);
+            discipline.markAligned(now);
+            action += "aligned";
+        }
+
+        std::printf("%5d %9.1f %6u %5d %s\n", hour, TrueError, static_cast<unsigned>(best->roundTrip),
+                    rtc.agingOffset, action.c_str());
+
+        // accuracy once the aging offset has settled
+        if (hour > hours - 24)
+            worstError = std::max(worstError, std::abs(TrueError));
+
+        advance(SyncInterval - now % SyncInterval);
+    }
+
+    const double Residual = frequencyError - rtc.agingOffset * timesync::ClockDiscipline::PpmPerAgingStep;
+    std::printf("worst error during the last day: %.1f ms, residual frequency error: %.2f ppm\n", worstError,
+                Residual);
+
+    const bool HasConverged = std::abs(Residual) <= timesync::ClockDiscipline::PpmPerAgingStep &&
+                              worstError <= timesync::ClockDiscipline::AlignmentThreshold;
+    std::puts(HasConverged ? "converged" : "FAIL: not converged");
+    return HasConverged ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // namespace
+
+/// Stands in for the ESP and answers TimeRequests with the system time of the host over a pseudo
+/// terminal. With --simulate it runs the sync algorithm against a drifting RTC in virtual time.
+/// usage: time-server [--simulate [frequency error in ppm] [hours]]
+int main(int argc, char **argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--simulate") == 0)
+        return runSimulation(argc > 2 ? std::atof(argv[2]) : 2.3, argc > 3 ? std::atoi(argv[3]) : 400);
+
+    return runPtyServer();
+}
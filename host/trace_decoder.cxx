@@ -0,0 +1,326 @@
+#include "diagnostics/Isr.hpp"
+#include "diagnostics/TraceFormat.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct Trace
+{
+    trace::Header header{};
+    std::vector<trace::Record> records; // oldest first
+    std::map<uint16_t, std::string> taskNames;
+};
+
+/// RAM dump of trace::buffer, written by gdb
+std::optional<Trace> parseBinary(const std::vector<char> &data)
+{
+    Trace result;
+    if (data.size() < sizeof(trace::Header))
+        return {};
+
+    std::memcpy(&result.header, data.data(), sizeof(trace::Header));
+    if (result.header.magic != trace::Magic ||
+        data.size() < sizeof(trace::Header) + result.header.capacity * sizeof(trace::Record))
+        return {};
+
+    const auto &Header = result.header;
+    const uint32_t NumberOfRecords = std::min(Header.writeIndex, Header.capacity);
+    for (uint32_t i = Header.writeIndex - NumberOfRecords; i < Header.writeIndex; i++)
+    {
+        trace::Record record;
+        std::memcpy(&record, data.data() + sizeof(trace::Header) + (i % Header.capacity) * sizeof(trace::Record),
+                    sizeof(trace::Record));
+        result.records.push_back(record);
+    }
+    return result;
+}
+
+/// output of the "trace" shell command, lines which do not belong to it are skipped
+std::optional<Trace> parseText(const std::string &text)
+{
+    Trace result;
+    bool hasHeader = false;
+
+    std::istringstream stream{text};
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        unsigned long first = 0, second = 0, third = 0;
+        char name[32];
+
+        if (std::sscanf(line.c_str(), "trace %lu %lu %lu", &first, &second, &third) == 3)
+        {
+            result = {{trace::Magic, static_cast<uint32_t>(first), static_cast<uint32_t>(second),
+                       static_cast<uint32_t>(third)},
+                      {},
+                      {}};
+            hasHeader = true;
+        }
+        else if (hasHeader && std::sscanf(line.c_str(), "task %lu %31s", &first, name) == 2)
+            result.taskNames[static_cast<uint16_t>(first)] = name;
+
+        else if (hasHeader && line.size() == 2 * sizeof(trace::Record) &&
+                 line.find_first_not_of("0123456789abcdef") == std::string::npos)
+        {
+            uint8_t bytes[sizeof(trace::Record)];
+            for (size_t i = 0; i < sizeof(bytes); i++)
+                bytes[i] = static_cast<uint8_t>(std::stoul(line.substr(2 * i, 2), nullptr, 16));
+
+            trace::Record record;
+            std::memcpy(&record, bytes, sizeof(record));
+            result.records.push_back(record);
+        }
+    }
+
+    if (!hasHeader)
+        return {};
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// min/avg/max of durations in microseconds
+class Statistics
+{
+public:
+    void add(double value)
+    {
+        minimum = count == 0 ? value : std::min(minimum, value);
+        maximum = count == 0 ? value : std::max(maximum, value);
+        sum += value;
+        count++;
+    }
+
+    void print(const std::string &name) const
+    {
+        if (count == 0)
+            std::printf("  %-20s %8s\n", name.c_str(), "-");
+        else
+            std::printf("  %-20s %8zu %10.2f %10.2f %10.2f\n", name.c_str(), count, minimum, sum / count, maximum);
+    }
+
+private:
+    size_t count = 0;
+    double minimum = 0;
+    double maximum = 0;
+    double sum = 0;
+};
+
+void printStatisticsHeader(const char *title)
+{
+    std::printf("\n%-22s %8s %10s %10s %10s\n", title, "count", "min/us", "avg/us", "max/us");
+}
+
+class Decoder
+{
+public:
+    explicit Decoder(const Trace &trace) : trace(trace)
+    {
+    }
+
+    void printTimeline() const
+    {
+        uint64_t time = 0;
+        for (size_t i = 0; i < trace.records.size(); i++)
+        {
+            const auto &Record = trace.records[i];
+            if (i > 0)
+                time += Record.timestamp - trace.records[i - 1].timestamp;
+
+            std::printf("%14.2f us  %-10s %s\n", toMicroseconds(time),
+                        trace::Events[static_cast<size_t>(Record.event)].name, describe(Record).c_str());
+        }
+    }
+
+    void printReport() const
+    {
+        std::map<uint16_t, Statistics> isrDurations;
+        std::map<uint16_t, Statistics> taskSlices;
+        Statistics i2cTransfers;
+        Statistics buttonLatencies;
+        size_t i2cErrors = 0;
+        size_t i2cTimeouts = 0;
+
+        std::map<uint16_t, uint64_t> isrEnterTimes;
+        std::optional<std::pair<uint16_t, uint64_t>> runningTask;
+        std::optional<uint64_t> i2cStartTime;
+        std::optional<uint64_t> buttonTime;
+
+        uint64_t time = 0;
+        for (size_t i = 0; i < trace.records.size(); i++)
+        {
+            const auto &Record = trace.records[i];
+            if (i > 0)
+                time += Record.timestamp - trace.records[i - 1].timestamp;
+
+            switch (Record.event)
+            {
+            case trace::Event::TaskSwitchedIn:
+                if (runningTask)
+                    taskSlices[runningTask->first].add(toMicroseconds(time - runningTask->second));
+                runningTask = {Record.argument, time};
+                break;
+
+            case trace::Event::IsrEnter:
+                isrEnterTimes[Record.argument] = time;
+                break;
+
+            case trace::Event::IsrExit:
+                // the enter of the first handler may have been overwritten
+                if (const auto It = isrEnterTimes.find(Record.argument); It != isrEnterTimes.end())
+                {
+                    isrDurations[Record.argument].add(toMicroseconds(time - It->second));
+                    isrEnterTimes.erase(It);
+                }
+                break;
+
+            case trace::Event::I2cStart:
+                i2cStartTime = time;
+                break;
+
+            case trace::Event::I2cDone:
+                if (i2cStartTime)
+                    i2cTransfers.add(toMicroseconds(time - *i2cStartTime));
+                i2cStartTime.reset();
+
+                if (Record.argument == static_cast<uint16_t>(trace::I2cResult::Error))
+                    i2cErrors++;
+                else if (Record.argument == static_cast<uint16_t>(trace::I2cResult::Timeout))
+                    i2cTimeouts++;
+                break;
+
+            case trace::Event::ButtonAction:
+                buttonTime = time;
+                break;
+
+            case trace::Event::DisplayState:
+                if (buttonTime)
+                    buttonLatencies.add(toMicroseconds(time - *buttonTime));
+                buttonTime.reset();
+                break;
+            }
+        }
+
+        const double TotalTime = toMicroseconds(time);
+        std::printf("\n%zu records over %.2f ms\n", trace.records.size(), TotalTime / 1000);
+
+        printStatisticsHeader("interrupt handlers");
+        for (const auto &[Isr, Durations] : isrDurations)
+            Durations.print(Isr < diagnostics::NumberOfIsrs ? diagnostics::IsrNames[Isr] : std::to_string(Isr));
+
+        printStatisticsHeader("task time slices");
+        for (const auto &[Task, Slices] : taskSlices)
+            Slices.print(getTaskName(Task));
+
+        printStatisticsHeader("i2c transfers");
+        i2cTransfers.print("start to done");
+        std::printf("  %zu errors, %zu timeouts\n", i2cErrors, i2cTimeouts);
+
+        printStatisticsHeader("buttons");
+        buttonLatencies.print("action to display");
+    }
+
+private:
+    const Trace &trace;
+
+    double toMicroseconds(uint64_t cycles) const
+    {
+        return trace.header.clockFrequency == 0 ? 0.0 : cycles * 1e6 / trace.header.clockFrequency;
+    }
+
+    std::string getTaskName(uint16_t taskNumber) const
+    {
+        const auto It = trace.taskNames.find(taskNumber);
+        return It != trace.taskNames.end() ? It->second : "#" + std::to_string(taskNumber);
+    }
+
+    std::string describe(const trace::Record &record) const
+    {
+        const auto Argument = record.argument;
+
+        switch (record.event)
+        {
+        case trace::Event::TaskSwitchedIn:
+            return getTaskName(Argument);
+
+        case trace::Event::IsrEnter:
+        case trace::Event::IsrExit:
+            return Argument < diagnostics::NumberOfIsrs ? diagnostics::IsrNames[Argument] : std::to_string(Argument);
+
+        case trace::Event::I2cStart:
+        {
+            char address[8];
+            std::snprintf(address, sizeof(address), "0x%02x", Argument);
+            return address;
+        }
+
+        case trace::Event::I2cDone:
+        {
+            constexpr const char *Results[] = {"success", "error", "timeout"};
+            return Argument < std::size(Results) ? Results[Argument] : std::to_string(Argument);
+        }
+
+        case trace::Event::ButtonAction:
+        {
+            const size_t Button = Argument >> 8;
+            return (Button < trace::ButtonNames.size() ? trace::ButtonNames[Button] : std::to_string(Button)) +
+                   " action " + std::to_string(Argument & 0xff);
+        }
+
+        case trace::Event::DisplayState:
+            return "state " + std::to_string(Argument);
+        }
+        return {};
+    }
+};
+} // namespace
+
+/// Decodes the event trace of the firmware into a timeline and a latency report.
+/// The input is either a RAM dump of trace::buffer or the output of the "trace" shell command.
+/// usage: trace-decoder [--report] <file>
+int main(int argc, char **argv)
+{
+    const bool ReportOnly = argc > 2 && std::strcmp(argv[1], "--report") == 0;
+    if (argc < 2 || (argc > 2 && !ReportOnly))
+    {
+        std::fprintf(stderr, "usage: %s [--report] <file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file{argv[argc - 1], std::ios::binary};
+    if (!file)
+    {
+        std::perror(argv[argc - 1]);
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<char> Data{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    auto trace = parseBinary(Data);
+    if (!trace)
+        trace = parseText({Data.begin(), Data.end()});
+
+    if (!trace)
+    {
+        std::fputs("neither a trace dump nor the output of the trace command\n", stderr);
+        return EXIT_FAILURE;
+    }
+
+    const Decoder TheDecoder{*trace};
+    if (!ReportOnly)
+        TheDecoder.printTimeline();
+    TheDecoder.printReport();
+    return EXIT_SUCCESS;
+}
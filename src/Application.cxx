@@ -3,14 +3,16 @@
 #include "task.h"
 
 #include "Application.hpp"
+#include "diagnostics/IsrProfiler.hpp"
+#include "diagnostics/MainStack.hpp"
+#include "diagnostics/Trace.hpp"
 #include "wrappers/Task.hpp"
 
-#include <memory>
-
 extern "C" void StartDefaultTask(void *) // NOLINT
 {
-    static auto app = std::make_unique<Application>();
-    app->run();
+    // static storage instead of the heap, so the application is part of the RAM usage of the linker
+    static Application app;
+    app.run();
 
     configASSERT(false); // this line should be never reached
 }
@@ -22,6 +24,9 @@ Application::Application()
     configASSERT(instance == nullptr);
     instance = this;
 
+    trace::initialize();
+    diagnostics::paintMainStack();
+
     registerCallbacks();
 }
 
@@ -65,6 +70,7 @@ void Application::registerCallbacks()
 void Application::multiplexingTimerUpdate()
 {
     getApplicationInstance().display.multiplexingInterrupt();
+    getApplicationInstance().vibrationCushion.pwmTick();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -73,11 +79,18 @@ void Application::pwmTimerCompare()
     getApplicationInstance().display.pwmTimerInterrupt();
 }
 
+//--------------------------------------------------------------------------------------------------
+void Application::ledStripPwmPeriod()
+{
+    getApplicationInstance().ledStrip.pwmPeriodInterrupt();
+}
+
 //--------------------------------------------------------------------------------------------------
 // skip HAL`s interupt routine to get more performance
 
 extern "C" void TIM1_UP_TIM16_IRQHandler(void)
 {
+    diagnostics::IsrProfiler::Scope profilerScope{diagnostics::Isr::Multiplexing};
     __HAL_TIM_CLEAR_IT(Application::MultiplexingPwmTimer, TIM_IT_UPDATE);
     Application::multiplexingTimerUpdate();
 }
@@ -85,6 +98,7 @@ extern "C" void TIM1_UP_TIM16_IRQHandler(void)
 //--------------------------------------------------------------------------------------------------
 extern "C" void TIM1_CC_IRQHandler(void)
 {
+    diagnostics::IsrProfiler::Scope profilerScope{diagnostics::Isr::DisplayPwm};
     if (__HAL_TIM_GET_FLAG(Application::MultiplexingPwmTimer, TIM_FLAG_CC1) == SET)
     {
         if (__HAL_TIM_GET_IT_SOURCE(Application::MultiplexingPwmTimer, TIM_IT_CC1) == SET)
@@ -95,6 +109,68 @@ extern "C" void TIM1_CC_IRQHandler(void)
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+// TIM1 break is unused, so only the update of LED strip timer has to be handled
+extern "C" void TIM1_BRK_TIM15_IRQHandler(void)
+{
+    diagnostics::IsrProfiler::Scope profilerScope{diagnostics::Isr::LedStripPwm};
+    __HAL_TIM_CLEAR_IT(Application::LedStripPwmTimer, TIM_IT_UPDATE);
+    Application::ledStripPwmPeriod();
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::serialUartInterrupt()
+{
+    getApplicationInstance().serialPort.uartInterrupt();
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::serialRxTransfer()
+{
+    getApplicationInstance().serialPort.rxDmaInterrupt();
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::serialTxTransfer()
+{
+    getApplicationInstance().serialPort.txDmaInterrupt();
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void USART1_IRQHandler(void)
+{
+    diagnostics::IsrProfiler::Scope profilerScope{diagnostics::Isr::SerialUart};
+    Application::serialUartInterrupt();
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void DMA2_Channel7_IRQHandler(void)
+{
+    diagnostics::IsrProfiler::Scope profilerScope{diagnostics::Isr::SerialRxDma};
+    Application::serialRxTransfer();
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void DMA1_Channel4_IRQHandler(void)
+{
+    diagnostics::IsrProfiler::Scope profilerScope{diagnostics::Isr::SerialTxDma};
+    Application::serialTxTransfer();
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::supplyVoltageChange()
+{
+    getApplicationInstance().faultIndicator.supplyVoltageInterrupt();
+}
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void PVD_PVM_IRQHandler(void)
+{
+    diagnostics::IsrProfiler::Scope profilerScope{diagnostics::Isr::SupplyVoltage};
+    __HAL_PWR_PVD_EXTI_CLEAR_FLAG();
+    Application::supplyVoltageChange();
+}
+
 //--------------------------------------------------------------------------------------------------
 void Application::statusLedsTimeoutCallback(TimerHandle_t timer)
 {
@@ -105,4 +181,44 @@ void Application::statusLedsTimeoutCallback(TimerHandle_t timer)
 void Application::stateMachineTimeoutCallback(TimerHandle_t timer)
 {
     getApplicationInstance().stateMachine.handleTimeoutTimer();
-}
\ No newline at end of file
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::alarmEngineDeadlineCallback(TimerHandle_t timer)
+{
+    getApplicationInstance().alarmEngine.handleDeadlineTimer();
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::vibrationStepCallback(TimerHandle_t timer)
+{
+    getApplicationInstance().vibrationCushion.handleStepTimer();
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::faultIndicatorCallback(TimerHandle_t timer)
+{
+    getApplicationInstance().faultIndicator.handleTimer();
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::settingsFlushCallback(TimerHandle_t timer)
+{
+    getApplicationInstance().settings.handleFlushTimer();
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::eepromPollDelay()
+{
+    // the timer callbacks share the timer service task, they must not wait for the EEPROM
+    configASSERT(xTaskGetCurrentTaskHandle() != xTimerGetTimerDaemonTaskHandle());
+
+    // the write cycle takes up to 5 ms, other tasks can use the CPU meanwhile
+    vTaskDelay(1);
+}
+
+//--------------------------------------------------------------------------------------------------
+void Application::runTimeStatisticsCallback(TimerHandle_t timer)
+{
+    getApplicationInstance().runTimeStatistics.handleTimer();
+}
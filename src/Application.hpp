@@ -1,11 +1,23 @@
 #pragma once
 
+#include "LED/LedService.hpp"
 #include "LED/LedStrip.hpp"
 #include "LED/StatusLeds.hpp"
+#include "alarm/AlarmEngine.hpp"
 #include "buttons/Buttons.hpp"
+#include "diagnostics/RunTimeStatistics.hpp"
 #include "display/Display.hpp"
+#include "health/FaultIndicator.hpp"
+#include "rtc/AT24C32.hpp"
 #include "rtc/RealTimeClock.hpp"
+#include "serial/SerialPort.hpp"
+#include "serial/SerialService.hpp"
+#include "settings/EepromSettingsStore.hpp"
+#include "settings/InternalFlash.hpp"
+#include "settings/Settings.hpp"
+#include "settings/SettingsStore.hpp"
 #include "state_machine/StateMachine.hpp"
+#include "timesync/TimeSyncClient.hpp"
 
 /// The entry point of users C++ firmware. This comes after CubeHAL and FreeRTOS initialization.
 /// All needed classes and objects have the root here.
@@ -27,6 +39,10 @@ public:
 
     static constexpr auto RtcBus = &hi2c1;
 
+    using Eeprom = AT24C32<I2cAccessor>;
+
+    static constexpr auto SerialUart = &huart1;
+
     Application();
     [[noreturn]] void run();
 
@@ -34,10 +50,24 @@ public:
 
     static void multiplexingTimerUpdate();
     static void pwmTimerCompare();
+    static void ledStripPwmPeriod();
     static void statusLedsTimeoutCallback(TimerHandle_t timer);
     static void stateMachineTimeoutCallback(TimerHandle_t timer);
+    static void alarmEngineDeadlineCallback(TimerHandle_t timer);
+    static void vibrationStepCallback(TimerHandle_t timer);
+    static void faultIndicatorCallback(TimerHandle_t timer);
+    static void supplyVoltageChange();
+    static void settingsFlushCallback(TimerHandle_t timer);
+    static void eepromPollDelay();
+    static void serialUartInterrupt();
+    static void serialRxTransfer();
+    static void serialTxTransfer();
+    static void runTimeStatisticsCallback(TimerHandle_t timer);
 
 private:
+    // reports the state of the firmware, see host/sim
+    friend class Simulator;
+
     static inline Application *instance{nullptr};
 
     void registerCallbacks();
@@ -45,14 +75,43 @@ private:
     DisplayDimming dimming{MultiplexingPwmTimer, PwmTimChannel};
     Display display{dimming};
 
-    StatusLeds statusLeds{StatusLedPwmTimer, LedAlarm1Channel, LedAlarm2Channel,
-                          LedRedChannel,     LedGreenChannel,  statusLedsTimeoutCallback};
-    LedStrip ledStrip{LedStripPwmTimer, WarmWhiteChannel, ColdWhiteChannel};
+    // only stores references, the LEDs are constructed below
+    LedService ledService{statusLeds, ledStrip};
+
+    StatusLeds statusLeds{ledService,    StatusLedPwmTimer, LedAlarm1Channel,         LedAlarm2Channel,
+                          LedRedChannel, LedGreenChannel,   statusLedsTimeoutCallback};
+    LedStrip ledStrip{ledService, LedStripPwmTimer, WarmWhiteChannel, ColdWhiteChannel};
+
+    FaultIndicator faultIndicator{statusLeds, &faultIndicatorCallback};
+    RunTimeStatistics runTimeStatistics{&runTimeStatisticsCallback};
 
     Buttons buttons{};
 
     I2cAccessor i2cBusAccessor{RtcBus};
-    RealTimeClock rtc{i2cBusAccessor};
+    RealTimeClock rtc{i2cBusAccessor, faultIndicator};
+
+    // EEPROM on the RTC module is preferred, internal flash is used on modules without it
+    Eeprom eeprom{i2cBusAccessor, &eepromPollDelay};
+    EepromSettingsStore<Eeprom, at24c32::PageSize> eepromSettingsStore{eeprom};
+    InternalFlash internalFlash{};
+    SettingsStore flashSettingsStore{internalFlash};
+    Settings settings{eepromSettingsStore, flashSettingsStore, &settingsFlushCallback};
+    static_assert(static_cast<size_t>(SettingsKey::FirstVibrationPattern) + MaximumAlarms <=
+                  decltype(eepromSettingsStore)::MaximumKeys);
+
+    VibrationCushion vibrationCushion{&vibrationStepCallback};
+    AlarmEngine alarmEngine{rtc, ledStrip, vibrationCushion, &alarmEngineDeadlineCallback};
+
+    StateMachine stateMachine{display, statusLeds, ledStrip, buttons, rtc, alarmEngine, settings,
+                              &stateMachineTimeoutCallback};
+
+    SerialPort serialPort{SerialUart,
+                          USART1_IRQn,
+                          {DMA2_Channel7, DMA_REQUEST_2, DMA2_Channel7_IRQn},
+                          {DMA1_Channel4, DMA_REQUEST_2, DMA1_Channel4_IRQn}};
+    // only stores a reference, the serial service is constructed below
+    TimeSyncClient timeSyncClient{rtc, serialService};
 
-    StateMachine stateMachine{display, statusLeds, ledStrip, buttons, rtc, &stateMachineTimeoutCallback};
+    SerialService serialService{serialPort, rtc, ledStrip, ledService, alarmEngine, faultIndicator, runTimeStatistics,
+                                timeSyncClient};
 };
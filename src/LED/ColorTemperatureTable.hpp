@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// Mixing table for the warm and cold white LED strip channels.
+/// The eye perceives color temperature differences in mired (1e6 / K) rather than in kelvin,
+/// so the entries are equally spaced in mired. The mired value of the mixed light is the
+/// flux-weighted mean of both channels, which makes the duty cycles linear in the table index.
+/// Both duties always add up to the same total, so the luminous output does not change with CCT.
+namespace cct
+{
+constexpr uint16_t WarmKelvin = 2700;
+constexpr uint16_t ColdKelvin = 6500;
+constexpr uint16_t NeutralKelvin = 4000;
+
+/// 4.5 mired per step, which is below the just noticeable difference of roughly 5 mired
+constexpr size_t Steps = 48;
+constexpr uint16_t TotalOutput = 1024;
+
+struct Mix
+{
+    uint16_t kelvin;
+    uint16_t warmWhite;
+    uint16_t coldWhite;
+};
+
+constexpr float WarmMired = 1e6f / WarmKelvin;
+constexpr float ColdMired = 1e6f / ColdKelvin;
+constexpr float MiredStep = (WarmMired - ColdMired) / Steps;
+
+/// index 0 is the warmest entry
+constexpr std::array<Mix, Steps + 1> Table = []
+{
+    std::array<Mix, Steps + 1> table{};
+    for (size_t i = 0; i <= Steps; i++)
+    {
+        const float Mired = WarmMired - i * MiredStep;
+        table[i].kelvin = static_cast<uint16_t>(1e6f / Mired + 0.5f);
+        table[i].coldWhite = static_cast<uint16_t>((TotalOutput * i + Steps / 2) / Steps);
+        table[i].warmWhite = TotalOutput - table[i].coldWhite;
+    }
+    return table;
+}();
+
+constexpr size_t findIndex(uint16_t kelvin)
+{
+    size_t index = 0;
+    while (index < Steps && Table[index + 1].kelvin <= kelvin)
+        index++;
+
+    return index;
+}
+
+constexpr size_t NeutralIndex = findIndex(NeutralKelvin);
+
+constexpr bool isTableValid()
+{
+    if (Table.front().kelvin != WarmKelvin || Table.back().kelvin != ColdKelvin)
+        return false;
+
+    for (size_t i = 0; i <= Steps; i++)
+    {
+        if (Table[i].warmWhite + Table[i].coldWhite != TotalOutput)
+            return false;
+
+        if (i == 0)
+            continue;
+
+        if (Table[i].kelvin <= Table[i - 1].kelvin || Table[i].warmWhite >= Table[i - 1].warmWhite ||
+            Table[i].coldWhite <= Table[i - 1].coldWhite)
+            return false;
+
+        // equal perceived steps, with some margin for the rounding of the kelvin values
+        const float Step = 1e6f / Table[i - 1].kelvin - 1e6f / Table[i].kelvin;
+        if (Step < 0.95f * MiredStep || Step > 1.05f * MiredStep)
+            return false;
+    }
+    return true;
+}
+
+static_assert(isTableValid(), "CCT table must be monotonic with constant total output and equal mired steps");
+static_assert(Table[NeutralIndex].kelvin <= NeutralKelvin && Table[NeutralIndex + 1].kelvin > NeutralKelvin);
+
+} // namespace cct
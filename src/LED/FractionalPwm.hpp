@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// First order sigma-delta modulator for a single PWM channel.
+/// The requested value has `FractionalBits` more resolution than the timer. The fractional part is
+/// accumulated over consecutive update events and every overflow adds one timer step to the compare
+/// value. The average duty cycle equals the requested value, the ripple is one timer step only.
+template <size_t FractionalBits>
+class FractionalPwm
+{
+public:
+    static constexpr uint32_t FractionMask = (1 << FractionalBits) - 1;
+
+    /// @param value compare value including FractionalBits fractional bits
+    void setValue(uint32_t value)
+    {
+        targetValue = value; // single 32bit store, so it can be read safely by PWM interrupt
+    }
+
+    uint32_t getValue() const
+    {
+        return targetValue;
+    }
+
+    /// has to be called exactly once per update event of the PWM timer
+    /// @return compare value from the next update event on
+    uint32_t nextCompareValue()
+    {
+        const uint32_t Value = targetValue;
+
+        accumulator += Value & FractionMask;
+        const uint32_t Carry = accumulator >> FractionalBits;
+        accumulator &= FractionMask;
+
+        return (Value >> FractionalBits) + Carry;
+    }
+
+private:
+    volatile uint32_t targetValue = 0;
+    uint32_t accumulator = 0;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+/// Receives every change of a LED, so the LED service knows when it has to run.
+class LedActivity
+{
+public:
+    /// a LED has changed and may fade now
+    virtual void notifyChange() = 0;
+
+    /// blinking LEDs keep the LED service running until blinking is stopped
+    /// @param ledBit unique bit of the LED
+    virtual void setBlinking(uint32_t ledBit, bool isBlinking) = 0;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "LedActivity.hpp"
+#include "LedStrip.hpp"
+#include "StatusLeds.hpp"
+
+#include "helpers/freertos.hpp"
+#include "wrappers/Task.hpp"
+
+#include <atomic>
+#include <climits>
+
+/// Single task which updates all PWM LEDs on TIM2 (status LEDs) and TIM15 (LED strip).
+/// It runs at 100Hz only while at least one LED is fading or blinking and sleeps until the next
+/// change otherwise.
+class LedService : public util::wrappers::TaskWithMemberFunctionBase, public LedActivity
+{
+public:
+    LedService(StatusLeds &statusLeds, LedStrip &ledStrip)
+        : TaskWithMemberFunctionBase("ledServiceTask", 256, osPriorityLow2), //
+          statusLeds(statusLeds),                                            //
+          ledStrip(ledStrip)
+    {
+    }
+
+    /// upper bound of a single fade of util's PWM LEDs
+    static constexpr auto FadeSettleTime = 1.0_s;
+    static constexpr auto UpdateRate = 100.0_Hz;
+
+    void notifyChange() override
+    {
+        lastChangeTime = xTaskGetTickCount();
+        notify(1, util::wrappers::NotifyAction::SetBits);
+    }
+
+    void setBlinking(uint32_t ledBit, bool isBlinking) override
+    {
+        isBlinking ? blinkingLeds.fetch_or(ledBit) : blinkingLeds.fetch_and(~ledBit);
+    }
+
+    /// number of update cycles since boot, each of them is one wakeup of this task
+    uint32_t getWakeupCounter() const
+    {
+        return wakeupCounter;
+    }
+
+protected:
+    [[noreturn]] void taskMain(void *) override
+    {
+        statusLeds.initialize();
+        ledStrip.initialize();
+
+        while (true)
+        {
+            auto lastWakeTime = xTaskGetTickCount();
+
+            while (isAnyEffectActive(lastWakeTime))
+            {
+                statusLeds.updateState(lastWakeTime);
+                ledStrip.updateState(lastWakeTime);
+                wakeupCounter++;
+
+                vTaskDelayUntil(&lastWakeTime, toOsTicks(UpdateRate));
+            }
+
+            // all LEDs are static now, sleep until the next change
+            notifyWait(ULONG_MAX, ULONG_MAX, (uint32_t *)0, portMAX_DELAY);
+        }
+    }
+
+private:
+    StatusLeds &statusLeds;
+    LedStrip &ledStrip;
+
+    std::atomic<uint32_t> blinkingLeds{0};
+    volatile TickType_t lastChangeTime = 0;
+    uint32_t wakeupCounter = 0;
+
+    bool isAnyEffectActive(TickType_t now) const
+    {
+        return blinkingLeds != 0 || (now - lastChangeTime) < toOsTicks(FadeSettleTime);
+    }
+};
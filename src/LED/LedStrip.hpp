@@ -1,20 +1,26 @@
 #pragma once
 
+#include "ColorTemperatureTable.hpp"
+#include "FractionalPwm.hpp"
+#include "LedActivity.hpp"
+#include "ObservedLed.hpp"
+#include "SunriseCurve.hpp"
+
+#include "FreeRTOS.h"
 #include "tim.h"
-#include "units/si/temperature.hpp"
-#include "util/MapValue.hpp"
 #include "util/led/PwmLed.hpp"
-#include "wrappers/Task.hpp"
 
 // #include "Fading.hpp"
 
-class LedStrip : public util::wrappers::TaskWithMemberFunctionBase
+/// LEDs are updated by LedService
+class LedStrip
 {
 public:
-    LedStrip(TIM_HandleTypeDef *ledTimerHandle, const uint32_t &warmWhiteChannel, const uint32_t &coldWhiteChannel)
-        : TaskWithMemberFunctionBase("ledstripTask", 256, osPriorityLow2), ledTimerHandle(ledTimerHandle), //
-          warmWhiteChannel(warmWhiteChannel),                                                              //
-          coldWhiteChannel(coldWhiteChannel)                                                               //
+    LedStrip(LedActivity &ledActivity, TIM_HandleTypeDef *ledTimerHandle, const uint32_t &warmWhiteChannel,
+             const uint32_t &coldWhiteChannel)
+        : ledActivity(ledActivity), ledTimerHandle(ledTimerHandle), //
+          warmWhiteChannel(warmWhiteChannel),                       //
+          coldWhiteChannel(coldWhiteChannel)                        //
     {
         configASSERT(this->ledTimerHandle != nullptr);
     }
@@ -39,6 +45,9 @@ public:
         isEnabled = state;
         warmWhiteLedStrip.setState(state);
         coldWhiteLedStrip.setState(state);
+
+        if (isFractionalPwmActive)
+            updateFractionalPwm();
     }
 
     void incrementBrightness()
@@ -57,30 +66,68 @@ public:
         updateBrightness();
     }
 
+    void setGlobalBrightness(uint8_t brightness)
+    {
+        globalBrightness = std::min<uint8_t>(brightness, 100);
+        updateBrightness();
+    }
+
+    void setColorTemperature(uint16_t kelvin)
+    {
+        colorTemperatureIndex = cct::findIndex(kelvin);
+        mapColorTemperatureToStrip();
+    }
+
     void incrementCCT()
     {
-        if (colorTemperature < ColdColorTemperature)
-            colorTemperature += ColorStep;
+        if (colorTemperatureIndex < cct::Steps)
+            colorTemperatureIndex++;
 
         mapColorTemperatureToStrip();
     }
 
     void decrementCCT()
     {
-        if (colorTemperature > WarmColorTemperature)
-            colorTemperature -= ColorStep;
+        if (colorTemperatureIndex > 0)
+            colorTemperatureIndex--;
 
         mapColorTemperatureToStrip();
     }
 
+    static constexpr uint16_t MaximumSunriseLevel = UINT16_MAX;
+
+    /// Below MaximumSunriseLevel the strip is driven by fractional PWM with 16 bit resolution
+    /// along the perceptual sunrise curve. MaximumSunriseLevel hands over to the regular LEDs.
+    void setSunriseLevel(uint16_t level)
+    {
+        if (level == sunriseLevel)
+            return;
+
+        sunriseLevel = level;
+
+        if (sunriseLevel == MaximumSunriseLevel)
+            stopFractionalPwm();
+        else
+            updateFractionalPwm();
+    }
+
+    /// called by PWM timer update interrupt, only enabled while fractional PWM is active
+    void pwmPeriodInterrupt()
+    {
+        // compare registers are preloaded, so the new values apply from the next update event on
+        __HAL_TIM_SET_COMPARE(ledTimerHandle, warmWhiteChannel, warmWhiteFractionalPwm.nextCompareValue());
+        __HAL_TIM_SET_COMPARE(ledTimerHandle, coldWhiteChannel, coldWhiteFractionalPwm.nextCompareValue());
+    }
+
     uint8_t getGlobalBrightness() const
     {
         return globalBrightness;
     }
 
-    units::si::Temperature getColorTemperature() const
+    /// @return color temperature in kelvin
+    uint16_t getColorTemperature() const
     {
-        return colorTemperature;
+        return cct::Table[colorTemperatureIndex].kelvin;
     }
 
     bool isLedStripEnabled() const
@@ -88,78 +135,153 @@ public:
         return isEnabled;
     }
 
-protected:
-    [[noreturn]] void taskMain(void *)
+    void initialize()
     {
-        auto lastWakeTime = xTaskGetTickCount();
+        warmWhiteLedStrip.setBrightness(100);
+        coldWhiteLedStrip.setBrightness(100);
         mapColorTemperatureToStrip();
-        updateBrightness();
+    }
 
-        while (true)
-        {
-            warmWhiteLedStrip.updateState(lastWakeTime);
-            coldWhiteLedStrip.updateState(lastWakeTime);
-            vTaskDelayUntil(&lastWakeTime, toOsTicks(100.0_Hz));
-        }
+    void updateState(TickType_t lastWakeTime)
+    {
+        // compare registers are owned by PWM interrupt during sunrise
+        if (isFractionalPwmActive)
+            return;
+
+        warmWhiteLedStrip.updateState(lastWakeTime);
+        coldWhiteLedStrip.updateState(lastWakeTime);
     }
 
 private:
+    LedActivity &ledActivity;
     TIM_HandleTypeDef *ledTimerHandle = nullptr;
     const uint32_t &warmWhiteChannel;
     const uint32_t &coldWhiteChannel;
 
-    static constexpr auto WarmColorTemperature = 2700.0_K;
-    static constexpr auto ColdColorTemperature = 6500.0_K;
-    static constexpr auto NeutralColorTemperature = 4000.0_K;
-    static constexpr auto ColorStep = 100.0_K;
-    units::si::Temperature colorTemperature{NeutralColorTemperature};
+    size_t colorTemperatureIndex = cct::NeutralIndex;
     size_t warmWhiteBrightness = 0;
     size_t coldWhiteBrightness = 0;
 
     bool isEnabled = false;
     uint8_t globalBrightness = 50;
+    uint16_t sunriseLevel = MaximumSunriseLevel;
 
-    // APB1 for timers: 80MHz -> 1024 PWM steps and clock divison by 4 -> 19.5kHz PWM frequency
+    // APB1 for timers: 80MHz -> 1024 PWM steps -> 78kHz PWM frequency
+    // (the clock division by 4 applies to dead time and input filters only, not to the counter)
     static constexpr size_t PwmSteps = 1024;
     static constexpr auto ResolutionBits = std::bit_width<size_t>(PwmSteps - 1);
     using GammaCorrection_t = util::led::pwm::GammaCorrection<ResolutionBits, 10.0f>;
     static constexpr GammaCorrection_t GammaCorrection{};
 
-    using SingleLed = util::led::pwm::SingleLed<ResolutionBits, GammaCorrection_t>;
+    static_assert(cct::TotalOutput == PwmSteps);
 
-    SingleLed warmWhiteLedStrip{util::PwmOutput<ResolutionBits>{ledTimerHandle, warmWhiteChannel}, GammaCorrection};
-    SingleLed coldWhiteLedStrip{util::PwmOutput<ResolutionBits>{ledTimerHandle, coldWhiteChannel}, GammaCorrection};
+    using SingleLed = ObservedLed<util::led::pwm::SingleLed<ResolutionBits, GammaCorrection_t>>;
 
-    void mapColorTemperatureToStrip()
+    static constexpr uint32_t WarmWhiteBit = 1 << 3;
+    static constexpr uint32_t ColdWhiteBit = 1 << 4;
+
+    SingleLed warmWhiteLedStrip{ledActivity, WarmWhiteBit,
+                                util::PwmOutput<ResolutionBits>{ledTimerHandle, warmWhiteChannel}, GammaCorrection};
+    SingleLed coldWhiteLedStrip{ledActivity, ColdWhiteBit,
+                                util::PwmOutput<ResolutionBits>{ledTimerHandle, coldWhiteChannel}, GammaCorrection};
+
+    // 10 bit timer resolution + 6 bit by sigma-delta modulation -> 16 bit effective resolution
+    static constexpr auto FractionalBits = 16 - ResolutionBits;
+    static_assert(PwmSteps << FractionalBits == sunrise::MaximumValue + 1);
+
+    // The repetition counter holds each dithered compare value for 4 PWM periods, which cuts the
+    // update interrupt to 19.5kHz. The dithering pattern repeats at least every 64 update events
+    // (305Hz), so no flicker is visible.
+    static constexpr uint32_t DitherRepetitions = 4;
+
+    FractionalPwm<FractionalBits> warmWhiteFractionalPwm;
+    FractionalPwm<FractionalBits> coldWhiteFractionalPwm;
+    bool isFractionalPwmActive = false;
+
+    /// Regular PWM duty of a channel: the luminance at the end of the sunrise curve, mixed according
+    /// to color temperature. util's gamma correction only sees 100 %, so the brightness steps are
+    /// perceptually even like the sunrise.
+    static constexpr uint16_t calculateDuty(uint8_t brightness, uint16_t mix)
+    {
+        const uint32_t Luminance = sunrise::calculateLuminance(MaximumSunriseLevel, brightness) * mix / PwmSteps;
+        const uint32_t Duty = (Luminance + (1 << (FractionalBits - 1))) >> FractionalBits;
+        return std::min<uint32_t>(Duty, PwmSteps - 1);
+    }
+
+    /// 16 bit value of a channel along the sunrise curve, scaled so that it ends exactly at the
+    /// regular duty the fractional PWM hands over to
+    static constexpr uint32_t calculateFractionalValue(uint16_t level, uint8_t brightness, uint16_t mix)
     {
-        const auto ClampedColorTemperature = std::clamp(colorTemperature, WarmColorTemperature, ColdColorTemperature);
+        const uint32_t End = uint32_t{calculateDuty(brightness, mix)} << FractionalBits;
+        const uint32_t EndLuminance = sunrise::calculateLuminance(MaximumSunriseLevel, brightness);
+        if (EndLuminance == 0)
+            return 0;
 
-        if (ClampedColorTemperature < NeutralColorTemperature)
+        return static_cast<uint64_t>(sunrise::calculateLuminance(level, brightness)) * End / EndLuminance;
+    }
+
+    static constexpr bool isHandoverSeamless()
+    {
+        for (uint8_t brightness = 0; brightness <= 100; brightness++)
         {
-            // warm white has full brightness
-            warmWhiteBrightness = PwmSteps;
-            const float Factor =
-                ((ClampedColorTemperature - WarmColorTemperature) / (NeutralColorTemperature - WarmColorTemperature))
-                    .getMagnitude();
-            coldWhiteBrightness = Factor * PwmSteps;
+            for (const auto &Mix : cct::Table)
+            {
+                for (const auto Channel : {Mix.warmWhite, Mix.coldWhite})
+                {
+                    if (calculateFractionalValue(MaximumSunriseLevel, brightness, Channel) !=
+                        uint32_t{calculateDuty(brightness, Channel)} << FractionalBits)
+                        return false;
+                }
+            }
         }
-        else
+        return true;
+    }
+
+    void updateFractionalPwm()
+    {
+        const uint8_t Brightness = isEnabled ? globalBrightness : 0;
+        warmWhiteFractionalPwm.setValue(calculateFractionalValue(sunriseLevel, Brightness, warmWhiteBrightness));
+        coldWhiteFractionalPwm.setValue(calculateFractionalValue(sunriseLevel, Brightness, coldWhiteBrightness));
+
+        if (!isFractionalPwmActive)
         {
-            // cold white has full brightness
-            coldWhiteBrightness = PwmSteps;
-            const float Factor = 1.0f - ((ClampedColorTemperature - NeutralColorTemperature) /
-                                         (ColdColorTemperature - NeutralColorTemperature))
-                                            .getMagnitude();
-            warmWhiteBrightness = Factor * PwmSteps;
+            isFractionalPwmActive = true;
+
+            // preloaded, becomes active with the next update event
+            ledTimerHandle->Instance->RCR = DitherRepetitions - 1;
+            __HAL_TIM_ENABLE_IT(ledTimerHandle, TIM_IT_UPDATE);
         }
+    }
+
+    void stopFractionalPwm()
+    {
+        // the last fractional value equals the regular duty, so there is no step at the handover
+        static_assert(isHandoverSeamless());
+
+        if (!isFractionalPwmActive)
+            return;
+
+        __HAL_TIM_DISABLE_IT(ledTimerHandle, TIM_IT_UPDATE);
+        ledTimerHandle->Instance->RCR = 0;
+        isFractionalPwmActive = false;
+        updateBrightness();
+    }
 
-        warmWhiteLedStrip.setTargetPwmValue(warmWhiteBrightness);
-        coldWhiteLedStrip.setTargetPwmValue(coldWhiteBrightness);
+    void mapColorTemperatureToStrip()
+    {
+        const auto &Mix = cct::Table[colorTemperatureIndex];
+        warmWhiteBrightness = Mix.warmWhite;
+        coldWhiteBrightness = Mix.coldWhite;
+
+        updateBrightness();
     }
 
     void updateBrightness()
     {
-        warmWhiteLedStrip.setBrightness(globalBrightness);
-        coldWhiteLedStrip.setBrightness(globalBrightness);
+        if (isFractionalPwmActive)
+            updateFractionalPwm();
+
+        warmWhiteLedStrip.setTargetPwmValue(calculateDuty(globalBrightness, warmWhiteBrightness));
+        coldWhiteLedStrip.setTargetPwmValue(calculateDuty(globalBrightness, coldWhiteBrightness));
     }
 };
\ No newline at end of file
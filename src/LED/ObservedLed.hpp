@@ -0,0 +1,123 @@
+#pragma once
+
+#include "LedActivity.hpp"
+
+#include "util/led/PwmLed.hpp"
+
+#include <optional>
+#include <utility>
+
+/// Wraps a PWM LED from util and reports every effective change to LedActivity.
+/// Commands which do not change anything (e.g. turning off an already switched off LED or setting
+/// the same brightness again) are forwarded but not reported, so they do not wake up the LED service.
+template <typename Led>
+class ObservedLed : public Led
+{
+public:
+    template <typename... Args>
+    ObservedLed(LedActivity &activity, uint32_t ledBit, Args &&...args)
+        : Led(std::forward<Args>(args)...), //
+          activity(activity),               //
+          ledBit(ledBit)
+    {
+    }
+
+    void setState(bool state)
+    {
+        Led::setState(state);
+        applyState(state);
+    }
+
+    void turnOn()
+    {
+        Led::turnOn();
+        applyState(true);
+    }
+
+    void turnOff()
+    {
+        Led::turnOff();
+        applyState(false);
+    }
+
+    void setBrightness(uint8_t newBrightness)
+    {
+        Led::setBrightness(newBrightness);
+
+        if (brightness == newBrightness && !isBlinking)
+            return;
+
+        brightness = newBrightness;
+        reportChange();
+    }
+
+    void setTargetPwmValue(uint16_t newPwmValue)
+    {
+        Led::setTargetPwmValue(newPwmValue);
+
+        if (targetPwmValue == newPwmValue && !isBlinking)
+            return;
+
+        targetPwmValue = newPwmValue;
+        reportChange();
+    }
+
+    void setColor(util::led::pwm::DualLedColor newColor)
+    {
+        Led::setColor(newColor);
+
+        if (color == newColor && isOn && !isBlinking)
+            return;
+
+        color = newColor;
+        isOn = true;
+        reportChange();
+    }
+
+    template <typename... Args>
+    void setColorBlinking(Args &&...args)
+    {
+        Led::setColorBlinking(std::forward<Args>(args)...);
+        isOn = true;
+        isBlinking = true;
+        activity.setBlinking(ledBit, true);
+        activity.notifyChange();
+    }
+
+private:
+    LedActivity &activity;
+    uint32_t ledBit;
+
+    bool isOn = false;
+    bool isBlinking = false;
+
+    // unknown until the first command
+    std::optional<uint8_t> brightness;
+    std::optional<uint16_t> targetPwmValue;
+    std::optional<util::led::pwm::DualLedColor> color;
+
+    void applyState(bool state)
+    {
+        if (state == isOn && !isBlinking)
+            return;
+
+        isOn = state;
+        reportChange();
+    }
+
+    /// every command except setColorBlinking ends blinking
+    void reportChange()
+    {
+        stopBlinking();
+        activity.notifyChange();
+    }
+
+    void stopBlinking()
+    {
+        if (!isBlinking)
+            return;
+
+        isBlinking = false;
+        activity.setBlinking(ledBit, false);
+    }
+};
@@ -1,19 +1,29 @@
 #pragma once
 
+#include "LedActivity.hpp"
+#include "ObservedLed.hpp"
+
+#include "FreeRTOS.h"
+#include "helpers/freertos.hpp"
 #include "tim.h"
+#include "timers.h"
 #include "util/led/PwmLed.hpp"
-#include "wrappers/Task.hpp"
 
-class StatusLeds : public util::wrappers::TaskWithMemberFunctionBase
+/// LEDs are updated by LedService.
+/// The red/green LED is shared by the feedback of the state machine and the blink codes of
+/// FaultIndicator. Both drive it from the timer service task only and a blink code owns the LED
+/// while it is signaled, feedback is dropped meanwhile.
+class StatusLeds
 {
 public:
-    StatusLeds(TIM_HandleTypeDef *ledTimerHandle, const uint32_t &ledAlarm1Channel, const uint32_t &ledAlarm2Channel,
-               const uint32_t &ledRedChannel, const uint32_t &ledGreenChannel, TimerCallbackFunction_t timeoutCallback)
-        : TaskWithMemberFunctionBase("statusLedTask", 128, osPriorityLow2), ledTimerHandle(ledTimerHandle), //
-          ledAlarm1Channel(ledAlarm1Channel),                                                               //
-          ledAlarm2Channel(ledAlarm2Channel),                                                               //
-          ledRedChannel(ledRedChannel),                                                                     //
-          ledGreenChannel(ledGreenChannel),                                                                 //
+    StatusLeds(LedActivity &ledActivity, TIM_HandleTypeDef *ledTimerHandle, const uint32_t &ledAlarm1Channel,
+               const uint32_t &ledAlarm2Channel, const uint32_t &ledRedChannel, const uint32_t &ledGreenChannel,
+               TimerCallbackFunction_t timeoutCallback)
+        : ledActivity(ledActivity), ledTimerHandle(ledTimerHandle), //
+          ledAlarm1Channel(ledAlarm1Channel),                       //
+          ledAlarm2Channel(ledAlarm2Channel),                       //
+          ledRedChannel(ledRedChannel),                             //
+          ledGreenChannel(ledGreenChannel),                         //
           timeoutCallback(timeoutCallback)
     {
         configASSERT(this->ledTimerHandle != nullptr);
@@ -21,51 +31,70 @@ public:
 
     void handleTimeoutTimer()
     {
-        ledRedGreen.turnOff();
+        if (!isFaultSignaling)
+            ledRedGreen.turnOff();
+    }
+
+    /// has to be called from timer service task, a running feedback is ended
+    void setFaultSignaling(bool isSignaling)
+    {
+        isFaultSignaling = isSignaling;
+
+        if (isSignaling)
+            xTimerStop(timeoutTimer, 0);
     }
 
-protected:
-    [[noreturn]] void taskMain(void *)
+    void initialize()
     {
         ledAlarm1.setBrightness(25);
         ledAlarm2.setBrightness(25);
         ledRedGreen.setBrightness(25);
+    }
 
-        auto lastWakeTime = xTaskGetTickCount();
-
-        while (true)
-        {
-            ledAlarm1.updateState(lastWakeTime);
-            ledAlarm2.updateState(lastWakeTime);
-            ledRedGreen.updateState(lastWakeTime);
-            vTaskDelayUntil(&lastWakeTime, toOsTicks(100.0_Hz));
-        }
+    void updateState(TickType_t lastWakeTime)
+    {
+        ledAlarm1.updateState(lastWakeTime);
+        ledAlarm2.updateState(lastWakeTime);
+        ledRedGreen.updateState(lastWakeTime);
     }
 
 private:
+    LedActivity &ledActivity;
     TIM_HandleTypeDef *ledTimerHandle = nullptr;
     const uint32_t &ledAlarm1Channel;
     const uint32_t &ledAlarm2Channel;
     const uint32_t &ledRedChannel;
     const uint32_t &ledGreenChannel;
 
+    bool isFaultSignaling = false;
+
     TimerCallbackFunction_t timeoutCallback = nullptr;
-    TimerHandle_t timeoutTimer{xTimerCreate("timeoutTimer", toOsTicks(2.0_s), pdFALSE, nullptr, timeoutCallback)};
+    StaticTimer_t timeoutTimerBuffer{};
+    TimerHandle_t timeoutTimer{xTimerCreateStatic("timeoutTimer", toOsTicks(2.0_s), pdFALSE, nullptr, timeoutCallback,
+                                                  &timeoutTimerBuffer)};
 
 public:
-    // APB1 for timers: 80MHz -> 1024 PWM steps and clock divison by 4 -> 19.5kHz PWM frequency
+    // APB1 for timers: 80MHz -> 1024 PWM steps -> 78kHz PWM frequency
+    // (the clock division by 4 applies to dead time and input filters only, not to the counter)
     static constexpr auto PwmSteps = 1024;
     static constexpr auto ResolutionBits = std::bit_width<size_t>(PwmSteps - 1);
     using GammaCorrection_t = util::led::pwm::GammaCorrection<ResolutionBits>;
     static constexpr GammaCorrection_t GammaCorrection{};
 
-    using SingleLed = util::led::pwm::SingleLed<ResolutionBits, GammaCorrection_t>;
-    using DualLed = util::led::pwm::DualLed<ResolutionBits, GammaCorrection_t>;
+    using SingleLed = ObservedLed<util::led::pwm::SingleLed<ResolutionBits, GammaCorrection_t>>;
+    using DualLed = ObservedLed<util::led::pwm::DualLed<ResolutionBits, GammaCorrection_t>>;
 
-    SingleLed ledAlarm1{util::PwmOutput<ResolutionBits>{ledTimerHandle, ledAlarm1Channel}, GammaCorrection};
-    SingleLed ledAlarm2{util::PwmOutput<ResolutionBits>{ledTimerHandle, ledAlarm2Channel}, GammaCorrection};
+    static constexpr uint32_t LedAlarm1Bit = 1 << 0;
+    static constexpr uint32_t LedAlarm2Bit = 1 << 1;
+    static constexpr uint32_t LedRedGreenBit = 1 << 2;
 
-    DualLed ledRedGreen{util::PwmOutput<ResolutionBits>{ledTimerHandle, ledRedChannel},
+    SingleLed ledAlarm1{ledActivity, LedAlarm1Bit,
+                        util::PwmOutput<ResolutionBits>{ledTimerHandle, ledAlarm1Channel}, GammaCorrection};
+    SingleLed ledAlarm2{ledActivity, LedAlarm2Bit,
+                        util::PwmOutput<ResolutionBits>{ledTimerHandle, ledAlarm2Channel}, GammaCorrection};
+
+    DualLed ledRedGreen{ledActivity, LedRedGreenBit,
+                        util::PwmOutput<ResolutionBits>{ledTimerHandle, ledRedChannel},
                         util::PwmOutput<ResolutionBits>{ledTimerHandle, ledGreenChannel}, GammaCorrection};
 
     void turnAllOn()
@@ -84,15 +113,23 @@ public:
 
     void signalSuccess()
     {
-        ledRedGreen.setColor(util::led::pwm::DualLedColor::Green);
-        xTimerChangePeriod(timeoutTimer, toOsTicks(1.0_s), 0);
-        xTimerReset(timeoutTimer, 0);
+        xTimerPendFunctionCall(&StatusLeds::showFeedback, this, true, portMAX_DELAY);
     }
 
     void signalError()
     {
-        ledRedGreen.setColor(util::led::pwm::DualLedColor::Red);
-        xTimerChangePeriod(timeoutTimer, toOsTicks(5.0_s), 0);
-        xTimerReset(timeoutTimer, 0);
+        xTimerPendFunctionCall(&StatusLeds::showFeedback, this, false, portMAX_DELAY);
+    }
+
+private:
+    /// executed inside the timer service task
+    static void showFeedback(void *statusLeds, uint32_t isSuccess)
+    {
+        auto &self = *static_cast<StatusLeds *>(statusLeds);
+        if (self.isFaultSignaling)
+            return;
+
+        self.ledRedGreen.setColor(isSuccess ? util::led::pwm::DualLedColor::Green : util::led::pwm::DualLedColor::Red);
+        xTimerChangePeriod(self.timeoutTimer, toOsTicks(isSuccess ? 1.0_s : 5.0_s), 0); // this starts the timer too
     }
 };
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// Converts perceptual lightness into linear luminance (= PWM duty) using the CIE 1976 L* curve.
+/// A sunrise which is linear in lightness looks evenly paced to the eye, but it spends most of
+/// its time at tiny duty cycles, so it needs far more PWM resolution than a linear ramp.
+namespace sunrise
+{
+constexpr size_t TableSegments = 256;
+constexpr uint16_t MaximumValue = UINT16_MAX;
+
+constexpr float Kappa = 903.3f;
+constexpr float Epsilon = 0.008856f;
+
+constexpr float cubeRoot(float value)
+{
+    float result = value < 1.0f ? 1.0f : value;
+    for (auto i = 0; i < 40; i++)
+        result -= (result * result * result - value) / (3.0f * result * result);
+
+    return result;
+}
+
+constexpr float lStarToLuminance(float lStar)
+{
+    if (lStar <= 8.0f)
+        return lStar / Kappa;
+
+    const float Base = (lStar + 16.0f) / 116.0f;
+    return Base * Base * Base;
+}
+
+constexpr float luminanceToLStar(float luminance)
+{
+    if (luminance <= Epsilon)
+        return luminance * Kappa;
+
+    return 116.0f * cubeRoot(luminance) - 16.0f;
+}
+
+constexpr std::array<uint16_t, TableSegments + 1> LuminanceTable = []
+{
+    std::array<uint16_t, TableSegments + 1> table{};
+    for (size_t i = 0; i <= TableSegments; i++)
+    {
+        const float LStar = 100.0f * i / TableSegments;
+        table[i] = static_cast<uint16_t>(lStarToLuminance(LStar) * MaximumValue + 0.5f);
+    }
+    return table;
+}();
+
+/// @param lightness 0 = dark ... MaximumValue = L* 100
+/// @return relative luminance, 0 ... MaximumValue
+constexpr uint16_t lightnessToLuminance(uint16_t lightness)
+{
+    const uint32_t Index = lightness >> 8;
+    const uint32_t Fraction = lightness & 0xFF;
+    const uint32_t Lower = LuminanceTable[Index];
+    const uint32_t Upper = LuminanceTable[Index + 1];
+
+    return Lower + (((Upper - Lower) * Fraction) >> 8);
+}
+
+/// @param progress sunrise progress, 0 ... MaximumValue
+/// @param brightness perceptual target brightness at the end of sunrise in percent
+/// @return relative luminance, 0 ... MaximumValue
+constexpr uint16_t calculateLuminance(uint16_t progress, uint8_t brightness)
+{
+    return lightnessToLuminance(static_cast<uint32_t>(progress) * brightness / 100);
+}
+
+/// Simulates a sunrise with `steps` equidistant progress steps at full brightness, quantizes the
+/// luminance to `outputBits` and returns the largest lightness jump (in L*) between two
+/// consecutive steps. A difference of about 1 L* is just noticeable.
+constexpr float largestLightnessStep(size_t steps, size_t outputBits)
+{
+    const uint64_t OutputSteps = 1ULL << outputBits;
+    float largestStep = 0.0f;
+    float previousLStar = 0.0f;
+
+    for (size_t i = 1; i <= steps; i++)
+    {
+        const auto Progress = static_cast<uint16_t>(static_cast<uint64_t>(i) * MaximumValue / steps);
+        const uint64_t Code = calculateLuminance(Progress, 100) * OutputSteps / MaximumValue;
+        const float LStar = luminanceToLStar(static_cast<float>(Code) / OutputSteps);
+
+        if (LStar - previousLStar > largestStep)
+            largestStep = LStar - previousLStar;
+
+        previousLStar = LStar;
+    }
+
+    return largestStep;
+}
+} // namespace sunrise
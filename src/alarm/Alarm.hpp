@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+constexpr uint8_t MaximumAlarms = 8;
+
+/// One alarm of the schedule. It is packed into 32 bits, so it is stored as a single settings value
+/// and exchanged atomically between the tasks.
+///
+/// A daily alarm rings on all weekdays, a one-shot alarm disables itself after it has rung once.
+/// Skipping leaves out the next ring only, e.g. on a holiday.
+struct Alarm
+{
+    // one bit per calendar::Weekday
+    static constexpr uint8_t EveryDay = 0x7F;
+    static constexpr uint8_t Workdays = 0x1F;
+    static constexpr uint8_t Weekend = 0x60;
+
+    static constexpr uint16_t MinutesPerDay = 24 * 60;
+
+    uint16_t minuteOfDay = 7 * 60;
+    uint8_t weekdays = EveryDay;
+    bool isEnabled = false;
+    bool isOneShot = false;
+    bool isSkippingNext = false;
+
+    constexpr uint32_t pack() const
+    {
+        return minuteOfDay | weekdays << 16 | (isEnabled ? EnabledBit : 0) | (isOneShot ? OneShotBit : 0) |
+               (isSkippingNext ? SkippingNextBit : 0);
+    }
+
+    /// @return nothing for values which are not packed alarms, e.g. of a damaged setting
+    static constexpr std::optional<Alarm> unpack(uint32_t value)
+    {
+        constexpr uint32_t UsedBits = 0xFFFF | EveryDay << 16 | EnabledBit | OneShotBit | SkippingNextBit;
+
+        if ((value & ~UsedBits) != 0 || (value & 0xFFFF) >= MinutesPerDay)
+            return {};
+
+        return Alarm{static_cast<uint16_t>(value & 0xFFFF), static_cast<uint8_t>(value >> 16 & EveryDay),
+                     (value & EnabledBit) != 0, (value & OneShotBit) != 0, (value & SkippingNextBit) != 0};
+    }
+
+    constexpr bool operator==(const Alarm &) const = default;
+
+private:
+    static constexpr uint32_t EnabledBit = 1UL << 24;
+    static constexpr uint32_t OneShotBit = 1UL << 25;
+    static constexpr uint32_t SkippingNextBit = 1UL << 26;
+};
+
+static_assert(Alarm::unpack(Alarm{6 * 60 + 30, Alarm::Workdays, true, false, true}.pack()) ==
+              Alarm{6 * 60 + 30, Alarm::Workdays, true, false, true});
+static_assert(!Alarm::unpack(Alarm::MinutesPerDay) && !Alarm::unpack(UINT32_MAX));
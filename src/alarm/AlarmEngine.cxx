@@ -0,0 +1,174 @@
+#include "AlarmEngine.hpp"
+#include "task.h"
+
+#include <algorithm>
+
+void AlarmEngine::start()
+{
+    sendCommand(Command::Start);
+}
+
+//--------------------------------------------------------------------------------------------------
+void AlarmEngine::snooze()
+{
+    sendCommand(Command::Snooze);
+}
+
+//--------------------------------------------------------------------------------------------------
+void AlarmEngine::stop()
+{
+    sendCommand(Command::Stop);
+}
+
+//--------------------------------------------------------------------------------------------------
+void AlarmEngine::setSequence(const AlarmSequence &newSequence)
+{
+    if (!newSequence.isValid())
+        return;
+
+    requestedSequence = newSequence.pack();
+    sendCommand(Command::SetSequence, newSequence.pack());
+}
+
+//--------------------------------------------------------------------------------------------------
+AlarmSequence AlarmEngine::getSequence() const
+{
+    return AlarmSequence::unpack(requestedSequence).value_or(AlarmSequence{});
+}
+
+//--------------------------------------------------------------------------------------------------
+void AlarmEngine::setVibrationPattern(uint8_t alarm, vibration::PatternId patternId)
+{
+    if (alarm >= MaximumAlarms || static_cast<size_t>(patternId) >= vibration::Patterns.size())
+        return;
+
+    requestedPatterns[alarm] = patternId;
+    sendCommand(Command::SetVibrationPattern, alarm | static_cast<uint32_t>(patternId) << 8);
+}
+
+//--------------------------------------------------------------------------------------------------
+vibration::PatternId AlarmEngine::getVibrationPattern(uint8_t alarm) const
+{
+    return alarm < MaximumAlarms ? requestedPatterns[alarm].load() : vibration::PatternId::Ramp;
+}
+
+//--------------------------------------------------------------------------------------------------
+void AlarmEngine::handleDeadlineTimer()
+{
+    evaluate();
+}
+
+//--------------------------------------------------------------------------------------------------
+void AlarmEngine::sendCommand(Command command, uint32_t argument)
+{
+    xTimerPendFunctionCall(&AlarmEngine::executeCommand, this, static_cast<uint32_t>(command) | argument << 8,
+                           portMAX_DELAY);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// executed inside the timer service task
+void AlarmEngine::executeCommand(void *engine, uint32_t commandAndArgument)
+{
+    auto &self = *static_cast<AlarmEngine *>(engine);
+    const auto Now = getCurrentTime();
+    const uint32_t Argument = commandAndArgument >> 8;
+
+    switch (static_cast<Command>(commandAndArgument & 0xFF))
+    {
+    case Command::Start:
+    {
+        self.activePattern = self.alarmPatterns[self.rtc.getTriggeredAlarm()];
+        self.timeline.start(Now);
+        self.ledStrip.setSunriseLevel(0);
+        self.ledStrip.turnOn();
+        break;
+    }
+
+    case Command::Snooze:
+        self.timeline.snooze(Now);
+        break;
+
+    case Command::Stop:
+        self.timeline.stop();
+        break;
+
+    case Command::SetSequence:
+        self.applySequence(AlarmSequence::unpack(Argument).value_or(AlarmSequence{}));
+        break;
+
+    case Command::SetVibrationPattern:
+        self.alarmPatterns[Argument & 0xFF] = static_cast<vibration::PatternId>(Argument >> 8);
+        return; // the next alarm starts with it
+    }
+
+    self.evaluate();
+}
+
+//--------------------------------------------------------------------------------------------------
+void AlarmEngine::applySequence(const AlarmSequence &sequence)
+{
+    AlarmTimeline::Settings settings;
+    settings.snoozeDuration = sequence.snoozeDuration * AlarmTimeline::Minute;
+    settings.maximumSnoozeCount = sequence.maximumSnoozeCount;
+    settings.autoOffTimeout = sequence.autoOffTimeout * AlarmTimeline::Minute;
+    settings.sunriseResolution = SunriseSteps;
+
+    timeline.setSettings(settings);
+}
+
+//--------------------------------------------------------------------------------------------------
+void AlarmEngine::evaluate()
+{
+    const auto Now = getCurrentTime();
+    const auto NextDeadline = timeline.update(Now);
+    applyOutputs();
+
+    if (!NextDeadline)
+    {
+        xTimerStop(deadlineTimer, 0);
+        return;
+    }
+
+    const auto Milliseconds = std::min(NextDeadline.value() - Now, MaximumTimerDelay);
+    const TickType_t Delay = std::max<TickType_t>(1, pdMS_TO_TICKS(Milliseconds));
+    xTimerChangePeriod(deadlineTimer, Delay, 0); // this starts the timer too
+}
+
+//--------------------------------------------------------------------------------------------------
+void AlarmEngine::applyOutputs()
+{
+    switch (timeline.getPhase())
+    {
+    case AlarmTimeline::Phase::Off:
+        rtc.setAlarmState(RealTimeClock::AlarmState::Off);
+        ledStrip.setSunriseLevel(AlarmTimeline::MaximumLightLevel);
+        break;
+
+    case AlarmTimeline::Phase::Sunrise:
+        rtc.setAlarmState(RealTimeClock::AlarmState::Sunrise);
+        ledStrip.setSunriseLevel(timeline.getLightLevel());
+        break;
+
+    case AlarmTimeline::Phase::Vibration:
+        rtc.setAlarmState(RealTimeClock::AlarmState::Vibration);
+        ledStrip.setSunriseLevel(AlarmTimeline::MaximumLightLevel);
+        break;
+
+    case AlarmTimeline::Phase::Snooze:
+        rtc.setAlarmState(RealTimeClock::AlarmState::Snooze);
+        ledStrip.setSunriseLevel(AlarmTimeline::MaximumLightLevel);
+        break;
+    }
+
+    if (timeline.isVibrationActive() && !vibrationCushion.isPlaying())
+        vibrationCushion.play(activePattern);
+
+    else if (!timeline.isVibrationActive() && vibrationCushion.isPlaying())
+        vibrationCushion.stop();
+}
+
+//--------------------------------------------------------------------------------------------------
+AlarmTimeline::Milliseconds AlarmEngine::getCurrentTime()
+{
+    return xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
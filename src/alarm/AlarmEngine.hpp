@@ -0,0 +1,109 @@
+#pragma once
+
+#include "AlarmSequence.hpp"
+#include "AlarmTimeline.hpp"
+#include "LED/LedStrip.hpp"
+#include "rtc/RealTimeClock.hpp"
+#include "vibration/VibrationCushion.hpp"
+
+#include "FreeRTOS.h"
+#include "main.h"
+#include "timers.h"
+#include "util/gpio.hpp"
+
+#include <array>
+#include <atomic>
+
+/// Runs the alarm timeline (sunrise -> vibration -> snooze -> off) on real hardware.
+/// There is no dedicated task: all work is done inside the timer service task, which is woken up
+/// only at the next deadline of the timeline. Commands from other tasks are deferred to the
+/// timer service task, so the timeline is never accessed concurrently.
+class AlarmEngine
+{
+public:
+    AlarmEngine(RealTimeClock &rtc, LedStrip &ledStrip, VibrationCushion &vibrationCushion,
+                TimerCallbackFunction_t deadlineCallback)
+        : rtc(rtc),                           //
+          ledStrip(ledStrip),                 //
+          vibrationCushion(vibrationCushion), //
+          deadlineCallback(deadlineCallback)
+    {
+        for (uint8_t i = 0; i < MaximumAlarms; i++)
+        {
+            alarmPatterns[i] = getDefaultPattern(i);
+            requestedPatterns[i] = getDefaultPattern(i);
+        }
+
+        applySequence(AlarmSequence{});
+    }
+
+    void start();
+    void snooze();
+    void stop();
+
+    /// applied by the timer service task, also to a running alarm
+    void setSequence(const AlarmSequence &newSequence);
+    AlarmSequence getSequence() const;
+
+    /// @param alarm index of the alarm
+    void setVibrationPattern(uint8_t alarm, vibration::PatternId patternId);
+    vibration::PatternId getVibrationPattern(uint8_t alarm) const;
+
+    void handleDeadlineTimer();
+
+    /// one sunrise step per second, the light is recalculated only at these deadlines
+    static constexpr uint16_t SunriseSteps = 30 * 60;
+
+    // with 16 bit fractional PWM no step of the sunrise is perceivable (< 0.1 L*),
+    // plain 10 bit PWM would give jumps of up to 0.9 L* at the beginning of sunrise
+    static_assert(sunrise::largestLightnessStep(SunriseSteps, 16) < 0.1f);
+
+private:
+    /// pdMS_TO_TICKS() multiplies in 32 bits and overflows after 71 minutes, so a later deadline is
+    /// evaluated again after this delay
+    static constexpr AlarmTimeline::Milliseconds MaximumTimerDelay = 60 * AlarmTimeline::Minute;
+
+    RealTimeClock &rtc;
+    LedStrip &ledStrip;
+    VibrationCushion &vibrationCushion;
+
+    AlarmTimeline timeline;
+
+    /// alternating, so neighbouring alarms are told apart
+    static constexpr vibration::PatternId getDefaultPattern(uint8_t alarm)
+    {
+        return alarm % 2 == 0 ? vibration::PatternId::Ramp : vibration::PatternId::Heartbeat;
+    }
+
+    std::array<vibration::PatternId, MaximumAlarms> alarmPatterns{};
+    vibration::PatternId activePattern = vibration::PatternId::Ramp;
+
+    // what has been requested by other tasks, only read back by them
+    std::atomic<uint32_t> requestedSequence = AlarmSequence{}.pack();
+    std::array<std::atomic<vibration::PatternId>, MaximumAlarms> requestedPatterns{};
+
+    TimerCallbackFunction_t deadlineCallback = nullptr;
+    StaticTimer_t deadlineTimerBuffer{};
+    TimerHandle_t deadlineTimer{
+        xTimerCreateStatic("alarmTimer", 1, pdFALSE, nullptr, deadlineCallback, &deadlineTimerBuffer)};
+
+    enum class Command : uint8_t
+    {
+        Start,
+        Snooze,
+        Stop,
+        SetSequence,        // the argument is a packed AlarmSequence
+        SetVibrationPattern // the argument is the index of the alarm and the PatternId above it
+    };
+
+    /// the argument is passed within the same 32 bits as the command, so no other task touches the timeline
+    void sendCommand(Command command, uint32_t argument = 0);
+    static void executeCommand(void *engine, uint32_t commandAndArgument);
+
+    void applySequence(const AlarmSequence &sequence);
+
+    void evaluate();
+    void applyOutputs();
+
+    static AlarmTimeline::Milliseconds getCurrentTime();
+};
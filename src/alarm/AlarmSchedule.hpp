@@ -0,0 +1,273 @@
+#pragma once
+
+#include "Alarm.hpp"
+#include "rtc/Calendar.hpp"
+#include "rtc/TimeZone.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+
+/// Sunrise starts of all alarms, ordered by a min-heap. The sunrise starts half an hour before
+/// its alarm, so it may start on the day before.
+///
+/// Each alarm has at most one entry, its next sunrise start. The heap is built only after an alarm
+/// or the date has changed. Otherwise polling every second compares with the top of the heap, and
+/// an entry which is due is replaced by the following start of the same alarm in O(log n).
+/// It is pure logic, the current instant is always passed in by the caller.
+///
+/// The alarms are set in local time, but the starts are UTC instants. So they do not move when
+/// daylight saving time begins or ends, and the earliest one is programmed into the RTC as it is.
+class AlarmSchedule
+{
+public:
+    static constexpr uint32_t SunriseLead = 30 * 60; // seconds
+
+    struct Trigger
+    {
+        calendar::Instant sunriseStart;
+        uint8_t alarm; // index
+    };
+
+    constexpr void setAlarm(uint8_t index, const Alarm &alarm)
+    {
+        alarms[index] = alarm;
+        invalidate();
+    }
+
+    constexpr const Alarm &getAlarm(uint8_t index) const
+    {
+        return alarms[index];
+    }
+
+    /// all alarms are kept, but none of them rings if switched off
+    constexpr void setSwitchedOn(bool switchedOn)
+    {
+        isSwitchedOn = switchedOn;
+        invalidate();
+    }
+
+    constexpr void setTimeZone(const TimeZone &newTimeZone)
+    {
+        timeZone = newTimeZone;
+        invalidate();
+    }
+
+    /// has to be called if the date or the time has been changed other than by ticking on
+    constexpr void invalidate()
+    {
+        isOutdated = true;
+    }
+
+    /// Has to be called at least once a minute. The alarms have minute resolution, so a sunrise is
+    /// due during the whole minute it starts in. A one-shot alarm is disabled when it is due and
+    /// skipping ends with the next start, also if the clock has been set beyond it.
+    /// @param now UTC
+    /// @return index of the alarm whose sunrise is due, the first one if several are due
+    constexpr std::optional<uint8_t> poll(calendar::Instant now)
+    {
+        // nearly every poll ends here, the rest is kept out of line
+        if (!isOutdated && (heapSize == 0 || heap[0].sunriseStart > now))
+            return {};
+
+        return popDueTriggers(now);
+    }
+
+    constexpr std::optional<Trigger> getNextTrigger() const
+    {
+        if (heapSize == 0)
+            return {};
+
+        return heap[0];
+    }
+
+    /// @return one bit for each alarm which was changed by poll() since the last call
+    constexpr uint32_t takeChangedAlarms()
+    {
+        const auto Changed = changedAlarms;
+        changedAlarms = 0;
+        return Changed;
+    }
+
+    /// @return the earliest sunrise start of an alarm at or after the given UTC instant
+    constexpr std::optional<calendar::Instant> findNextSunriseStart(const Alarm &alarm, calendar::Instant from)
+    {
+        if (!alarm.isEnabled || (alarm.weekdays & Alarm::EveryDay) == 0)
+            return {};
+
+        // the sunrise for the alarm of tomorrow may start today, so the alarm day of today
+        // is searched again a week later
+        const auto Today = calendar::getDayNumber(timeZone.toLocal(from));
+        for (uint32_t day = Today; day <= Today + 7u; day++)
+        {
+            if ((alarm.weekdays & (1U << static_cast<uint8_t>(calendar::getWeekday(day)))) == 0)
+                continue;
+
+            const auto AlarmInstant = timeZone.toUtc(calendar::toInstant(day, alarm.minuteOfDay * 60U));
+            if (AlarmInstant >= from + SunriseLead)
+                return AlarmInstant - SunriseLead;
+        }
+
+        return {};
+    }
+
+private:
+    static constexpr calendar::Instant Minute = 60;
+
+    std::array<Alarm, MaximumAlarms> alarms{};
+    bool isSwitchedOn = true;
+    TimeZone timeZone;
+    bool isOutdated = true;
+
+    std::array<Trigger, MaximumAlarms> heap{};
+    uint8_t heapSize = 0;
+
+    std::optional<calendar::Instant> handledMinute;
+    uint32_t changedAlarms = 0;
+
+    /// not inlined, so the common return of poll() does not pay for the registers of this one
+    __attribute__((noinline)) constexpr std::optional<uint8_t> popDueTriggers(calendar::Instant now)
+    {
+        const calendar::Instant StartOfMinute = now - now % Minute;
+
+        if (isOutdated)
+        {
+            isOutdated = false;
+
+            // the starts of this minute have been handled already, if it is changed again within
+            buildHeap(StartOfMinute == handledMinute ? StartOfMinute + Minute : StartOfMinute);
+        }
+
+        std::optional<uint8_t> dueAlarm;
+
+        while (heapSize != 0 && heap[0].sunriseStart <= now)
+        {
+            const auto Next = popTrigger();
+            auto &alarm = alarms[Next.alarm];
+
+            if (alarm.isSkippingNext)
+            {
+                alarm.isSkippingNext = false;
+                changedAlarms |= 1U << Next.alarm;
+            }
+            else if (now - Next.sunriseStart < Minute)
+            {
+                if (!dueAlarm)
+                    dueAlarm = Next.alarm;
+
+                if (alarm.isOneShot)
+                {
+                    alarm.isEnabled = false;
+                    changedAlarms |= 1U << Next.alarm;
+                }
+            }
+
+            handledMinute = StartOfMinute;
+            pushNextTrigger(Next.alarm, StartOfMinute + Minute);
+        }
+
+        return dueAlarm;
+    }
+
+    /// the earlier start is on top, the lower index on a tie
+    static constexpr bool isLater(const Trigger &a, const Trigger &b)
+    {
+        return a.sunriseStart != b.sunriseStart ? a.sunriseStart > b.sunriseStart : a.alarm > b.alarm;
+    }
+
+    constexpr void buildHeap(calendar::Instant from)
+    {
+        heapSize = 0;
+        if (!isSwitchedOn)
+            return;
+
+        for (uint8_t i = 0; i < MaximumAlarms; i++)
+        {
+            if (const auto SunriseStart = findNextSunriseStart(alarms[i], from))
+                heap[heapSize++] = Trigger{*SunriseStart, i};
+        }
+
+        std::make_heap(heap.begin(), heap.begin() + heapSize, isLater);
+    }
+
+    constexpr void pushNextTrigger(uint8_t alarm, calendar::Instant from)
+    {
+        const auto SunriseStart = findNextSunriseStart(alarms[alarm], from);
+        if (!SunriseStart)
+            return;
+
+        heap[heapSize++] = Trigger{*SunriseStart, alarm};
+        std::push_heap(heap.begin(), heap.begin() + heapSize, isLater);
+    }
+
+    constexpr Trigger popTrigger()
+    {
+        std::pop_heap(heap.begin(), heap.begin() + heapSize, isLater);
+        return heap[--heapSize];
+    }
+};
+
+namespace alarm_schedule_checks
+{
+constexpr auto Friday = calendar::toDayNumber({17, 5, 2024, 0});
+constexpr auto Monday = calendar::toDayNumber({20, 5, 2024, 0});
+
+constexpr calendar::Instant at(uint16_t day, uint8_t hour, uint8_t minute)
+{
+    return calendar::toInstant(day, (hour * 60U + minute) * 60U);
+}
+
+/// polls every minute
+constexpr std::optional<calendar::Instant> findFirstRing(AlarmSchedule schedule, calendar::Instant from,
+                                                         uint8_t expectedAlarm)
+{
+    for (auto now = from; now < from + 8 * calendar::SecondsPerDay; now += 60)
+    {
+        if (const auto Due = schedule.poll(now))
+            return *Due == expectedAlarm ? std::optional(now) : std::nullopt;
+    }
+
+    return {};
+}
+
+constexpr AlarmSchedule WorkdaysAndWeekend = []
+{
+    AlarmSchedule schedule;
+    schedule.setTimeZone(TimeZone(0, false));
+    schedule.setAlarm(0, {7 * 60, Alarm::Workdays, true});
+    schedule.setAlarm(1, {9 * 60, Alarm::Weekend, true});
+    schedule.setAlarm(2, {10, Alarm::EveryDay, true, true}); // 00:10 once
+    return schedule;
+}();
+
+static_assert(findFirstRing(WorkdaysAndWeekend, at(Friday, 8, 0), 2) == at(Friday, 23, 40));
+static_assert(findFirstRing(WorkdaysAndWeekend, at(Friday, 23, 45), 1) == at(Monday - 2, 8, 30));
+
+// the one-shot alarm has disabled itself and the workday alarm skips monday
+static_assert([]
+{
+    auto schedule = WorkdaysAndWeekend;
+    auto alarm = schedule.getAlarm(0);
+    alarm.isSkippingNext = true;
+    schedule.setAlarm(0, alarm);
+
+    for (auto now = at(Friday, 8, 0); now < at(Monday + 1, 6, 0); now += 60)
+        schedule.poll(now);
+
+    return !schedule.getAlarm(2).isEnabled && !schedule.getAlarm(0).isSkippingNext &&
+           schedule.getNextTrigger()->sunriseStart == at(Monday + 1, 6, 30);
+}());
+
+// the alarm of 07:00 stays at local time, when daylight saving time begins on sunday
+static_assert([]
+{
+    constexpr auto Saturday = calendar::toDayNumber({30, 3, 2024, 0});
+
+    AlarmSchedule schedule;
+    schedule.setAlarm(0, {7 * 60, Alarm::EveryDay, true});
+
+    return findFirstRing(schedule, at(Saturday, 0, 0), 0) == at(Saturday, 5, 30) &&
+           findFirstRing(schedule, at(Saturday, 6, 0), 0) == at(Saturday + 1, 4, 30);
+}());
+} // namespace alarm_schedule_checks
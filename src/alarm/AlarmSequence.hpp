@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+/// What follows the sunrise of every alarm: vibration, which can be snoozed a number of times and
+/// turns itself off without any user interaction. It is packed into 32 bits, so it is stored as a
+/// single settings value and passed to the alarm engine within a command.
+struct AlarmSequence
+{
+    static constexpr uint8_t MaximumSnoozeDuration = 60; // minutes
+    static constexpr uint8_t MaximumSnoozeCount = 10;
+    static constexpr uint8_t MaximumAutoOffTimeout = 120; // minutes
+
+    uint8_t snoozeDuration = 9; // minutes
+    uint8_t maximumSnoozeCount = 3;
+    uint8_t autoOffTimeout = 15; // minutes of vibrating
+
+    constexpr bool isValid() const
+    {
+        return snoozeDuration >= 1 && snoozeDuration <= MaximumSnoozeDuration &&
+               maximumSnoozeCount <= MaximumSnoozeCount && autoOffTimeout >= 1 &&
+               autoOffTimeout <= MaximumAutoOffTimeout;
+    }
+
+    constexpr uint32_t pack() const
+    {
+        return snoozeDuration | maximumSnoozeCount << 8 | autoOffTimeout << 16;
+    }
+
+    /// @return nothing for values which are not packed sequences, e.g. of a damaged setting
+    static constexpr std::optional<AlarmSequence> unpack(uint32_t value)
+    {
+        const AlarmSequence Sequence{static_cast<uint8_t>(value & 0xFF), static_cast<uint8_t>(value >> 8 & 0xFF),
+                                     static_cast<uint8_t>(value >> 16 & 0xFF)};
+
+        if (value >> 24 != 0 || !Sequence.isValid())
+            return {};
+
+        return Sequence;
+    }
+
+    constexpr bool operator==(const AlarmSequence &) const = default;
+};
+
+static_assert(AlarmSequence::unpack(AlarmSequence{5, 0, 30}.pack()) == AlarmSequence{5, 0, 30});
+static_assert(AlarmSequence{}.isValid() && !AlarmSequence::unpack(0) && !AlarmSequence::unpack(UINT32_MAX));
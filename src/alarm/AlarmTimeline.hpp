@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+/// Timeline of a single alarm from the start of sunrise until it is turned off.
+/// It is pure logic without any RTOS or HAL dependencies, the current time is always passed in by
+/// the caller. Because of that a full alarm cycle can be run on host in virtual time.
+class AlarmTimeline
+{
+public:
+    using Milliseconds = uint32_t;
+
+    static constexpr Milliseconds Second = 1000;
+    static constexpr Milliseconds Minute = 60 * Second;
+
+    static constexpr uint16_t MaximumLightLevel = UINT16_MAX;
+
+    struct Settings
+    {
+        Milliseconds sunriseDuration = 30 * Minute;
+        Milliseconds snoozeDuration = 9 * Minute;
+        uint8_t maximumSnoozeCount = 3;
+
+        /// vibrating without any user interaction turns the alarm off after this time
+        Milliseconds autoOffTimeout = 15 * Minute;
+
+        /// number of distinct light levels the sunrise ramp is divided into
+        uint16_t sunriseResolution = 100;
+    };
+
+    enum class Phase
+    {
+        Off,
+        Sunrise,
+        Vibration,
+        Snooze
+    };
+
+    void setSettings(const Settings &newSettings)
+    {
+        settings = newSettings;
+
+        if (settings.sunriseResolution == 0)
+            settings.sunriseResolution = 1;
+    }
+
+    const Settings &getSettings() const
+    {
+        return settings;
+    }
+
+    void start(Milliseconds now)
+    {
+        snoozeCount = 0;
+        lightLevel = 0;
+        enterPhase(Phase::Sunrise, now);
+    }
+
+    /// @return false if the alarm is not vibrating or the snooze count is exhausted
+    bool snooze(Milliseconds now)
+    {
+        if (phase != Phase::Vibration || snoozeCount >= settings.maximumSnoozeCount)
+            return false;
+
+        snoozeCount++;
+        enterPhase(Phase::Snooze, now);
+        return true;
+    }
+
+    void stop()
+    {
+        phase = Phase::Off;
+        isVibrating = false;
+    }
+
+    /// Evaluates the timeline at the given time and updates all outputs.
+    /// Phase transitions are anchored at their exact deadline and not at the time update() is
+    /// called, so late calls do not accumulate drift.
+    /// @return absolute time of the next output change, nothing if the alarm is off
+    std::optional<Milliseconds> update(Milliseconds now)
+    {
+        const Milliseconds Elapsed = now - phaseStart;
+
+        switch (phase)
+        {
+        case Phase::Sunrise:
+        {
+            if (Elapsed >= settings.sunriseDuration)
+            {
+                lightLevel = MaximumLightLevel;
+                enterPhase(Phase::Vibration, phaseStart + settings.sunriseDuration);
+                return update(now);
+            }
+
+            const uint32_t Step =
+                static_cast<uint64_t>(Elapsed) * settings.sunriseResolution / settings.sunriseDuration;
+            lightLevel = static_cast<uint64_t>(Step) * MaximumLightLevel / settings.sunriseResolution;
+
+            // first point in time which belongs to the next step (ceiling division)
+            const uint64_t NextStepEnumerator = static_cast<uint64_t>(Step + 1) * settings.sunriseDuration;
+            return phaseStart + static_cast<Milliseconds>((NextStepEnumerator + settings.sunriseResolution - 1) /
+                                                          settings.sunriseResolution);
+        }
+
+        case Phase::Vibration:
+        {
+            if (Elapsed >= settings.autoOffTimeout)
+            {
+                stop();
+                return {};
+            }
+
+            // the pattern itself is played by the vibration cushion
+            isVibrating = true;
+            return phaseStart + settings.autoOffTimeout;
+        }
+
+        case Phase::Snooze:
+        {
+            isVibrating = false;
+
+            if (Elapsed >= settings.snoozeDuration)
+            {
+                enterPhase(Phase::Vibration, phaseStart + settings.snoozeDuration);
+                return update(now);
+            }
+
+            return phaseStart + settings.snoozeDuration;
+        }
+
+        case Phase::Off:
+        default:
+            return {};
+        }
+    }
+
+    Phase getPhase() const
+    {
+        return phase;
+    }
+
+    uint16_t getLightLevel() const
+    {
+        return lightLevel;
+    }
+
+    bool isVibrationActive() const
+    {
+        return isVibrating;
+    }
+
+    uint8_t getSnoozeCount() const
+    {
+        return snoozeCount;
+    }
+
+private:
+    Settings settings{};
+
+    Phase phase = Phase::Off;
+    Milliseconds phaseStart = 0;
+
+    uint16_t lightLevel = 0;
+    bool isVibrating = false;
+    uint8_t snoozeCount = 0;
+
+    void enterPhase(Phase newPhase, Milliseconds startTime)
+    {
+        phase = newPhase;
+        phaseStart = startTime;
+        isVibrating = false;
+    }
+};
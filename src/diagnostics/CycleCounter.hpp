@@ -0,0 +1,20 @@
+#pragma once
+
+#include "main.h"
+
+#include <cstdint>
+
+namespace diagnostics
+{
+/// CPU cycles of the DWT, started by the scheduler for the run-time statistics
+inline uint32_t getCycleCount()
+{
+    return DWT->CYCCNT;
+}
+
+inline void startCycleCounter()
+{
+    SET_BIT(CoreDebug->DEMCR, CoreDebug_DEMCR_TRCENA_Msk);
+    SET_BIT(DWT->CTRL, DWT_CTRL_CYCCNTENA_Msk);
+}
+} // namespace diagnostics
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace diagnostics
+{
+/// interrupt handlers of the application, which are profiled and traced
+enum class Isr : uint8_t
+{
+    Multiplexing,
+    DisplayPwm,
+    LedStripPwm,
+    SerialUart,
+    SerialRxDma,
+    SerialTxDma,
+    SupplyVoltage
+};
+
+constexpr size_t NumberOfIsrs = static_cast<size_t>(Isr::SupplyVoltage) + 1;
+
+constexpr std::array<const char *, NumberOfIsrs> IsrNames{
+    "multiplexing", "displayPwm",  "ledStripPwm",   "serialUart",
+    "serialRxDma",  "serialTxDma", "supplyVoltage",
+};
+} // namespace diagnostics
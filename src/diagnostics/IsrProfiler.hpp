@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CycleCounter.hpp"
+#include "Isr.hpp"
+#include "Trace.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace diagnostics
+{
+/// Sums up the CPU cycles spent in the interrupt handlers of the application. FreeRTOS counts
+/// them to the interrupted task, so they are part of the task loads as well. The time of a
+/// nested interrupt is counted to both handlers. Entry and exit are traced as well.
+class IsrProfiler
+{
+public:
+    struct Counters
+    {
+        uint32_t cycles;
+        uint32_t calls;
+    };
+
+    /// placed at the begin of an interrupt handler
+    class Scope
+    {
+    public:
+        explicit Scope(Isr isr)
+            : isr(isr), counters(IsrProfiler::counters[static_cast<size_t>(isr)]), start(getCycleCount())
+        {
+            trace::record<trace::Event::IsrEnter>(static_cast<uint16_t>(isr));
+        }
+
+        ~Scope()
+        {
+            trace::record<trace::Event::IsrExit>(static_cast<uint16_t>(isr));
+            counters.cycles = counters.cycles + (getCycleCount() - start);
+            counters.calls = counters.calls + 1;
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Isr isr;
+        volatile Counters &counters;
+        uint32_t start;
+    };
+
+    /// counters wrap around, only their differences are meaningful
+    static Counters getCounters(Isr isr)
+    {
+        const auto &Source = counters[static_cast<size_t>(isr)];
+
+        // both values may change in between, which is negligible for statistics
+        return {Source.cycles, Source.calls};
+    }
+
+private:
+    static inline std::array<volatile Counters, NumberOfIsrs> counters{};
+};
+} // namespace diagnostics
@@ -0,0 +1,51 @@
+#include "MainStack.hpp"
+
+#include "main.h"
+
+// symbols of the linker script, their addresses are the values
+extern "C" uint32_t _estack;         // NOLINT
+extern "C" uint32_t _Min_Stack_Size; // NOLINT
+
+namespace
+{
+constexpr uint32_t Pattern = 0xa5a5'a5a5; // same as FreeRTOS for the task stacks
+
+uint32_t *getBottom()
+{
+    return &_estack - diagnostics::getMainStackSize();
+}
+} // namespace
+
+namespace diagnostics
+{
+void paintMainStack()
+{
+    // nothing below the stack pointer is in use while the interrupts are disabled
+    const auto Primask = __get_PRIMASK();
+    __disable_irq();
+
+    const auto *StackPointer = reinterpret_cast<uint32_t *>(__get_MSP());
+    for (auto *word = getBottom(); word < StackPointer; word++)
+        *word = Pattern;
+
+    __set_PRIMASK(Primask);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t getMainStackSize()
+{
+    return reinterpret_cast<uintptr_t>(&_Min_Stack_Size) / sizeof(uint32_t);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint32_t getMainStackHighWaterMark()
+{
+    const auto *Bottom = getBottom();
+    uint32_t words = 0;
+
+    while (words < getMainStackSize() && Bottom[words] == Pattern)
+        words++;
+
+    return words;
+}
+} // namespace diagnostics
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+/// High-water mark of the main stack, which is used by the interrupt handlers once the
+/// scheduler is running. FreeRTOS only fills the task stacks with a pattern.
+namespace diagnostics
+{
+/// called once by a task, after the scheduler has reset the main stack pointer
+void paintMainStack();
+
+/// @return words reserved by the linker script
+uint32_t getMainStackSize();
+
+/// @return words which have never been used since painting
+uint32_t getMainStackHighWaterMark();
+} // namespace diagnostics
@@ -0,0 +1,34 @@
+#include "RunTimeCounter.h"
+#include "CycleCounter.hpp"
+
+namespace
+{
+// the run-time counter runs at 1.25 MHz and wraps around after 57 minutes
+constexpr uint8_t RunTimeCounterShift = 6;
+
+uint64_t extendedCycles = 0;
+uint32_t lastCycles = 0;
+} // namespace
+
+extern "C" void configureRunTimeCounter(void)
+{
+    diagnostics::startCycleCounter();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The cycle counter wraps around after 53 s at 80 MHz. It is extended to 64 bit at each call,
+/// which happens at least with every context switch, and scaled down afterwards.
+extern "C" uint32_t getRunTimeCounterValue(void)
+{
+    // called by the scheduler from PendSV and by tasks
+    const auto Primask = __get_PRIMASK();
+    __disable_irq();
+
+    const uint32_t Now = diagnostics::getCycleCount();
+    extendedCycles += Now - lastCycles;
+    lastCycles = Now;
+    const auto Value = static_cast<uint32_t>(extendedCycles >> RunTimeCounterShift);
+
+    __set_PRIMASK(Primask);
+    return Value;
+}
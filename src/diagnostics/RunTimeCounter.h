@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Time base of the FreeRTOS run-time statistics, included by FreeRTOSConfig.h.
+ * It is derived from the cycle counter of the DWT, see RunTimeCounter.cxx */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void configureRunTimeCounter(void);
+    uint32_t getRunTimeCounterValue(void);
+
+#ifdef __cplusplus
+}
+#endif
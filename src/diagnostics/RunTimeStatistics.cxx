@@ -0,0 +1,94 @@
+#include "RunTimeStatistics.hpp"
+#include "MainStack.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using diagnostics::IsrProfiler;
+
+/// defined in freertos_tasks_c_additions.h
+extern "C" uint32_t getTaskStackSize(TaskHandle_t task);
+
+bool RunTimeStatistics::getSnapshot(Snapshot &destination)
+{
+    // the timer task must not block on a mutex, so the copies are done with the scheduler suspended
+    vTaskSuspendAll();
+    const bool IsValid = isSnapshotValid;
+    if (IsValid)
+        destination = snapshot;
+    xTaskResumeAll();
+
+    return IsValid;
+}
+
+//--------------------------------------------------------------------------------------------------
+void RunTimeStatistics::handleTimer()
+{
+    uint32_t totalRunTime = 0;
+    const auto NumberOfTasks = uxTaskGetSystemState(taskStatusArray.data(), taskStatusArray.size(), &totalRunTime);
+    configASSERT(NumberOfTasks > 0); // array is too small
+
+    const uint32_t CycleCount = diagnostics::getCycleCount();
+    const uint32_t WindowRunTime = totalRunTime - lastTotalRunTime;
+    const uint32_t WindowCycles = CycleCount - lastCycleCount;
+
+    Snapshot newSnapshot{};
+    newSnapshot.numberOfTasks = NumberOfTasks;
+    newSnapshot.cpuLoad = 10000;
+
+    for (size_t i = 0; i < NumberOfTasks; i++)
+    {
+        const auto &Status = taskStatusArray[i];
+        const auto Load = toLoad(Status.ulRunTimeCounter - getLastRunTime(Status.xTaskNumber), WindowRunTime);
+
+        newSnapshot.tasks[i] = {Status.pcTaskName, Load, static_cast<uint16_t>(getTaskStackSize(Status.xHandle)),
+                                Status.usStackHighWaterMark};
+
+        if (std::strcmp(Status.pcTaskName, configIDLE_TASK_NAME) == 0)
+            newSnapshot.cpuLoad = 10000 - Load;
+    }
+
+    for (size_t i = 0; i < diagnostics::NumberOfIsrs; i++)
+    {
+        const auto Counters = IsrProfiler::getCounters(static_cast<diagnostics::Isr>(i));
+        newSnapshot.isrs[i] = {toLoad(Counters.cycles - lastIsrCounters[i].cycles, WindowCycles),
+                               Counters.calls - lastIsrCounters[i].calls};
+        lastIsrCounters[i] = Counters;
+    }
+
+    newSnapshot.mainStack = {diagnostics::getMainStackSize(), diagnostics::getMainStackHighWaterMark()};
+    newSnapshot.heap = {xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize()};
+
+    for (size_t i = 0; i < NumberOfTasks; i++)
+        lastTaskCounters[i] = {taskStatusArray[i].xTaskNumber, taskStatusArray[i].ulRunTimeCounter};
+
+    lastNumberOfTasks = NumberOfTasks;
+    lastTotalRunTime = totalRunTime;
+    lastCycleCount = CycleCount;
+
+    vTaskSuspendAll();
+    snapshot = newSnapshot;
+    isSnapshotValid = true;
+    xTaskResumeAll();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// @return 0 for tasks created during the last window
+uint32_t RunTimeStatistics::getLastRunTime(UBaseType_t taskNumber) const
+{
+    for (size_t i = 0; i < lastNumberOfTasks; i++)
+    {
+        if (lastTaskCounters[i].taskNumber == taskNumber)
+            return lastTaskCounters[i].runTime;
+    }
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint16_t RunTimeStatistics::toLoad(uint32_t part, uint32_t total)
+{
+    if (total == 0)
+        return 0;
+
+    return static_cast<uint16_t>(std::min<uint64_t>(uint64_t{part} * 10000 / total, 10000));
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "IsrProfiler.hpp"
+
+#include "FreeRTOS.h"
+#include "helpers/freertos.hpp"
+#include "task.h"
+#include "timers.h"
+
+#include <array>
+#include <span>
+
+/// CPU load of all tasks and of the interrupt handlers, measured over a window of some seconds
+/// by a timer, and the stack usage of both. The last result is kept in a plain struct, so a
+/// debugger can read it as well.
+class RunTimeStatistics
+{
+public:
+    static constexpr size_t MaximumNumberOfTasks = 16;
+    static constexpr auto WindowLength = 5.0_s;
+
+    /// loads are given in 0.01 %
+    struct TaskLoad
+    {
+        const char *name;
+        uint16_t load;
+        uint16_t stackSize;          // in words
+        uint16_t stackHighWaterMark; // in words
+    };
+
+    struct IsrLoad
+    {
+        uint16_t load;
+        uint32_t calls;
+    };
+
+    /// in words
+    struct StackUsage
+    {
+        uint32_t size;
+        uint32_t highWaterMark;
+    };
+
+    struct HeapUsage
+    {
+        size_t freeBytes;
+        size_t minimumEverFreeBytes;
+    };
+
+    struct Snapshot
+    {
+        std::array<TaskLoad, MaximumNumberOfTasks> tasks;
+        size_t numberOfTasks;
+        std::array<IsrLoad, diagnostics::NumberOfIsrs> isrs;
+        uint16_t cpuLoad;     // everything except idle
+        StackUsage mainStack; // of the interrupt handlers
+        HeapUsage heap;
+    };
+
+    explicit RunTimeStatistics(TimerCallbackFunction_t timerCallback) : timerCallback(timerCallback)
+    {
+        xTimerStart(windowTimer, 0);
+    }
+
+    /// @return false before the first window has passed
+    bool getSnapshot(Snapshot &destination);
+
+    void handleTimer();
+
+private:
+    TimerCallbackFunction_t timerCallback = nullptr;
+    StaticTimer_t windowTimerBuffer{};
+    TimerHandle_t windowTimer{xTimerCreateStatic("statisticsTimer", toOsTicks(WindowLength), pdTRUE, nullptr,
+                                                 timerCallback, &windowTimerBuffer)};
+
+    struct TaskCounter
+    {
+        UBaseType_t taskNumber;
+        uint32_t runTime;
+    };
+
+    std::array<TaskStatus_t, MaximumNumberOfTasks> taskStatusArray{};
+    std::array<TaskCounter, MaximumNumberOfTasks> lastTaskCounters{};
+    size_t lastNumberOfTasks = 0;
+    std::array<diagnostics::IsrProfiler::Counters, diagnostics::NumberOfIsrs> lastIsrCounters{};
+    uint32_t lastTotalRunTime = 0;
+    uint32_t lastCycleCount = 0;
+
+    Snapshot snapshot{};
+    bool isSnapshotValid = false;
+
+    uint32_t getLastRunTime(UBaseType_t taskNumber) const;
+    static uint16_t toLoad(uint32_t part, uint32_t total);
+};
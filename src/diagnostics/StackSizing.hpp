@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+/// Stack sizes recommended from measured high-water marks, independent of the hardware.
+namespace diagnostics
+{
+/// reserve for paths which were not taken while measuring, e.g. error handling
+constexpr uint32_t StackMarginPercent = 25;
+
+/// for the exception frame with FPU registers and a nested interrupt
+constexpr uint32_t StackMarginWords = 64;
+
+constexpr uint32_t StackGranularity = 16;
+
+/// @param usedWords peak usage, size minus high-water mark
+/// @return words
+constexpr uint32_t recommendStackSize(uint32_t usedWords)
+{
+    const uint32_t Size = usedWords + usedWords * StackMarginPercent / 100 + StackMarginWords;
+    return (Size + StackGranularity - 1) / StackGranularity * StackGranularity;
+}
+
+static_assert(recommendStackSize(0) == 64);
+static_assert(recommendStackSize(100) == 192);
+} // namespace diagnostics
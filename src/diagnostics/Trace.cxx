@@ -0,0 +1,14 @@
+#include "Trace.hpp"
+#include "TraceHooks.h"
+
+namespace trace
+{
+Buffer buffer;
+volatile bool isPaused = false;
+} // namespace trace
+
+//--------------------------------------------------------------------------------------------------
+extern "C" void traceTaskSwitchedIn(uint32_t taskNumber)
+{
+    trace::record<trace::Event::TaskSwitchedIn>(taskNumber);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CycleCounter.hpp"
+#include "TraceFormat.hpp"
+
+#include <array>
+#include <atomic>
+
+// bit mask of trace::Category, set by the build, e.g. -DTRACE_CATEGORIES=0x1f for everything
+#ifndef TRACE_CATEGORIES
+#define TRACE_CATEGORIES 0
+#endif
+
+/// Records events with a timestamp into a ring buffer in RAM. A record costs a few cycles, so it
+/// can be called from interrupt handlers and from the scheduler. Disabled categories are removed
+/// at compile time and without any category the buffer is not linked at all.
+///
+/// The buffer can be dumped by the debugger, e.g. "dump binary value trace.bin trace::buffer"
+/// in gdb, or printed by the "trace" command of the serial shell.
+namespace trace
+{
+constexpr uint32_t EnabledCategories = TRACE_CATEGORIES;
+constexpr size_t Capacity = 512;
+
+constexpr bool isEnabled(Category category)
+{
+    return (EnabledCategories & toMask(category)) != 0;
+}
+
+struct Buffer
+{
+    Header header;
+    std::array<Record, Capacity> records;
+};
+
+extern Buffer buffer;
+extern volatile bool isPaused;
+
+/// called once at startup
+inline void initialize()
+{
+    if constexpr (EnabledCategories != 0)
+    {
+        buffer.header = {Magic, Capacity, SystemCoreClock, 0};
+        diagnostics::startCycleCounter();
+    }
+}
+
+template <Event TheEvent>
+inline void record(uint16_t argument)
+{
+    if constexpr (isEnabled(getCategory(TheEvent)))
+    {
+        if (isPaused)
+            return;
+
+        // lock free, interrupts may record in between
+        const auto Index = std::atomic_ref<uint32_t>{buffer.header.writeIndex}.fetch_add(1, std::memory_order_relaxed);
+        buffer.records[Index % Capacity] = {diagnostics::getCycleCount(), TheEvent, 0, argument};
+    }
+}
+} // namespace trace
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// Binary format of the trace recorder, shared with the host decoder.
+namespace trace
+{
+enum class Category : uint8_t
+{
+    Scheduler,
+    Isr,
+    I2c,
+    Buttons,
+    Display
+};
+
+/// bit mask for TRACE_CATEGORIES
+constexpr uint32_t toMask(Category category)
+{
+    return 1 << static_cast<uint8_t>(category);
+}
+
+enum class Event : uint8_t
+{
+    TaskSwitchedIn, // argument: task number, see uxTaskGetSystemState()
+    IsrEnter,       // argument: diagnostics::Isr
+    IsrExit,        // argument: diagnostics::Isr
+    I2cStart,       // argument: slave address
+    I2cDone,        // argument: I2cResult
+    ButtonAction,   // argument: button << 8 | util::Button::Action
+    DisplayState,   // argument: StateMachine::DisplayState
+};
+
+struct EventInfo
+{
+    Event event;
+    Category category;
+    const char *name;
+};
+
+constexpr std::array<EventInfo, 7> Events{{
+    {Event::TaskSwitchedIn, Category::Scheduler, "task"},
+    {Event::IsrEnter, Category::Isr, "isr enter"},
+    {Event::IsrExit, Category::Isr, "isr exit"},
+    {Event::I2cStart, Category::I2c, "i2c start"},
+    {Event::I2cDone, Category::I2c, "i2c done"},
+    {Event::ButtonAction, Category::Buttons, "button"},
+    {Event::DisplayState, Category::Display, "display"},
+}};
+
+constexpr Category getCategory(Event event)
+{
+    return Events[static_cast<size_t>(event)].category;
+}
+
+enum class I2cResult : uint16_t
+{
+    Success,
+    Error,
+    Timeout
+};
+
+enum class Button : uint8_t
+{
+    Left,
+    Right,
+    Snooze,
+    BrightnessPlus,
+    BrightnessMinus,
+    CctPlus,
+    CctMinus
+};
+
+constexpr std::array<const char *, 7> ButtonNames{
+    "left", "right", "snooze", "brightnessPlus", "brightnessMinus", "cctPlus", "cctMinus",
+};
+
+struct __attribute__((packed)) Record
+{
+    uint32_t timestamp; // CPU cycles, wraps around
+    Event event;
+    uint8_t reserved;
+    uint16_t argument;
+};
+
+static_assert(sizeof(Record) == 8);
+
+constexpr uint32_t Magic = 0x3143'5254; // "TRC1"
+
+/// header in front of the records, a RAM dump of it can be decoded directly
+struct Header
+{
+    uint32_t magic;
+    uint32_t capacity;       // number of records
+    uint32_t clockFrequency; // of the timestamps in Hz
+    uint32_t writeIndex;     // total number of records, the oldest ones are overwritten
+};
+
+static_assert(sizeof(Header) == 16);
+
+namespace detail
+{
+constexpr bool isEventTableValid()
+{
+    for (size_t i = 0; i < Events.size(); i++)
+    {
+        if (static_cast<size_t>(Events[i].event) != i)
+            return false;
+    }
+    return true;
+}
+
+static_assert(isEventTableValid(), "events have to be sorted by their id");
+} // namespace detail
+} // namespace trace
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Hooks of the trace recorder for the FreeRTOS trace macros, included by FreeRTOSConfig.h */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void traceTaskSwitchedIn(uint32_t taskNumber);
+
+#ifdef __cplusplus
+}
+#endif
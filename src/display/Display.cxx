@@ -1,5 +1,6 @@
 #include "Display.hpp"
 #include "helpers/freertos.hpp"
+#include "rtc/TimeOfDay.hpp"
 #include "sync.hpp"
 
 //-----------------------------------------------------------------
@@ -93,18 +94,29 @@ void Display::strobePeriod()
 
 //-----------------------------------------------------------------
 void Display::sendSegmentBits(uint32_t bits, bool forceLatch, bool enableDots, bool enableUpperBar, bool enableLowerBar)
+{
+    shiftOutBits(encodeSegmentBits(bits, enableDots, enableUpperBar, enableLowerBar));
+
+    if (forceLatch)
+        strobePeriod();
+}
+
+//-----------------------------------------------------------------
+uint32_t Display::encodeSegmentBits(uint32_t bits, bool enableDots, bool enableUpperBar, bool enableLowerBar)
 {
     bits <<= 3; // shift bits to make place for N (upperBar), O_DP (dots) and P_MIN_SEC (lowerBar)
     bits |= ((enableUpperBar & 1) << 2) | ((enableDots & 1) << 1) | (enableLowerBar & 1);
+    return bits;
+}
 
+//-----------------------------------------------------------------
+void Display::shiftOutBits(uint32_t encodedBits)
+{
     for (auto i = 0; i < NumberBitsInShiftRegister; i++)
     {
-        shiftRegisterData.write((bits >> i) & 1);
+        shiftRegisterData.write((encodedBits >> i) & 1);
         clockPeriod();
     }
-
-    if (forceLatch)
-        strobePeriod();
 }
 
 //-----------------------------------------------------------------
@@ -113,11 +125,8 @@ void Display::multiplexingInterrupt()
     if (++gridIndex >= NumberOfGrids)
         gridIndex = 0;
 
-    sendSegmentBits(gridDataArray[gridIndex].segments,       //
-                    false,                                   //
-                    gridDataArray[gridIndex].enableDots,     //
-                    gridDataArray[gridIndex].enableUpperBar, //
-                    gridDataArray[gridIndex].enableLowerBar);
+    // grids are already encoded by publishFrame()
+    shiftOutBits(encodedGridArray[gridIndex]);
     disableAllGrids();
     strobePeriod();
 
@@ -137,6 +146,32 @@ void Display::clearGridDataArray()
     gridDataArray.fill(Display::GridData{});
 }
 
+//--------------------------------------------------------------------------------------------------
+void Display::publishFrame()
+{
+    for (auto i = 0; i < NumberOfGrids; i++)
+    {
+        const auto &Grid = gridDataArray[i];
+        if (Grid == publishedGridDataArray[i])
+            continue;
+
+        publishedGridDataArray[i] = Grid;
+
+        // a single 32bit store is atomic, so the multiplexing interrupt can not see a torn grid
+        encodedGridArray[i] =
+            encodeSegmentBits(Grid.segments, Grid.enableDots, Grid.enableUpperBar, Grid.enableLowerBar);
+        frameStatistics.publishedGrids++;
+    }
+
+    frameStatistics.renderedFrames++;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Display::skipFrame()
+{
+    frameStatistics.skippedFrames++;
+}
+
 //--------------------------------------------------------------------------------------------------
 void Display::setClock(Time clockToShow)
 {
@@ -146,11 +181,14 @@ void Display::setClock(Time clockToShow)
 //--------------------------------------------------------------------------------------------------
 void Display::showClock(bool forceShowDots)
 {
+    const auto &Hour = DecimalDigits[currentTime.hour];
+    const auto &Minute = DecimalDigits[currentTime.minute];
+
     // add '0' to get the ASCII value of the number
-    gridDataArray[1].segments = font.getGlyph((currentTime.hour / 10) + '0');
-    gridDataArray[2].segments = font.getGlyph((currentTime.hour % 10) + '0');
-    gridDataArray[3].segments = font.getGlyph((currentTime.minute / 10) + '0');
-    gridDataArray[4].segments = font.getGlyph((currentTime.minute % 10) + '0');
+    gridDataArray[1].segments = font.getGlyph(Hour[0] + '0');
+    gridDataArray[2].segments = font.getGlyph(Hour[1] + '0');
+    gridDataArray[3].segments = font.getGlyph(Minute[0] + '0');
+    gridDataArray[4].segments = font.getGlyph(Minute[1] + '0');
 
     gridDataArray[2].enableDots = (currentTime.second % 2) == 0 || forceShowDots;
 }
\ No newline at end of file
@@ -34,13 +34,40 @@ public:
         bool enableDots = false;
         bool enableUpperBar = false;
         bool enableLowerBar = false;
+
+        bool operator==(const GridData &) const = default;
+    };
+
+    struct FrameStatistics
+    {
+        uint32_t renderedFrames = 0;
+        uint32_t skippedFrames = 0;
+        uint32_t publishedGrids = 0;
     };
 
+    /// render buffer, its content is not visible until publishFrame() is called
     std::array<GridData, NumberOfGrids> &getGridDataArray()
     {
         return gridDataArray;
     }
 
+    /// re-encode and hand over only grids which differ from the currently shown ones
+    void publishFrame();
+
+    /// count a frame whose inputs did not change, so nothing has to be rendered
+    void skipFrame();
+
+    const FrameStatistics &getFrameStatistics() const
+    {
+        return frameStatistics;
+    }
+
+    /// grids which are currently shown
+    const std::array<GridData, NumberOfGrids> &getPublishedGridDataArray() const
+    {
+        return publishedGridDataArray;
+    }
+
     void setClock(Time clockToShow);
     void showClock(bool forceShowDots = false);
 
@@ -64,10 +91,19 @@ private:
 
     std::array<GridData, NumberOfGrids> gridDataArray{};
 
+    // grids which are currently shown by multiplexing interrupt
+    std::array<GridData, NumberOfGrids> publishedGridDataArray{};
+    std::array<uint32_t, NumberOfGrids> encodedGridArray{};
+
+    FrameStatistics frameStatistics{};
+
     void clockPeriod();
     void strobePeriod();
     void sendSegmentBits(uint32_t bits, bool forceLatch = true, bool enableDots = false, bool enableUpperBar = false,
                          bool enableLowerBar = false);
+    void shiftOutBits(uint32_t encodedBits);
+
+    static uint32_t encodeSegmentBits(uint32_t bits, bool enableDots, bool enableUpperBar, bool enableLowerBar);
 
     void disableAllGrids();
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FreeRTOS.h"
 #include "tim.h"
 
 #include "util/MapValue.hpp"
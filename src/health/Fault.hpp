@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/// System faults in descending priority
+enum class Fault : uint8_t
+{
+    PowerFail,   // supply voltage is below PVD threshold
+    BrownOut,    // last reset was caused by a brown-out
+    I2cBusStuck, // I2C transfer has timed out
+    RtcOffline,  // RTC does not acknowledge
+    StackLow     // stack high water mark of a task is low
+};
+
+constexpr size_t NumberOfFaults = 5;
+
+/// Set of active faults, can be modified by tasks and interrupts
+class FaultSet
+{
+public:
+    /// @return true if the set has changed
+    bool update(Fault fault, bool isActive)
+    {
+        const uint32_t Bit = getBit(fault);
+        const uint32_t Previous = isActive ? bits.fetch_or(Bit) : bits.fetch_and(~Bit);
+        return ((Previous & Bit) != 0) != isActive;
+    }
+
+    bool isActive(Fault fault) const
+    {
+        return (bits & getBit(fault)) != 0;
+    }
+
+    bool isEmpty() const
+    {
+        return bits == 0;
+    }
+
+    /// @return one bit per fault, bit position is the value of Fault
+    uint32_t getBits() const
+    {
+        return bits;
+    }
+
+    std::optional<Fault> getHighestPriorityFault() const
+    {
+        const uint32_t CurrentBits = bits;
+        if (CurrentBits == 0)
+            return {};
+
+        return static_cast<Fault>(std::countr_zero(CurrentBits));
+    }
+
+private:
+    std::atomic<uint32_t> bits{0};
+
+    static constexpr uint32_t getBit(Fault fault)
+    {
+        return 1 << static_cast<uint8_t>(fault);
+    }
+};
+
+/// Receives fault state changes, e.g. from drivers
+class FaultReporter
+{
+public:
+    /// has to be called from task context
+    virtual void reportFault(Fault fault, bool isActive) = 0;
+};
@@ -0,0 +1,144 @@
+#include "FaultIndicator.hpp"
+
+namespace
+{
+constexpr uint32_t PowerOnMarker = 0x5AFE'B007;
+
+// not initialized by startup code, so it keeps its value during a reset
+__attribute__((section(".noinit"))) uint32_t powerOnMarker;
+
+constexpr bool isBlinkCodeTableValid()
+{
+    const auto &BlinkCodes = FaultIndicator::BlinkCodes;
+    for (size_t i = 0; i < BlinkCodes.size(); i++)
+    {
+        if (static_cast<size_t>(BlinkCodes[i].fault) != i || BlinkCodes[i].pulses != i + 1)
+            return false;
+    }
+    return true;
+}
+
+// the class has to be complete for the evaluation
+static_assert(isBlinkCodeTableValid(), "blink codes have to be sorted by priority");
+} // namespace
+
+FaultIndicator::FaultIndicator(StatusLeds &statusLeds, TimerCallbackFunction_t timerCallback)
+    : statusLeds(statusLeds), timerCallback(timerCallback)
+{
+    checkForBrownOut();
+    setupVoltageDetector();
+    restartTimer(faults.isEmpty() ? IdleCheckPeriod : PauseTime);
+}
+
+//--------------------------------------------------------------------------------------------------
+void FaultIndicator::reportFault(Fault fault, bool isActive)
+{
+    // start signaling immediately if the LED is idle
+    if (faults.update(fault, isActive) && isActive && !isSignaling)
+        xTimerChangePeriod(blinkTimer, 1, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+void FaultIndicator::reportFaultFromIsr(Fault fault, bool isActive)
+{
+    if (!faults.update(fault, isActive) || !isActive || isSignaling)
+        return;
+
+    BaseType_t higherPrioTaskWoken = pdFALSE;
+    xTimerChangePeriodFromISR(blinkTimer, 1, &higherPrioTaskWoken);
+    portYIELD_FROM_ISR(higherPrioTaskWoken);
+}
+
+//--------------------------------------------------------------------------------------------------
+void FaultIndicator::handleTimer()
+{
+    if (isLedOn)
+    {
+        statusLeds.ledRedGreen.turnOff();
+        isLedOn = false;
+        remainingPulses--;
+        restartTimer(remainingPulses > 0 ? PulseOffTime : PauseTime);
+        return;
+    }
+
+    if (remainingPulses == 0)
+    {
+        // begin of a new blink code, a fault with higher priority takes over now
+        checkStackWatermarks();
+
+        if (faults.isActive(Fault::BrownOut) && xTaskGetTickCount() > toOsTicks(BrownOutSignalTime))
+            faults.update(Fault::BrownOut, false);
+
+        signaledFault = faults.getHighestPriorityFault();
+        isSignaling = signaledFault.has_value();
+        statusLeds.setFaultSignaling(isSignaling);
+
+        if (!signaledFault)
+        {
+            restartTimer(IdleCheckPeriod);
+            return;
+        }
+
+        remainingPulses = BlinkCodes[static_cast<size_t>(*signaledFault)].pulses;
+    }
+
+    statusLeds.ledRedGreen.setColor(util::led::pwm::DualLedColor::Red);
+    isLedOn = true;
+    restartTimer(PulseOnTime);
+}
+
+//--------------------------------------------------------------------------------------------------
+void FaultIndicator::supplyVoltageInterrupt()
+{
+    // PVDO is set while VDD is below the threshold
+    reportFaultFromIsr(Fault::PowerFail, __HAL_PWR_GET_FLAG(PWR_FLAG_PVDO));
+}
+
+//--------------------------------------------------------------------------------------------------
+void FaultIndicator::checkForBrownOut()
+{
+    // BOR flag is set at power-on as well, but only a brown-out keeps the content of RAM
+    if (__HAL_RCC_GET_FLAG(RCC_FLAG_BORRST) && powerOnMarker == PowerOnMarker)
+        faults.update(Fault::BrownOut, true);
+
+    powerOnMarker = PowerOnMarker;
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+}
+
+//--------------------------------------------------------------------------------------------------
+void FaultIndicator::setupVoltageDetector()
+{
+    // 2.9V threshold for 3.3V supply
+    PWR_PVDTypeDef pvdConfig{};
+    pvdConfig.PVDLevel = PWR_PVDLEVEL_6;
+    pvdConfig.Mode = PWR_PVD_MODE_IT_RISING_FALLING;
+    HAL_PWR_ConfigPVD(&pvdConfig);
+    HAL_PWR_EnablePVD();
+
+    faults.update(Fault::PowerFail, __HAL_PWR_GET_FLAG(PWR_FLAG_PVDO));
+
+    HAL_NVIC_SetPriority(PVD_PVM_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(PVD_PVM_IRQn);
+}
+
+//--------------------------------------------------------------------------------------------------
+void FaultIndicator::checkStackWatermarks()
+{
+    const auto NumberOfTasks = uxTaskGetSystemState(taskStatusArray.data(), taskStatusArray.size(), nullptr);
+    configASSERT(NumberOfTasks > 0); // array is too small
+
+    bool isAnyStackLow = false;
+    for (size_t i = 0; i < NumberOfTasks; i++)
+    {
+        if (taskStatusArray[i].usStackHighWaterMark < StackLowThreshold)
+            isAnyStackLow = true;
+    }
+
+    faults.update(Fault::StackLow, isAnyStackLow);
+}
+
+//--------------------------------------------------------------------------------------------------
+void FaultIndicator::restartTimer(units::si::Time period)
+{
+    xTimerChangePeriod(blinkTimer, toOsTicks(period), 0);
+}
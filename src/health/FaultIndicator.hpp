@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Fault.hpp"
+#include "LED/StatusLeds.hpp"
+
+#include "FreeRTOS.h"
+#include "helpers/freertos.hpp"
+#include "task.h"
+#include "timers.h"
+
+#include <array>
+
+/// Signals the active fault with the highest priority as blink code on the red status LED, which
+/// is owned by the blink code as long as it is signaled.
+/// A code is a number of red pulses followed by a pause. The pulses are stepped by a single
+/// one-shot timer, so no task is needed. Without any fault, the timer only wakes up from time to
+/// time to check the stack watermarks of all tasks.
+class FaultIndicator : public FaultReporter
+{
+public:
+    FaultIndicator(StatusLeds &statusLeds, TimerCallbackFunction_t timerCallback);
+
+    struct BlinkCode
+    {
+        Fault fault;
+        uint8_t pulses;
+    };
+
+    static constexpr std::array<BlinkCode, NumberOfFaults> BlinkCodes{{
+        {Fault::PowerFail, 1},   //
+        {Fault::BrownOut, 2},    //
+        {Fault::I2cBusStuck, 3}, //
+        {Fault::RtcOffline, 4},  //
+        {Fault::StackLow, 5},    //
+    }};
+
+    void reportFault(Fault fault, bool isActive) override;
+    void reportFaultFromIsr(Fault fault, bool isActive);
+
+    const FaultSet &getFaults() const
+    {
+        return faults;
+    }
+
+    /// @return fault whose code is blinking at the moment
+    std::optional<Fault> getSignaledFault() const
+    {
+        return signaledFault;
+    }
+
+    void handleTimer();
+
+    /// called by PVD interrupt
+    void supplyVoltageInterrupt();
+
+private:
+    StatusLeds &statusLeds;
+    TimerCallbackFunction_t timerCallback = nullptr;
+    StaticTimer_t blinkTimerBuffer{};
+    TimerHandle_t blinkTimer{xTimerCreateStatic("faultTimer", 1, pdFALSE, nullptr, timerCallback, &blinkTimerBuffer)};
+
+    static constexpr auto PulseOnTime = 300.0_ms;
+    static constexpr auto PulseOffTime = 400.0_ms;
+    static constexpr auto PauseTime = 2.0_s;
+    static constexpr auto IdleCheckPeriod = 10.0_s;
+
+    /// a brown-out is not active anymore, so it is only signaled for a while after reset
+    static constexpr auto BrownOutSignalTime = 60.0_s;
+
+    static constexpr uint16_t StackLowThreshold = 32; // in words
+    static constexpr size_t MaximumNumberOfTasks = 16;
+
+    FaultSet faults;
+    std::optional<Fault> signaledFault;
+    volatile bool isSignaling = false;
+    bool isLedOn = false;
+    uint8_t remainingPulses = 0;
+
+    std::array<TaskStatus_t, MaximumNumberOfTasks> taskStatusArray{};
+
+    void checkForBrownOut();
+    void setupVoltageDetector();
+    void checkStackWatermarks();
+    void restartTimer(units::si::Time period);
+};
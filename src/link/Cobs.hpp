@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// Consistent Overhead Byte Stuffing removes all zeros from a frame, so zero can delimit frames.
+/// The overhead is one byte per 254 bytes of data.
+namespace cobs
+{
+constexpr size_t getMaximumEncodedSize(size_t length)
+{
+    return length + length / 254 + 1;
+}
+
+/// @return length of the encoded data, 0 if the output buffer is too small
+constexpr size_t encode(std::span<const uint8_t> data, std::span<uint8_t> output)
+{
+    if (output.size() < getMaximumEncodedSize(data.size()))
+        return 0;
+
+    size_t codeIndex = 0;
+    size_t outputIndex = 1;
+    uint8_t code = 1;
+
+    for (const auto Byte : data)
+    {
+        if (Byte != 0)
+        {
+            output[outputIndex++] = Byte;
+            code++;
+        }
+
+        if (Byte == 0 || code == 0xFF)
+        {
+            output[codeIndex] = code;
+            codeIndex = outputIndex++;
+            code = 1;
+        }
+    }
+
+    output[codeIndex] = code;
+    return outputIndex;
+}
+
+/// Decodes byte by byte, so frames can be decoded straight out of a receive buffer, even if they
+/// are split into several chunks. The delimiting zeros must not be passed.
+class Decoder
+{
+public:
+    explicit Decoder(std::span<uint8_t> output) : output(output) {};
+
+    void reset()
+    {
+        length = 0;
+        remainingBlockLength = 0;
+        isZeroPending = false;
+        isOverflowed = false;
+        isEmpty = true;
+    }
+
+    void feed(uint8_t byte)
+    {
+        isEmpty = false;
+
+        if (remainingBlockLength != 0)
+        {
+            append(byte);
+            remainingBlockLength--;
+            return;
+        }
+
+        // code byte, the zero of the previous block is only written if more data follows
+        if (isZeroPending)
+            append(0);
+
+        remainingBlockLength = byte - 1;
+        isZeroPending = byte != 0xFF;
+    }
+
+    /// @return false if no byte was fed since the last reset
+    bool hasStarted() const
+    {
+        return !isEmpty;
+    }
+
+    /// @return decoded frame, empty if the frame is truncated or too long
+    std::span<const uint8_t> finish() const
+    {
+        if (isEmpty || isOverflowed || remainingBlockLength != 0)
+            return {};
+
+        return output.first(length);
+    }
+
+private:
+    std::span<uint8_t> output;
+    size_t length = 0;
+    uint8_t remainingBlockLength = 0;
+    bool isZeroPending = false;
+    bool isOverflowed = false;
+    bool isEmpty = true;
+
+    void append(uint8_t byte)
+    {
+        if (length == output.size())
+        {
+            isOverflowed = true;
+            return;
+        }
+        output[length++] = byte;
+    }
+};
+
+namespace detail
+{
+constexpr bool isEncodingValid()
+{
+    const uint8_t Data[] = {0x11, 0x00, 0x00, 0x22, 0x33, 0x00};
+    const uint8_t Expected[] = {0x02, 0x11, 0x01, 0x03, 0x22, 0x33, 0x01};
+
+    uint8_t encoded[cobs::getMaximumEncodedSize(sizeof(Data))]{};
+    if (encode(Data, encoded) != sizeof(Expected))
+        return false;
+
+    for (size_t i = 0; i < sizeof(Expected); i++)
+    {
+        if (encoded[i] != Expected[i])
+            return false;
+    }
+    return true;
+}
+
+static_assert(isEncodingValid(), "COBS encoding has to match the reference example");
+} // namespace detail
+} // namespace cobs
@@ -0,0 +1,131 @@
+#include "LinkEndpoint.hpp"
+#include "settings/Crc16.hpp"
+
+#include <algorithm>
+
+namespace esp
+{
+bool LinkEndpoint::send(MessageType type, std::span<const uint8_t> payload, uint32_t now)
+{
+    if (isAwaitingAck || payload.size() > MaximumPayload)
+        return false;
+
+    inFlightSequence = nextSequence++;
+    txFrameLength = encodeFrame(type, inFlightSequence, payload, txFrame);
+
+    isAwaitingAck = true;
+    lastTransmitTime = now;
+    retries = 0;
+
+    transport.writeFrame({txFrame.data(), txFrameLength});
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool LinkEndpoint::finishFrame()
+{
+    const bool HasStarted = decoder.hasStarted();
+    const auto Frame = decoder.finish();
+    decoder.reset();
+
+    // two delimiters in a row are no error
+    if (!HasStarted)
+        return false;
+
+    if (Frame.size() < HeaderSize + CrcSize)
+    {
+        statistics.invalidFrames++;
+        return false;
+    }
+
+    const auto Content = Frame.first(Frame.size() - CrcSize);
+    const uint16_t Crc = Frame[Frame.size() - 2] | Frame[Frame.size() - 1] << 8;
+
+    if (Crc != calculateCrc16(Content))
+    {
+        statistics.invalidFrames++;
+        return false;
+    }
+
+    statistics.receivedFrames++;
+
+    const auto Type = static_cast<MessageType>(Content[0]);
+    const uint8_t Sequence = Content[1];
+    const auto Payload = Content.subspan(HeaderSize);
+
+    if (Type == MessageType::Ack)
+    {
+        if (isAwaitingAck && !Payload.empty() && Payload[0] == inFlightSequence)
+            isAwaitingAck = false;
+
+        return true;
+    }
+
+    // the ack may have been lost, so a repetition is acked again
+    sendAck(Sequence);
+
+    if (hasReceivedOnce && Sequence == lastReceivedSequence)
+    {
+        statistics.duplicates++;
+        return true;
+    }
+
+    hasReceivedOnce = true;
+    lastReceivedSequence = Sequence;
+    handler.handleMessage(Type, Payload);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void LinkEndpoint::update(uint32_t now)
+{
+    if (!isAwaitingAck || now - lastTransmitTime < retransmitTimeout)
+        return;
+
+    if (retries == MaximumRetries)
+    {
+        isAwaitingAck = false;
+        statistics.lostMessages++;
+        return;
+    }
+
+    retries++;
+    statistics.retransmissions++;
+    lastTransmitTime = now;
+    transport.writeFrame({txFrame.data(), txFrameLength});
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t LinkEndpoint::encodeFrame(MessageType type, uint8_t sequence, std::span<const uint8_t> payload,
+                                 std::span<uint8_t> output)
+{
+    std::array<uint8_t, MaximumFrameSize> frame;
+    frame[0] = static_cast<uint8_t>(type);
+    frame[1] = sequence;
+    std::copy(payload.begin(), payload.end(), frame.begin() + HeaderSize);
+
+    const size_t ContentLength = HeaderSize + payload.size();
+    const uint16_t Crc = calculateCrc16({frame.data(), ContentLength});
+    frame[ContentLength] = static_cast<uint8_t>(Crc);
+    frame[ContentLength + 1] = static_cast<uint8_t>(Crc >> 8);
+
+    // leading delimiter terminates any garbage on the line
+    output[0] = 0;
+    const size_t Length = cobs::encode({frame.data(), ContentLength + CrcSize}, output.subspan(1));
+    output[Length + 1] = 0;
+
+    return Length + 2;
+}
+
+//--------------------------------------------------------------------------------------------------
+void LinkEndpoint::sendAck(uint8_t sequence)
+{
+    // sent immediately and never repeated, so the frame in flight stays untouched
+    std::array<uint8_t, MaximumEncodedSize> ackFrame;
+    const Ack Message{sequence};
+    const size_t Length =
+        encodeFrame(MessageType::Ack, 0, {reinterpret_cast<const uint8_t *>(&Message), sizeof(Message)}, ackFrame);
+
+    transport.writeFrame({ackFrame.data(), Length});
+}
+} // namespace esp
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Cobs.hpp"
+#include "LinkMessages.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace esp
+{
+class LinkTransport
+{
+public:
+    /// encoded frame including both delimiters
+    virtual void writeFrame(std::span<const uint8_t> frame) = 0;
+};
+
+class LinkHandler
+{
+public:
+    /// called once per message, duplicates caused by lost acks are filtered
+    virtual void handleMessage(MessageType type, std::span<const uint8_t> payload) = 0;
+};
+
+/// One side of the link to the ESP, the same code runs on both sides.
+///
+/// Frame on the wire: 0x00, COBS(type, sequence number, payload, CRC16), 0x00
+/// The CRC16 (CCITT-FALSE, little endian) covers type, sequence number and payload.
+///
+/// Every message except Ack is acknowledged by the receiver. The sender keeps one message in
+/// flight and repeats it until the ack arrives or the retries are exhausted (stop and wait).
+/// A repeated message has the same sequence number, so the receiver acks it again without
+/// handling it twice.
+///
+/// Received bytes are decoded straight from the receive buffer into the frame buffer, the
+/// handler gets the payload in place.
+class LinkEndpoint
+{
+public:
+    static constexpr size_t MaximumPayload = 32;
+    static constexpr size_t MaximumRetries = 3;
+
+    struct Statistics
+    {
+        uint32_t receivedFrames;
+        uint32_t invalidFrames;
+        uint32_t duplicates;
+        uint32_t retransmissions;
+        uint32_t lostMessages;
+    };
+
+    /// @param retransmitTimeout in units of the time passed to send() and update()
+    LinkEndpoint(LinkTransport &transport, LinkHandler &handler, uint32_t retransmitTimeout)
+        : transport(transport), handler(handler), retransmitTimeout(retransmitTimeout) {};
+
+    /// @return false if the previous message is not acknowledged yet
+    bool send(MessageType type, std::span<const uint8_t> payload, uint32_t now);
+
+    template <typename Message>
+    bool send(const Message &message, uint32_t now)
+    {
+        constexpr size_t Length = std::is_empty_v<Message> ? 0 : sizeof(Message);
+        return send(Message::Type, {reinterpret_cast<const uint8_t *>(&message), Length}, now);
+    }
+
+    /// bytes of a frame without the delimiters
+    void feed(uint8_t byte)
+    {
+        decoder.feed(byte);
+    }
+
+    /// called at the closing delimiter
+    /// @return false if the frame is invalid or empty
+    bool finishFrame();
+
+    /// repeats the message in flight, if its ack is overdue
+    void update(uint32_t now);
+
+    bool isIdle() const
+    {
+        return !isAwaitingAck;
+    }
+
+    const Statistics &getStatistics() const
+    {
+        return statistics;
+    }
+
+    /// copies the payload of a received message, which may be shorter for older peers
+    template <typename Message>
+    static Message decodePayload(std::span<const uint8_t> payload)
+    {
+        Message message{};
+        std::memcpy(&message, payload.data(), std::min(payload.size(), sizeof(Message)));
+        return message;
+    }
+
+private:
+    static constexpr size_t HeaderSize = 2;
+    static constexpr size_t CrcSize = 2;
+    static constexpr size_t MaximumFrameSize = HeaderSize + MaximumPayload + CrcSize;
+    static constexpr size_t MaximumEncodedSize = cobs::getMaximumEncodedSize(MaximumFrameSize) + 2;
+
+    LinkTransport &transport;
+    LinkHandler &handler;
+    uint32_t retransmitTimeout;
+
+    std::array<uint8_t, MaximumFrameSize> rxFrame{};
+    cobs::Decoder decoder{rxFrame};
+    bool hasReceivedOnce = false;
+    uint8_t lastReceivedSequence = 0;
+
+    std::array<uint8_t, MaximumEncodedSize> txFrame{};
+    size_t txFrameLength = 0;
+    uint8_t nextSequence = 0;
+    uint8_t inFlightSequence = 0;
+    bool isAwaitingAck = false;
+    uint32_t lastTransmitTime = 0;
+    size_t retries = 0;
+
+    Statistics statistics{};
+
+    size_t encodeFrame(MessageType type, uint8_t sequence, std::span<const uint8_t> payload,
+                       std::span<uint8_t> output);
+    void sendAck(uint8_t sequence);
+};
+} // namespace esp
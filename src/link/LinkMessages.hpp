@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+/// Messages between the alarm clock and the ESP co-processor. Both sides are little endian,
+/// so the packed structs are the wire format. New fields may only be appended.
+namespace esp
+{
+enum class MessageType : uint8_t
+{
+    Ack,
+    TimeSync,
+    AlarmConfig,
+    LightControl,
+    TelemetryRequest,
+    Telemetry,
+    TimeRequest,
+    TimeResponse,
+};
+
+struct __attribute__((packed)) Ack
+{
+    static constexpr auto Type = MessageType::Ack;
+
+    uint8_t sequenceNumber;
+};
+
+/// ESP to clock, e.g. after a NTP request
+struct __attribute__((packed)) TimeSync
+{
+    static constexpr auto Type = MessageType::TimeSync;
+
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+};
+
+/// ESP to clock
+struct __attribute__((packed)) AlarmConfig
+{
+    static constexpr auto Type = MessageType::AlarmConfig;
+
+    uint8_t alarm; // counted from 1, up to MaximumAlarms of the firmware
+    uint8_t hour;
+    uint8_t minute;
+};
+
+/// ESP to clock
+struct __attribute__((packed)) LightControl
+{
+    static constexpr auto Type = MessageType::LightControl;
+
+    uint8_t isEnabled;
+    uint8_t brightness;        // percent
+    uint16_t colorTemperature; // kelvin
+};
+
+/// ESP to clock, answered by Telemetry. It has no payload.
+struct __attribute__((packed)) TelemetryRequest
+{
+    static constexpr auto Type = MessageType::TelemetryRequest;
+};
+
+/// clock to ESP
+struct __attribute__((packed)) Telemetry
+{
+    static constexpr auto Type = MessageType::Telemetry;
+
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t alarmState;
+    uint8_t brightness;
+    uint16_t colorTemperature;
+    uint32_t faults;
+    uint32_t uptime; // seconds
+};
+
+/// clock to ESP, start of a NTP like exchange
+struct __attribute__((packed)) TimeRequest
+{
+    static constexpr auto Type = MessageType::TimeRequest;
+
+    uint32_t originateTime; // tick count of the clock in milliseconds
+};
+
+/// ESP to clock, server times are UTC in milliseconds since 1970
+struct __attribute__((packed)) TimeResponse
+{
+    static constexpr auto Type = MessageType::TimeResponse;
+
+    uint32_t originateTime; // copied from the request
+    uint64_t receiveTime;   // request has arrived at the ESP
+    uint64_t transmitTime;  // response is sent by the ESP
+    int16_t utcOffset;      // minutes, including daylight saving time
+};
+
+static_assert(sizeof(Ack) == 1 && sizeof(TimeSync) == 3 && sizeof(AlarmConfig) == 3 && sizeof(LightControl) == 4 &&
+                  sizeof(Telemetry) == 15 && sizeof(TimeRequest) == 4 && sizeof(TimeResponse) == 22,
+              "wire format must not change");
+} // namespace esp
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "LinkEndpoint.hpp"
+#include "serial/CommandShell.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace esp
+{
+/// Shares one serial line between the text command shell and the binary link to the ESP.
+/// Text never contains zeros, so everything between two zeros belongs to a link frame.
+/// If a frame turns out to be invalid, its closing zero is taken as the start of the next frame
+/// instead. This resynchronizes after a lost delimiter, as every frame starts with a zero.
+class SerialDemultiplexer
+{
+public:
+    SerialDemultiplexer(CommandShell &shell, LinkEndpoint &link) : shell(shell), link(link) {};
+
+    void feed(std::span<const uint8_t> data)
+    {
+        size_t textStart = 0;
+
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            const auto Byte = data[i];
+
+            if (isInFrame)
+            {
+                if (Byte != 0)
+                    link.feed(Byte);
+
+                else if (link.finishFrame())
+                {
+                    isInFrame = false;
+                    textStart = i + 1;
+                }
+                continue;
+            }
+
+            if (Byte == 0)
+            {
+                // text runs are passed at once
+                shell.feed(data.subspan(textStart, i - textStart));
+                isInFrame = true;
+            }
+        }
+
+        if (!isInFrame && textStart < data.size())
+            shell.feed(data.subspan(textStart));
+    }
+
+private:
+    CommandShell &shell;
+    LinkEndpoint &link;
+    bool isInFrame = false;
+};
+} // namespace esp
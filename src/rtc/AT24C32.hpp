@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace at24c32
+{
+constexpr uint8_t SlaveAddress = 0x57; // 7-bit slave address, A0 to A2 are pulled up on DS3231 modules
+
+constexpr size_t Size = 4096;
+constexpr size_t PageSize = 32;
+
+// a write cycle takes 10 ms at most
+constexpr size_t MaximumPollAttempts = 20;
+} // namespace at24c32
+
+/// Driver for the AT24C32 EEPROM found on most DS3231 modules.
+///
+/// Writes are collected in a buffer of one page. Consecutive writes into the same page are combined
+/// into a single page write, which saves write cycles and wear. The buffer is written when a write
+/// goes to another page, is not adjacent to the buffered bytes or flush() is called.
+/// Reads see buffered bytes, even if they are not written yet.
+///
+/// After a page write the EEPROM does not acknowledge its address until the internal write cycle is
+/// finished. Instead of waiting the worst case time, the next access polls for the acknowledge.
+///
+/// The bus is accessed through beginTransaction() and endTransaction(), so the EEPROM shares it with
+/// the DS3231. The bus type is a template parameter, to use a model of the EEPROM on the host.
+template <typename Bus>
+class AT24C32
+{
+public:
+    /// called between acknowledge polls, e.g. to give the CPU to other tasks
+    using PollDelay = void (*)();
+
+    AT24C32(Bus &bus, PollDelay pollDelay) : bus(bus), pollDelay(pollDelay) {};
+
+    /// @return false if the EEPROM does not acknowledge, e.g. on modules without it
+    bool isPresent()
+    {
+        bus.beginTransaction(at24c32::SlaveAddress);
+        const bool IsReady = waitUntilReady();
+        bus.endTransaction();
+
+        return IsReady;
+    }
+
+    bool read(uint16_t address, std::span<uint8_t> buffer)
+    {
+        if (!isInRange(address, buffer.size()))
+            return false;
+
+        bus.beginTransaction(at24c32::SlaveAddress);
+        const bool IsRead = waitUntilReady() && bus.readFromRegister(address, buffer.data(), buffer.size());
+        bus.endTransaction();
+
+        if (!IsRead)
+            return false;
+
+        // buffered bytes are newer than the EEPROM content
+        for (size_t i = dirtyBegin; i < dirtyEnd; i++)
+        {
+            const size_t BufferedAddress = bufferedPage * at24c32::PageSize + i;
+            if (BufferedAddress >= address && BufferedAddress < address + buffer.size())
+                buffer[BufferedAddress - address] = pageBuffer[i];
+        }
+
+        return true;
+    }
+
+    /// Buffers the data, full pages are written immediately.
+    /// @return false if one of the page writes has failed
+    bool write(uint16_t address, std::span<const uint8_t> data)
+    {
+        if (!isInRange(address, data.size()))
+            return false;
+
+        while (!data.empty())
+        {
+            const size_t Page = address / at24c32::PageSize;
+            const size_t Offset = address % at24c32::PageSize;
+            const size_t Length = std::min(data.size(), at24c32::PageSize - Offset);
+
+            const bool IsAdjacent = Page == bufferedPage && Offset <= dirtyEnd && Offset + Length >= dirtyBegin;
+            if (!IsAdjacent)
+            {
+                if (!flush())
+                    return false;
+
+                bufferedPage = Page;
+                dirtyBegin = Offset;
+                dirtyEnd = Offset;
+            }
+
+            std::copy_n(data.begin(), Length, pageBuffer.begin() + Offset);
+            dirtyBegin = std::min(dirtyBegin, Offset);
+            dirtyEnd = std::max(dirtyEnd, Offset + Length);
+
+            if (dirtyBegin == 0 && dirtyEnd == at24c32::PageSize && !flush())
+                return false;
+
+            address += Length;
+            data = data.subspan(Length);
+        }
+
+        return true;
+    }
+
+    /// writes the buffered bytes, if any
+    /// @return false if the page write has failed, the bytes stay buffered then
+    bool flush()
+    {
+        if (dirtyBegin == dirtyEnd)
+            return true;
+
+        const auto Address = static_cast<uint16_t>(bufferedPage * at24c32::PageSize + dirtyBegin);
+
+        bus.beginTransaction(at24c32::SlaveAddress);
+        const bool IsWritten =
+            waitUntilReady() && bus.writeToRegister(Address, pageBuffer.data() + dirtyBegin, dirtyEnd - dirtyBegin);
+        bus.endTransaction();
+
+        if (!IsWritten)
+            return false;
+
+        dirtyBegin = dirtyEnd = 0;
+        numberOfPageWrites++;
+        return true;
+    }
+
+    /// number of page writes since construction, each of them is one write cycle
+    size_t getNumberOfPageWrites() const
+    {
+        return numberOfPageWrites;
+    }
+
+private:
+    static constexpr size_t NoPage = SIZE_MAX;
+
+    Bus &bus;
+    PollDelay pollDelay = nullptr;
+
+    std::array<uint8_t, at24c32::PageSize> pageBuffer{};
+    size_t bufferedPage = NoPage;
+    size_t dirtyBegin = 0;
+    size_t dirtyEnd = 0;
+
+    size_t numberOfPageWrites = 0;
+
+    /// acknowledge polling, has to be called inside of a transaction
+    bool waitUntilReady()
+    {
+        for (size_t attempt = 0; attempt < at24c32::MaximumPollAttempts; attempt++)
+        {
+            // a current address read is harmless, every access sets the address again
+            uint8_t dummy;
+            if (bus.read(&dummy, 1))
+                return true;
+
+            if (pollDelay != nullptr)
+                pollDelay();
+        }
+        return false;
+    }
+
+    static constexpr bool isInRange(uint16_t address, size_t length)
+    {
+        return address + length <= at24c32::Size;
+    }
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct Date
+{
+    uint8_t day;
+    uint8_t month;
+    uint16_t year;
+    uint8_t dow; // register of the DS3231, its first day is user defined, see calendar::getWeekday()
+};
+
+/// Gregorian calendar of the years the DS3231 counts. Days are numbered from 2000-01-01, so a date
+/// and a time of day are packed into a single instant which is compared like an integer.
+namespace calendar
+{
+constexpr uint16_t FirstYear = 2000;
+constexpr uint16_t LastYear = 2099;
+
+constexpr uint32_t SecondsPerDay = 24 * 60 * 60;
+
+/// seconds since 2000-01-01 00:00:00
+using Instant = uint32_t;
+
+enum class Weekday : uint8_t
+{
+    Monday,
+    Tuesday,
+    Wednesday,
+    Thursday,
+    Friday,
+    Saturday,
+    Sunday
+};
+
+/// of a common year
+constexpr std::array<uint8_t, 12> DaysInMonth = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+/// days from the first of January to the first of each month of a common year
+constexpr std::array<uint16_t, 12> DaysBeforeMonth = []
+{
+    std::array<uint16_t, 12> table{};
+    for (size_t i = 1; i < table.size(); i++)
+        table[i] = table[i - 1] + DaysInMonth[i - 1];
+
+    return table;
+}();
+
+constexpr bool isLeapYear(uint16_t year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+constexpr uint8_t getDaysInMonth(uint16_t year, uint8_t month)
+{
+    return DaysInMonth[month - 1] + (month == 2 && isLeapYear(year) ? 1 : 0);
+}
+
+constexpr bool isValid(const Date &date)
+{
+    return date.year >= FirstYear && date.year <= LastYear && date.month >= 1 && date.month <= 12 &&
+           date.day >= 1 && date.day <= getDaysInMonth(date.year, date.month);
+}
+
+/// @return days since 2000-01-01
+constexpr uint16_t toDayNumber(const Date &date)
+{
+    const uint16_t Years = date.year - FirstYear;
+
+    // 2000 is a leap year and 2100 is out of range, so every fourth year is one
+    const uint16_t LeapDays = (Years + 3) / 4 + (date.month > 2 && isLeapYear(date.year) ? 1 : 0);
+
+    return Years * 365 + LeapDays + DaysBeforeMonth[date.month - 1] + date.day - 1;
+}
+
+/// inverse of toDayNumber(), the day of week register is left at 0
+constexpr Date toDate(uint16_t dayNumber)
+{
+    Date date{1, 1, FirstYear, 0};
+
+    for (uint16_t days = 365 + isLeapYear(date.year); dayNumber >= days; days = 365 + isLeapYear(date.year))
+    {
+        dayNumber -= days;
+        date.year++;
+    }
+
+    while (dayNumber >= getDaysInMonth(date.year, date.month))
+    {
+        dayNumber -= getDaysInMonth(date.year, date.month);
+        date.month++;
+    }
+
+    date.day += dayNumber;
+    return date;
+}
+
+constexpr Weekday getWeekday(uint16_t dayNumber)
+{
+    // 2000-01-01 was a Saturday
+    return static_cast<Weekday>((dayNumber + 5) % 7);
+}
+
+/// the day of week register is counted on like the DS3231 does at midnight
+constexpr Date getNextDay(Date date)
+{
+    date.dow = date.dow % 7 + 1;
+
+    if (date.day < getDaysInMonth(date.year, date.month))
+    {
+        date.day++;
+        return date;
+    }
+
+    date.day = 1;
+    if (date.month < 12)
+    {
+        date.month++;
+        return date;
+    }
+
+    date.month = 1;
+    date.year++;
+    return date;
+}
+
+constexpr Instant toInstant(uint16_t dayNumber, uint32_t secondsSinceMidnight)
+{
+    return dayNumber * SecondsPerDay + secondsSinceMidnight;
+}
+
+constexpr uint16_t getDayNumber(Instant instant)
+{
+    return instant / SecondsPerDay;
+}
+
+static_assert(!isLeapYear(2023) && isLeapYear(2024) && isLeapYear(2000) && !isLeapYear(2100));
+static_assert(getDaysInMonth(2024, 2) == 29 && getDaysInMonth(2023, 2) == 28);
+static_assert(toDayNumber({1, 3, 2000, 0}) == 60 && toDayNumber({1, 1, 2001, 0}) == 366);
+static_assert(toDayNumber({31, 12, LastYear, 0}) == 36524);
+static_assert(getWeekday(toDayNumber({17, 5, 2024, 0})) == Weekday::Friday);
+static_assert(toDayNumber(toDate(8903)) == 8903 && toDate(8903).month == 5 && toDate(8903).day == 17);
+static_assert(toDayNumber(getNextDay({29, 2, 2024, 0})) == toDayNumber({1, 3, 2024, 0}));
+static_assert(getNextDay({31, 12, 2024, 7}).year == 2025 && getNextDay({31, 12, 2024, 7}).dow == 1);
+} // namespace calendar
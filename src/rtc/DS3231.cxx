@@ -1,7 +1,5 @@
 #include "DS3231.hpp"
 
-static const uint8_t dim[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-
 using namespace ds3231;
 
 //--------------------------------------------------------------------------------------------------
@@ -120,6 +118,27 @@ bool DS3231::setAlarm1(const Time &newAlarmTime)
     return wasSuccessful;
 }
 
+//--------------------------------------------------------------------------------------------------
+bool DS3231::setAlarm1(const Time &newAlarmTime, uint8_t date)
+{
+    if (date < 1 || date > 31)
+        return false;
+
+    constexpr auto NumberOfBytes = 4;
+    uint8_t dataToWrite[NumberOfBytes] = {
+        decToBcd(newAlarmTime.second), //
+        decToBcd(newAlarmTime.minute), //
+        decToBcd(newAlarmTime.hour),   //
+        decToBcd(date),                // A1M4 and DY/DT cleared
+    };
+
+    accessor.beginTransaction(SlaveAddress);
+    bool wasSuccessful = accessor.writeToRegister(Register::Alarm1_Seconds, dataToWrite, NumberOfBytes);
+    accessor.endTransaction();
+
+    return wasSuccessful;
+}
+
 //--------------------------------------------------------------------------------------------------
 std::optional<Time> DS3231::getAlarm1()
 {
@@ -265,6 +284,32 @@ std::optional<float> DS3231::getTemperature()
     return decimalPart + (fractionPart * 0.25f);
 }
 
+//--------------------------------------------------------------------------------------------------
+bool DS3231::setAgingOffset(int8_t offset)
+{
+    accessor.beginTransaction(SlaveAddress);
+    bool wasSuccessful = accessor.writeByteToRegister(Register::AgingOffset, static_cast<uint8_t>(offset));
+    accessor.endTransaction();
+
+    // the new offset is applied with the next temperature conversion
+    return wasSuccessful && forceTemperatureUpdate();
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<int8_t> DS3231::getAgingOffset()
+{
+    uint8_t data = 0;
+
+    accessor.beginTransaction(SlaveAddress);
+    bool transactionResult = accessor.readByteFromRegister(Register::AgingOffset, data);
+    accessor.endTransaction();
+
+    if (!transactionResult)
+        return {};
+
+    return static_cast<int8_t>(data);
+}
+
 //--------------------------------------------------------------------------------------------------
 bool DS3231::enable32KHz(bool enable)
 {
@@ -299,18 +344,6 @@ bool DS3231::setSQWRate(SqwRate rate)
     return wasSuccessful;
 }
 
-//--------------------------------------------------------------------------------------------------
-uint8_t DS3231::decToBcd(uint8_t val)
-{
-    return ((val / 10) << 4) + (val % 10);
-}
-
-//--------------------------------------------------------------------------------------------------
-uint8_t DS3231::bcdToDec(uint8_t val)
-{
-    return ((val >> 4) * 10) + (val & 0b1111);
-}
-
 //--------------------------------------------------------------------------------------------------
 bool DS3231::updateRegister(Register registerName, uint8_t bitPos, bool bitState)
 {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Calendar.hpp"
 #include "I2cAccessor.hpp"
 #include "Time/Time.hpp"
 
@@ -60,6 +61,16 @@ constexpr auto A1F = 0;     // alarm 1 flag
 
 } // namespace status_bits
 
+[[nodiscard]] constexpr uint8_t decToBcd(uint8_t val)
+{
+    return ((val / 10) << 4) + (val % 10);
+}
+
+[[nodiscard]] constexpr uint8_t bcdToDec(uint8_t val)
+{
+    return ((val >> 4) * 10) + (val & 0b1111);
+}
+
 enum class SqwRate : uint8_t
 {
     Freq1Hz = 0,
@@ -70,14 +81,6 @@ enum class SqwRate : uint8_t
 
 } // namespace ds3231
 
-struct Date
-{
-    uint8_t day;
-    uint8_t month;
-    uint16_t year;
-    uint8_t dow;
-};
-
 class DS3231
 {
 public:
@@ -91,6 +94,9 @@ public:
     bool setDOW(uint8_t dow);
 
     bool setAlarm1(const Time &newAlarmTime);
+
+    /// matches only on the given day of the month instead of every day
+    bool setAlarm1(const Time &newAlarmTime, uint8_t date);
     [[nodiscard]] std::optional<Time> getAlarm1();
     bool clearAlarm1Flag();
     [[nodiscard]] std::optional<bool> isAlarm1Triggered();
@@ -105,6 +111,10 @@ public:
     bool forceTemperatureUpdate();
     std::optional<float> getTemperature();
 
+    /// one step is about 0.1 ppm, positive values slow down the oscillator
+    bool setAgingOffset(int8_t offset);
+    [[nodiscard]] std::optional<int8_t> getAgingOffset();
+
     bool enable32KHz(bool enable);
     bool setInterruptOutput(bool enable);
     bool setSQWRate(ds3231::SqwRate rate);
@@ -127,8 +137,5 @@ private:
     std::optional<bool> isAlarmTriggered(Alarm alarm);
     bool setAlarmInterrupt(bool enable, Alarm alarm);
 
-    [[nodiscard]] uint8_t decToBcd(uint8_t val);
-    [[nodiscard]] uint8_t bcdToDec(uint8_t val);
-
     bool updateRegister(ds3231::Register registerName, uint8_t bitPos, bool bitState);
 };
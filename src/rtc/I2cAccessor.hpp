@@ -4,6 +4,8 @@
 #include "i2c.h"
 #include "semphr.h"
 
+#include "diagnostics/Trace.hpp"
+
 class I2cAccessor
 {
 public:
@@ -11,8 +13,8 @@ public:
 
     explicit I2cAccessor(I2C_HandleTypeDef *hi2c) : i2cHandle{hi2c}
     {
-        mutex = xSemaphoreCreateMutex();
-        binary = xSemaphoreCreateBinary();
+        mutex = xSemaphoreCreateMutexStatic(&mutexBuffer);
+        binary = xSemaphoreCreateBinaryStatic(&binaryBuffer);
     }
 
     bool operator==(const I2cAccessor &other) const
@@ -36,7 +38,7 @@ public:
         errorCondition = false;
         HAL_I2C_Master_Receive_IT(i2cHandle, currentAddress << 1, buffer, length);
 
-        const auto semphrSuccess = xSemaphoreTake(binary, Timeout);
+        const auto semphrSuccess = waitForTransfer();
         return !(semphrSuccess == pdFALSE || errorCondition);
     }
 
@@ -49,14 +51,14 @@ public:
                                        reinterpret_cast<uint8_t *>(&registerAddress),
                                        sizeof(RegisterAddress), I2C_FIRST_FRAME);
 
-        auto semphrSuccess = xSemaphoreTake(binary, Timeout);
+        auto semphrSuccess = waitForTransfer();
         if (semphrSuccess == pdFALSE || errorCondition)
             return false;
 
         HAL_I2C_Master_Seq_Receive_IT(i2cHandle, currentAddress << 1,
                                       reinterpret_cast<uint8_t *>(buffer), length, I2C_LAST_FRAME);
 
-        semphrSuccess = xSemaphoreTake(binary, Timeout);
+        semphrSuccess = waitForTransfer();
         return !(semphrSuccess == pdFALSE || errorCondition);
     }
 
@@ -80,7 +82,7 @@ public:
         HAL_I2C_Master_Transmit_IT(i2cHandle, currentAddress << 1, const_cast<uint8_t *>(data),
                                    length);
 
-        auto semphrSuccess = xSemaphoreTake(binary, Timeout);
+        auto semphrSuccess = waitForTransfer();
         return !(semphrSuccess == pdFALSE || errorCondition);
     }
 
@@ -93,14 +95,14 @@ public:
                                        reinterpret_cast<uint8_t *>(&registerAddress),
                                        sizeof(RegisterAddress), I2C_FIRST_AND_NEXT_FRAME);
 
-        auto semphrSuccess = xSemaphoreTake(binary, Timeout);
+        auto semphrSuccess = waitForTransfer();
         if (semphrSuccess == pdFALSE || errorCondition)
             return false;
 
         HAL_I2C_Master_Seq_Transmit_IT(i2cHandle, currentAddress << 1, const_cast<uint8_t *>(data),
                                        length, I2C_LAST_FRAME);
 
-        semphrSuccess = xSemaphoreTake(binary, Timeout);
+        semphrSuccess = waitForTransfer();
         return !(semphrSuccess == pdFALSE || errorCondition);
     }
 
@@ -151,12 +153,36 @@ public:
         return errorCondition;
     }
 
+    /// last transfer has not finished in time, e.g. SDA is held low by a slave
+    bool isBusStuck()
+    {
+        return timeoutCondition;
+    }
+
     static constexpr TickType_t Timeout{pdMS_TO_TICKS(100)};
 
 private:
     I2C_HandleTypeDef *i2cHandle;
     DeviceAddress currentAddress = 0;
+    StaticSemaphore_t mutexBuffer{};
+    StaticSemaphore_t binaryBuffer{};
     SemaphoreHandle_t mutex = nullptr;
     SemaphoreHandle_t binary = nullptr;
     bool errorCondition = false;
+    bool timeoutCondition = false;
+
+    BaseType_t waitForTransfer()
+    {
+        // the transfer has been started just before
+        trace::record<trace::Event::I2cStart>(currentAddress);
+
+        const auto Result = xSemaphoreTake(binary, Timeout);
+        timeoutCondition = Result == pdFALSE;
+
+        const auto TraceResult = timeoutCondition ? trace::I2cResult::Timeout
+                                 : errorCondition ? trace::I2cResult::Error
+                                                  : trace::I2cResult::Success;
+        trace::record<trace::Event::I2cDone>(static_cast<uint16_t>(TraceResult));
+        return Result;
+    }
 };
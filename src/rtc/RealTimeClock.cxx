@@ -5,7 +5,7 @@
 void RealTimeClock::taskMain(void *)
 {
     setupRtcAndAlarms();
-    syncEventGroup.setBits(sync::RtcHasRespondedOnce);
+    syncEventGroup.setBits(synchronization::RtcHasRespondedOnce);
 
     auto lastWakeTime = xTaskGetTickCount();
     while (true)
@@ -25,6 +25,7 @@ void RealTimeClock::setupRtcAndAlarms()
     while (true)
     {
         initRTC();
+        reportBusState();
 
         if (!isRtcOnline())
         {
@@ -33,21 +34,26 @@ void RealTimeClock::setupRtcAndAlarms()
         }
 
         auto timeOptional = rtcModule.getTime();
+        auto dateOptional = rtcModule.getDate();
         auto alarm1Optional = rtcModule.getAlarm1();
         auto alarm2Optional = rtcModule.getAlarm2();
 
-        if (timeOptional && alarm1Optional && alarm2Optional)
+        if (timeOptional && dateOptional && alarm1Optional && alarm2Optional)
         {
-            clockTime = timeOptional.value();
-            alarmTime1 = alarm1Optional.value();
-            alarmTime2 = alarm2Optional.value();
-            wasRtcOnlineOnceBool = true;
+            utcTime = timeOptional.value();
+            if (calendar::isValid(dateOptional.value()))
+            {
+                utcDate = dateOptional.value();
+                utcDayNumber = calendar::toDayNumber(utcDate);
+            }
+            updateLocalTime();
+
+            // the alarms are disabled until they are restored from the settings
+            for (auto &packedAlarm : packedAlarms)
+                packedAlarm = Alarm{}.pack();
 
-            // cap alarm minutes to factor 5
-            alarmTime1.minute -= (alarmTime1.minute % 5);
-            alarmTime2.minute -= (alarmTime2.minute % 5);
-            writeAlarmTime1(alarmTime1);
-            writeAlarmTime2(alarmTime2);
+            formerAlarmTimes = {alarm1Optional.value(), alarm2Optional.value()};
+            wasRtcOnlineOnceBool = true;
 
             return;
         }
@@ -58,45 +64,147 @@ void RealTimeClock::setupRtcAndAlarms()
 void RealTimeClock::fetchClockTime()
 {
     auto timeValueOptional = rtcModule.getTime();
+    reportBusState();
+
+    const TimeOfDay PreviousTime{utcTime};
 
     if (timeValueOptional)
-        clockTime = timeValueOptional.value();
+        utcTime = timeValueOptional.value();
     else
     {
-        // ToDo: error handling (e.g. flag for state machine)
-
         // increment seconds as fallback
-        clockTime.addSeconds(1);
+        utcTime.addSeconds(1);
+    }
+
+    // the date changes only at midnight or if it is written
+    const bool HasDayPassed = TimeOfDay(utcTime) < PreviousTime;
+    if (HasDayPassed || isDateWritten.exchange(false))
+        fetchDate(HasDayPassed);
+
+    updateLocalTime();
+}
+
+//--------------------------------------------------------------------------------------------------
+void RealTimeClock::fetchDate(bool hasDayPassed)
+{
+    auto dateOptional = rtcModule.getDate();
+
+    if (dateOptional && calendar::isValid(dateOptional.value()))
+        utcDate = dateOptional.value();
+
+    else if (hasDayPassed)
+    {
+        // count on as fallback, like the seconds
+        utcDate = calendar::getNextDay(utcDate);
     }
+
+    utcDayNumber = calendar::toDayNumber(utcDate);
+    schedule.invalidate();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The offset is cached by the time zone until the next transition, so the local time costs a
+/// comparison each second and the local date a conversion each day.
+void RealTimeClock::updateLocalTime()
+{
+    xSemaphoreTake(localTimeMutex, portMAX_DELAY);
+
+    if (const int16_t Offset = standardOffset; Offset != timeZone.getStandardOffset())
+    {
+        timeZone = TimeZone(Offset);
+        schedule.setTimeZone(timeZone);
+    }
+
+    utcInstant = calendar::toInstant(utcDayNumber, TimeOfDay(utcTime).getSecondsSinceMidnight());
+    const auto LocalTime = timeZone.toLocal(utcInstant);
+
+    clockTime = TimeOfDay::fromSeconds(LocalTime % calendar::SecondsPerDay).toTime();
+
+    if (const auto LocalDay = calendar::getDayNumber(LocalTime); LocalDay != dayNumber)
+    {
+        dayNumber = LocalDay;
+        date = calendar::toDate(LocalDay);
+        date.dow = static_cast<uint8_t>(calendar::getWeekday(LocalDay)) + 1;
+    }
+
+    xSemaphoreGive(localTimeMutex);
 }
 
 //--------------------------------------------------------------------------------------------------
 void RealTimeClock::checkIfAlarmShouldTrigger()
 {
-    if (alarmState != AlarmState::Off)
+    if (isScheduleChanged.exchange(false))
+        updateSchedule();
+
+    const auto DueAlarm = schedule.poll(utcInstant);
+
+    writeBackAlarms();
+    programHardwareAlarm();
+
+    // a sunrise which starts during another alarm is skipped
+    if (!DueAlarm || alarmState != AlarmState::Off)
         return;
 
-    // lambda function to check if give alarm time matchs current time
-    auto checkAlarm = [this](Time &&alarmTime)
-    { return clockTime.hour == alarmTime.hour && clockTime.minute == alarmTime.minute; };
+    triggeredAlarm = *DueAlarm;
+    alarmState = AlarmState::Sunrise;
+}
 
-    static const Time HalfHourBeforeAlarm{"00:30"};
-    bool alarm1Triggered = checkAlarm(alarmTime1 - HalfHourBeforeAlarm) &&
-                           (alarmMode == AlarmMode::Alarm1 || alarmMode == AlarmMode::Both);
+//--------------------------------------------------------------------------------------------------
+void RealTimeClock::updateSchedule()
+{
+    for (uint8_t i = 0; i < MaximumAlarms; i++)
+    {
+        scheduledAlarms[i] = packedAlarms[i];
+        schedule.setAlarm(i, Alarm::unpack(scheduledAlarms[i]).value_or(Alarm{}));
+    }
 
-    bool alarm2Triggered = checkAlarm(alarmTime2 - HalfHourBeforeAlarm) &&
-                           (alarmMode == AlarmMode::Alarm2 || alarmMode == AlarmMode::Both);
+    schedule.setSwitchedOn(alarmsEnabled);
+}
 
-    if (alarm1Triggered || alarm2Triggered)
+//--------------------------------------------------------------------------------------------------
+/// an alarm which has been changed by another task in the meantime is left as it is
+void RealTimeClock::writeBackAlarms()
+{
+    const auto ChangedAlarms = schedule.takeChangedAlarms();
+
+    for (uint8_t i = 0; i < MaximumAlarms; i++)
     {
-        if (isAlarmAlreadyTriggered)
-            return;
+        if ((ChangedAlarms & (1U << i)) == 0)
+            continue;
+
+        const auto NewValue = schedule.getAlarm(i).pack();
+        if (packedAlarms[i].compare_exchange_strong(scheduledAlarms[i], NewValue))
+            scheduledAlarms[i] = NewValue;
+    }
+}
 
-        isAlarmAlreadyTriggered = true;
-        alarmState = AlarmState::Sunrise;
+//--------------------------------------------------------------------------------------------------
+/// The alarm registers are written only if the earliest sunrise start has changed. The flag of the
+/// former alarm is cleared, so the interrupt output is released again. The starts are UTC like
+/// the registers of the time.
+void RealTimeClock::programHardwareAlarm()
+{
+    if (areFormerAlarmRegistersKept)
+        return;
+
+    const auto NextTrigger = schedule.getNextTrigger();
+    const auto NextStart = NextTrigger ? std::optional(NextTrigger->sunriseStart) : std::nullopt;
+
+    if (isAlarmProgrammed && NextStart == programmedAlarm)
+        return;
+
+    bool wasSuccessful = rtcModule.clearAlarm1Flag();
+    if (NextStart)
+    {
+        const auto Day = calendar::toDate(calendar::getDayNumber(*NextStart));
+        const auto Start = TimeOfDay::fromSeconds(*NextStart % calendar::SecondsPerDay).toTime();
+        wasSuccessful = wasSuccessful && rtcModule.setAlarm1(Start, Day.day) && rtcModule.setAlarm1Interrupt(true);
     }
     else
-        isAlarmAlreadyTriggered = false;
+        wasSuccessful = wasSuccessful && rtcModule.setAlarm1Interrupt(false);
+
+    isAlarmProgrammed = wasSuccessful;
+    programmedAlarm = NextStart;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -108,6 +216,14 @@ void RealTimeClock::initRTC()
     rtcModule.clearAlarm2Flag();
 }
 
+//--------------------------------------------------------------------------------------------------
+/// has to be called after a transfer, missing acknowledge and timeout are distinguished
+void RealTimeClock::reportBusState()
+{
+    faultReporter.reportFault(Fault::I2cBusStuck, i2cAccessor.isBusStuck());
+    faultReporter.reportFault(Fault::RtcOffline, !isRtcOnline());
+}
+
 //--------------------------------------------------------------------------------------------------
 bool RealTimeClock::isRtcOnline()
 {
@@ -123,43 +239,172 @@ bool RealTimeClock::wasRtcOnlineOnce()
 //--------------------------------------------------------------------------------------------------
 Time RealTimeClock::getClockTime() const
 {
-    return clockTime;
+    xSemaphoreTake(localTimeMutex, portMAX_DELAY);
+    const auto ClockTime = clockTime;
+    xSemaphoreGive(localTimeMutex);
+
+    return ClockTime;
 }
 
 //--------------------------------------------------------------------------------------------------
-Time RealTimeClock::getAlarmTime1()
+Date RealTimeClock::getDate() const
 {
-    auto timeOptional = rtcModule.getAlarm1();
-    if (timeOptional)
-        alarmTime1 = timeOptional.value();
+    xSemaphoreTake(localTimeMutex, portMAX_DELAY);
+    const auto LocalDate = date;
+    xSemaphoreGive(localTimeMutex);
 
-    return alarmTime1;
+    return LocalDate;
 }
 
 //--------------------------------------------------------------------------------------------------
-Time RealTimeClock::getAlarmTime2()
+bool RealTimeClock::writeClockTime(Time &newClockTime)
 {
-    auto timeOptional = rtcModule.getAlarm2();
-    if (timeOptional)
-        alarmTime2 = timeOptional.value();
+    xSemaphoreTake(localTimeMutex, portMAX_DELAY);
+    const auto LocalTime = calendar::toInstant(dayNumber, TimeOfDay(newClockTime).getSecondsSinceMidnight());
+    const auto UtcTime = timeZone.toUtc(LocalTime);
+    xSemaphoreGive(localTimeMutex);
 
-    return alarmTime2;
+    return writeUtcTime(UtcTime);
 }
 
 //--------------------------------------------------------------------------------------------------
-bool RealTimeClock::writeAlarmTime1(Time &newAlarmTime)
+bool RealTimeClock::writeDate(const Date &newDate)
 {
-    return rtcModule.setAlarm1(newAlarmTime);
+    if (!calendar::isValid(newDate))
+        return false;
+
+    xSemaphoreTake(localTimeMutex, portMAX_DELAY);
+    const auto LocalTime =
+        calendar::toInstant(calendar::toDayNumber(newDate), TimeOfDay(clockTime).getSecondsSinceMidnight());
+    const auto UtcTime = timeZone.toUtc(LocalTime);
+    xSemaphoreGive(localTimeMutex);
+
+    return writeUtcTime(UtcTime);
 }
 
 //--------------------------------------------------------------------------------------------------
-bool RealTimeClock::writeAlarmTime2(Time &newAlarmTime)
+calendar::Instant RealTimeClock::getUtcInstant() const
 {
-    return rtcModule.setAlarm2(newAlarmTime);
+    return utcInstant;
 }
 
 //--------------------------------------------------------------------------------------------------
-bool RealTimeClock::writeClockTime(Time &newClockTime)
+bool RealTimeClock::writeUtcTime(calendar::Instant newTime)
+{
+    const auto DayNumber = calendar::getDayNumber(newTime);
+    const auto NewDate = calendar::toDate(DayNumber);
+    if (!calendar::isValid(NewDate))
+        return false;
+
+    const auto Weekday = calendar::getWeekday(DayNumber);
+    if (!rtcModule.setTime(TimeOfDay::fromSeconds(newTime % calendar::SecondsPerDay).toTime()) ||
+        !rtcModule.setDate(NewDate.day, NewDate.month, NewDate.year) ||
+        !rtcModule.setDOW(static_cast<uint8_t>(Weekday) + 1))
+        return false;
+
+    isDateWritten = true;
+    isScheduleChanged = true;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool RealTimeClock::convertLocalTimeToUtc()
+{
+    // read again, the fetched time may be a second old
+    const auto TimeOptional = rtcModule.getTime();
+    const auto DateOptional = rtcModule.getDate();
+    if (!TimeOptional || !DateOptional || !calendar::isValid(DateOptional.value()))
+        return false;
+
+    const auto LocalTime = calendar::toInstant(calendar::toDayNumber(DateOptional.value()),
+                                               TimeOfDay(TimeOptional.value()).getSecondsSinceMidnight());
+
+    xSemaphoreTake(localTimeMutex, portMAX_DELAY);
+    const auto UtcTime = timeZone.toUtc(LocalTime);
+    xSemaphoreGive(localTimeMutex);
+
+    return writeUtcTime(UtcTime);
+}
+
+//--------------------------------------------------------------------------------------------------
+void RealTimeClock::setStandardOffset(int16_t offset)
+{
+    standardOffset = offset;
+}
+
+//--------------------------------------------------------------------------------------------------
+Alarm RealTimeClock::getAlarm(uint8_t index) const
+{
+    configASSERT(index < MaximumAlarms);
+    return Alarm::unpack(packedAlarms[index]).value_or(Alarm{});
+}
+
+//--------------------------------------------------------------------------------------------------
+void RealTimeClock::setAlarm(uint8_t index, const Alarm &newAlarm)
+{
+    configASSERT(index < MaximumAlarms);
+    if (packedAlarms[index].exchange(newAlarm.pack()) != newAlarm.pack())
+        isScheduleChanged = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void RealTimeClock::setAlarmsEnabled(bool enabled)
+{
+    if (alarmsEnabled.exchange(enabled) != enabled)
+        isScheduleChanged = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool RealTimeClock::areAlarmsEnabled() const
+{
+    return alarmsEnabled;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::array<Time, 2> RealTimeClock::getFormerAlarmTimes() const
+{
+    return formerAlarmTimes;
+}
+
+//--------------------------------------------------------------------------------------------------
+void RealTimeClock::keepFormerAlarmRegisters(bool keep)
+{
+    areFormerAlarmRegistersKept = keep;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<RealTimeClock::SecondsEdge> RealTimeClock::waitForSecondsEdge()
+{
+    constexpr auto MaximumPolls = 1100; // one second and some margin for the transfers
+
+    const auto StartTime = rtcModule.getTime();
+    if (!StartTime)
+        return {};
+
+    auto lastWakeTime = xTaskGetTickCount();
+    for (auto poll = 0; poll < MaximumPolls; poll++)
+    {
+        vTaskDelayUntil(&lastWakeTime, 1);
+
+        const auto Now = rtcModule.getTime();
+        if (!Now)
+            return {};
+
+        if (Now->second != StartTime->second)
+            return SecondsEdge{*Now, lastWakeTime};
+    }
+
+    return {};
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<int8_t> RealTimeClock::getAgingOffset()
+{
+    return rtcModule.getAgingOffset();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool RealTimeClock::writeAgingOffset(int8_t offset)
 {
-    return rtcModule.setTime(newClockTime);
+    return rtcModule.setAgingOffset(offset);
 }
\ No newline at end of file
@@ -1,14 +1,23 @@
 #pragma once
 
 #include "DS3231.hpp"
+#include "TimeOfDay.hpp"
+#include "TimeZone.hpp"
+#include "alarm/AlarmSchedule.hpp"
+#include "health/Fault.hpp"
 #include "wrappers/Task.hpp"
 
+#include "semphr.h"
+
+#include <atomic>
+
 class RealTimeClock : public util::wrappers::TaskWithMemberFunctionBase
 {
 public:
-    RealTimeClock(I2cAccessor &i2cAccessor)
+    RealTimeClock(I2cAccessor &i2cAccessor, FaultReporter &faultReporter)
         : TaskWithMemberFunctionBase("rtcTask", 256, osPriorityBelowNormal5), //
-          i2cAccessor(i2cAccessor) {};
+          i2cAccessor(i2cAccessor),                                           //
+          faultReporter(faultReporter) {};
 
     enum class AlarmState
     {
@@ -18,25 +27,57 @@ public:
         Snooze
     };
 
-    enum class AlarmMode
-    {
-        Off,
-        Alarm1,
-        Alarm2,
-        Both
-    };
-
     bool isRtcOnline();
     bool wasRtcOnlineOnce();
 
+    /// local time, the RTC keeps UTC
     Time getClockTime() const;
-    Time getAlarmTime1();
-    Time getAlarmTime2();
+    Date getDate() const;
 
-    bool writeAlarmTime1(Time &newAlarmTime);
-    bool writeAlarmTime2(Time &newAlarmTime);
+    /// the date is written too, because it may change with the offset to UTC
     bool writeClockTime(Time &newClockTime);
 
+    /// the day of week register is written too, counted from monday
+    bool writeDate(const Date &newDate);
+
+    calendar::Instant getUtcInstant() const;
+    bool writeUtcTime(calendar::Instant newTime);
+
+    /// Older firmware has kept local time in the RTC, which is taken as time of the standard
+    /// offset known so far. Has to be called once only.
+    bool convertLocalTimeToUtc();
+
+    /// @param offset minutes east of UTC without daylight saving time, central european time by default
+    void setStandardOffset(int16_t offset);
+
+    /// @param index 0 ... MaximumAlarms - 1
+    Alarm getAlarm(uint8_t index) const;
+    void setAlarm(uint8_t index, const Alarm &newAlarm);
+
+    /// none of the alarms rings if switched off, but they are kept
+    void setAlarmsEnabled(bool enabled);
+    bool areAlarmsEnabled() const;
+
+    /// Older firmware has kept two alarms in the alarm registers. They are read once at startup,
+    /// alarm 1 may have been programmed with a sunrise start by this firmware already.
+    std::array<Time, 2> getFormerAlarmTimes() const;
+
+    /// The alarm registers are not re-purposed while the alarms taken over from them are not stored.
+    void keepFormerAlarmRegisters(bool keep);
+
+    struct SecondsEdge
+    {
+        Time time;       // new value of the seconds register
+        TickType_t tick; // when it was read first
+    };
+
+    /// Polls the RTC until its seconds register changes, to measure the sub-second phase of the RTC.
+    /// It blocks for one second at most, the resolution is one tick plus the I2C transfer.
+    std::optional<SecondsEdge> waitForSecondsEdge();
+
+    std::optional<int8_t> getAgingOffset();
+    bool writeAgingOffset(int8_t offset);
+
     void setAlarmState(AlarmState newState)
     {
         alarmState = newState;
@@ -47,14 +88,10 @@ public:
         return alarmState;
     }
 
-    void setAlarmMode(AlarmMode newMode)
+    /// @return index of the alarm which has started the current or last alarm sequence
+    uint8_t getTriggeredAlarm()
     {
-        alarmMode = newMode;
-    }
-
-    AlarmMode getAlarmMode()
-    {
-        return alarmMode;
+        return triggeredAlarm;
     }
 
 protected:
@@ -62,21 +99,57 @@ protected:
 
 private:
     I2cAccessor &i2cAccessor;
+    FaultReporter &faultReporter;
     DS3231 rtcModule{i2cAccessor};
 
     bool wasRtcOnlineOnceBool = false;
 
+    // registers of the DS3231
+    Time utcTime;
+    Date utcDate{1, 1, calendar::FirstYear, 1};
+    uint16_t utcDayNumber = 0;
+    calendar::Instant utcInstant = 0;
+
+    TimeZone timeZone;
+    std::atomic<int16_t> standardOffset = TimeZone::CentralEuropeanTime;
+
+    // the local date is converted only when the local day changes
     Time clockTime;
-    Time alarmTime1;
-    Time alarmTime2;
+    Date date{1, 1, calendar::FirstYear, 1};
+    uint16_t dayNumber = UINT16_MAX;
+
+    // The RTC task updates the local time and the time zone, other tasks read them and convert
+    // local time back to UTC. A clock set must not combine the day of one with the offset of another.
+    StaticSemaphore_t localTimeMutexBuffer{};
+    SemaphoreHandle_t localTimeMutex = xSemaphoreCreateMutexStatic(&localTimeMutexBuffer);
+
+    // The schedule is owned by the RTC task. Other tasks exchange the packed alarms and mark the
+    // schedule as changed, the RTC task writes back changes of one-shot and skipped alarms.
+    AlarmSchedule schedule;
+    std::array<std::atomic<uint32_t>, MaximumAlarms> packedAlarms{};
+    std::array<uint32_t, MaximumAlarms> scheduledAlarms{};
+    std::atomic<bool> alarmsEnabled = true;
+    std::atomic<bool> isScheduleChanged = true;
+    std::atomic<bool> isDateWritten = false;
+
+    std::array<Time, 2> formerAlarmTimes{};
+    std::atomic<bool> areFormerAlarmRegistersKept = false;
+
+    // the earliest sunrise start is programmed into alarm 1 of the DS3231
+    std::optional<calendar::Instant> programmedAlarm;
+    bool isAlarmProgrammed = false;
 
     AlarmState alarmState = AlarmState::Off;
-    AlarmMode alarmMode = AlarmMode::Both;
-
-    bool isAlarmAlreadyTriggered = false;
+    uint8_t triggeredAlarm = 0;
 
     void setupRtcAndAlarms();
     void fetchClockTime();
+    void fetchDate(bool hasDayPassed);
+    void updateLocalTime();
     void checkIfAlarmShouldTrigger();
+    void updateSchedule();
+    void writeBackAlarms();
+    void programHardwareAlarm();
     void initRTC();
+    void reportBusState();
 };
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Time/Time.hpp"
+
+#include <array>
+#include <compare>
+#include <cstdint>
+
+/// tens and ones of 0 ... 59, looked up instead of divided by 10
+constexpr std::array<std::array<uint8_t, 2>, 60> DecimalDigits = []
+{
+    std::array<std::array<uint8_t, 2>, 60> table{};
+    for (uint8_t i = 0; i < table.size(); i++)
+        table[i] = {static_cast<uint8_t>(i / 10), static_cast<uint8_t>(i % 10)};
+
+    return table;
+}();
+
+/// Time of day packed into seconds since midnight, so comparing and offsetting are single integer
+/// operations. Arithmetic wraps around midnight like Time.
+class TimeOfDay
+{
+public:
+    static constexpr uint32_t SecondsPerDay = 24 * 60 * 60;
+
+    constexpr TimeOfDay() = default;
+
+    constexpr TimeOfDay(uint8_t hour, uint8_t minute, uint8_t second = 0)
+        : seconds((hour * 3600U + minute * 60U + second) % SecondsPerDay)
+    {
+    }
+
+    explicit TimeOfDay(const Time &time) : TimeOfDay(time.hour, time.minute, time.second)
+    {
+    }
+
+    static constexpr TimeOfDay fromSeconds(uint32_t secondsSinceMidnight)
+    {
+        TimeOfDay timeOfDay;
+        timeOfDay.seconds = secondsSinceMidnight % SecondsPerDay;
+        return timeOfDay;
+    }
+
+    Time toTime() const
+    {
+        return Time(getHour(), getMinute(), getSecond());
+    }
+
+    constexpr uint32_t getSecondsSinceMidnight() const
+    {
+        return seconds;
+    }
+
+    constexpr uint8_t getHour() const
+    {
+        return seconds / 3600;
+    }
+
+    constexpr uint8_t getMinute() const
+    {
+        return seconds / 60 % 60;
+    }
+
+    constexpr uint8_t getSecond() const
+    {
+        return seconds % 60;
+    }
+
+    constexpr TimeOfDay operator+(TimeOfDay other) const
+    {
+        return fromSeconds(seconds + other.seconds);
+    }
+
+    constexpr TimeOfDay operator-(TimeOfDay other) const
+    {
+        return fromSeconds(seconds + SecondsPerDay - other.seconds);
+    }
+
+    constexpr auto operator<=>(const TimeOfDay &) const = default;
+
+private:
+    uint32_t seconds = 0;
+};
+
+static_assert(TimeOfDay(23, 45) + TimeOfDay(0, 30) == TimeOfDay(0, 15));
+static_assert(TimeOfDay(0, 10) - TimeOfDay(0, 30) == TimeOfDay(23, 40));
+static_assert(TimeOfDay(6, 29, 59) < TimeOfDay(6, 30));
+static_assert(DecimalDigits[TimeOfDay(19, 7).getHour()][0] == 1 && DecimalDigits[TimeOfDay(19, 7).getMinute()][1] == 7);
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "Calendar.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+/// Daylight saving time by the EU rules: it begins on the last Sunday of March and ends on the last
+/// Sunday of October, both at 01:00 UTC. All EU time zones change at the same instant, so a single
+/// table of transitions serves each standard offset.
+namespace dst
+{
+constexpr uint16_t FirstYear = 2024;
+constexpr int16_t Shift = 60; // minutes
+
+constexpr uint16_t getLastSunday(uint16_t year, uint8_t month)
+{
+    const auto LastDay = calendar::toDayNumber({calendar::getDaysInMonth(year, month), month, year, 0});
+    return LastDay - (static_cast<uint8_t>(calendar::getWeekday(LastDay)) + 1) % 7;
+}
+
+/// UTC instants, ascending and alternating: begin of daylight saving time, end of it
+constexpr auto Transitions = []
+{
+    std::array<calendar::Instant, 2 * (calendar::LastYear - FirstYear + 1)> table{};
+    for (uint16_t year = FirstYear; year <= calendar::LastYear; year++)
+    {
+        table[2 * (year - FirstYear)] = calendar::toInstant(getLastSunday(year, 3), 60 * 60);
+        table[2 * (year - FirstYear) + 1] = calendar::toInstant(getLastSunday(year, 10), 60 * 60);
+    }
+
+    return table;
+}();
+
+/// @return number of transitions at or before the given instant, odd during daylight saving time
+constexpr size_t countTransitions(calendar::Instant utc)
+{
+    return std::upper_bound(Transitions.begin(), Transitions.end(), utc) - Transitions.begin();
+}
+
+/// @return minutes which daylight saving time adds to the standard offset
+constexpr int16_t getShift(calendar::Instant utc)
+{
+    return countTransitions(utc) % 2 == 1 ? Shift : 0;
+}
+
+static_assert(std::is_sorted(Transitions.begin(), Transitions.end()));
+static_assert(Transitions[0] == calendar::toInstant(calendar::toDayNumber({31, 3, 2024, 0}), 3600));
+static_assert(Transitions[3] == calendar::toInstant(calendar::toDayNumber({26, 10, 2025, 0}), 3600));
+static_assert(Transitions.back() == calendar::toInstant(calendar::toDayNumber({25, 10, 2099, 0}), 3600));
+} // namespace dst
+
+/// Offset of the local time to UTC, which is kept by the RTC. So the clock needs no setting when
+/// daylight saving time begins or ends.
+///
+/// The current offset is looked up once and cached together with the instants it is valid between,
+/// so converting the time every second is a comparison only until the next transition.
+class TimeZone
+{
+public:
+    static constexpr int16_t CentralEuropeanTime = 60;
+
+    /// @param standardOffset minutes east of UTC
+    constexpr explicit TimeZone(int16_t standardOffset = CentralEuropeanTime, bool hasDaylightSaving = true)
+        : standardOffset(standardOffset), hasDaylightSaving(hasDaylightSaving)
+    {
+    }
+
+    constexpr int16_t getStandardOffset() const
+    {
+        return standardOffset;
+    }
+
+    /// @return minutes to add to UTC, searched in the table of transitions
+    constexpr int16_t findOffset(calendar::Instant utc) const
+    {
+        return standardOffset + (hasDaylightSaving ? dst::getShift(utc) : 0);
+    }
+
+    /// like findOffset(), but searched only if the instant is out of the cached interval
+    constexpr int16_t getOffset(calendar::Instant utc)
+    {
+        if (utc < validFrom || utc >= validUntil)
+            cacheOffset(utc);
+
+        return cachedOffset;
+    }
+
+    constexpr calendar::Instant toLocal(calendar::Instant utc)
+    {
+        return shift(utc, getOffset(utc));
+    }
+
+    /// A local time which is skipped when daylight saving time begins is taken as standard time,
+    /// one which is repeated when it ends is taken as the first of both.
+    constexpr calendar::Instant toUtc(calendar::Instant local) const
+    {
+        const auto AsStandardTime = shift(local, -standardOffset);
+        const auto AsDaylightSavingTime = shift(AsStandardTime, -dst::Shift);
+
+        return hasDaylightSaving && dst::getShift(AsDaylightSavingTime) != 0 ? AsDaylightSavingTime : AsStandardTime;
+    }
+
+private:
+    int16_t standardOffset;
+    bool hasDaylightSaving;
+
+    int16_t cachedOffset = 0;
+    calendar::Instant validFrom = 0;
+    calendar::Instant validUntil = 0; // empty interval, nothing is cached yet
+
+    /// the instants before 2000 and after the range of the RTC are not representable
+    static constexpr calendar::Instant shift(calendar::Instant instant, int32_t minutes)
+    {
+        return std::clamp<int64_t>(static_cast<int64_t>(instant) + minutes * 60, 0, UINT32_MAX);
+    }
+
+    constexpr void cacheOffset(calendar::Instant utc)
+    {
+        cachedOffset = findOffset(utc);
+
+        const auto Count = hasDaylightSaving ? dst::countTransitions(utc) : 0;
+        validFrom = Count == 0 ? 0 : dst::Transitions[Count - 1];
+        validUntil = !hasDaylightSaving || Count == dst::Transitions.size() ? UINT32_MAX : dst::Transitions[Count];
+    }
+};
+
+namespace time_zone_checks
+{
+constexpr calendar::Instant at(Date date, uint8_t hour, uint8_t minute)
+{
+    return calendar::toInstant(calendar::toDayNumber(date), (hour * 60U + minute) * 60U);
+}
+
+constexpr TimeZone Berlin{};
+
+// 01:00 UTC on the last Sunday of March is 02:00 CET and 03:00 CEST
+static_assert(TimeZone(Berlin).toLocal(at({31, 3, 2024, 0}, 0, 59)) == at({31, 3, 2024, 0}, 1, 59));
+static_assert(TimeZone(Berlin).toLocal(at({31, 3, 2024, 0}, 1, 0)) == at({31, 3, 2024, 0}, 3, 0));
+static_assert(TimeZone(Berlin).toLocal(at({27, 10, 2024, 0}, 1, 0)) == at({27, 10, 2024, 0}, 2, 0));
+static_assert(TimeZone(Berlin).toLocal(at({1, 1, 2000, 0}, 0, 0)) == at({1, 1, 2000, 0}, 1, 0));
+
+static_assert(Berlin.toUtc(at({15, 7, 2024, 0}, 12, 0)) == at({15, 7, 2024, 0}, 10, 0));
+static_assert(Berlin.toUtc(at({15, 1, 2025, 0}, 12, 0)) == at({15, 1, 2025, 0}, 11, 0));
+static_assert(Berlin.toUtc(at({31, 3, 2024, 0}, 2, 30)) == at({31, 3, 2024, 0}, 1, 30));  // skipped
+static_assert(Berlin.toUtc(at({27, 10, 2024, 0}, 2, 30)) == at({27, 10, 2024, 0}, 0, 30)); // repeated
+
+static_assert(TimeZone(-300, false).toUtc(at({1, 7, 2024, 0}, 0, 0)) == at({1, 7, 2024, 0}, 5, 0));
+static_assert(TimeZone(-300, false).toLocal(at({1, 1, 2000, 0}, 2, 0)) == 0);
+
+// the cached offset follows the transitions
+static_assert([]
+{
+    TimeZone zone;
+    for (auto utc = at({30, 3, 2024, 0}, 0, 0); utc < at({28, 10, 2024, 0}, 0, 0); utc += 3600)
+    {
+        if (zone.getOffset(utc) != zone.findOffset(utc))
+            return false;
+    }
+
+    return zone.getOffset(at({28, 10, 2024, 0}, 0, 0)) == TimeZone::CentralEuropeanTime;
+}());
+} // namespace time_zone_checks
@@ -0,0 +1,451 @@
+#include "CommandShell.hpp"
+#include "LED/ColorTemperatureTable.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdarg>
+#include <cstdio>
+
+namespace
+{
+// letters of the weekdays from monday on, as in MTWTF--
+constexpr std::string_view WeekdayLetters = "MTWTFSS";
+
+constexpr std::array<const char *, 7> WeekdayNames = {"mon", "tue", "wed", "thu", "fri", "sat", "sun"};
+
+// in the order of vibration::PatternId
+constexpr std::array<std::string_view, 4> PatternNames = {"pulse", "heartbeat", "ramp", "continuous"};
+static_assert(PatternNames.size() == vibration::Patterns.size());
+} // namespace
+
+void CommandShell::feed(std::span<const uint8_t> data)
+{
+    for (const auto Byte : data)
+    {
+        if (Byte == '\r' || Byte == '\n')
+        {
+            // CR LF results in an empty line, which is ignored
+            if (isLineTooLong)
+                print("ERR line too long\n");
+
+            else if (lineLength != 0)
+                execute({line.data(), lineLength});
+
+            lineLength = 0;
+            isLineTooLong = false;
+        }
+        else if (Byte == '\b' || Byte == 0x7F)
+        {
+            if (lineLength != 0)
+                lineLength--;
+        }
+        else if (Byte >= ' ' && Byte < 0x7F)
+        {
+            if (lineLength < line.size())
+                line[lineLength++] = static_cast<char>(Byte);
+            else
+                isLineTooLong = true;
+        }
+        // other control characters and broken bytes are dropped
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void CommandShell::print(const char *format, ...)
+{
+    std::array<char, 96> buffer;
+
+    va_list arguments;
+    va_start(arguments, format);
+    const int Length = std::vsnprintf(buffer.data(), buffer.size(), format, arguments);
+    va_end(arguments);
+
+    if (Length > 0)
+        target.writeOutput({buffer.data(), std::min<size_t>(Length, buffer.size() - 1)});
+}
+
+//--------------------------------------------------------------------------------------------------
+void CommandShell::execute(std::string_view commandLine)
+{
+    std::array<std::string_view, MaximumArguments> arguments;
+    size_t numberOfArguments = 0;
+
+    while (!commandLine.empty())
+    {
+        const auto Start = commandLine.find_first_not_of(' ');
+        if (Start == std::string_view::npos)
+            break;
+
+        commandLine.remove_prefix(Start);
+        const auto End = std::min(commandLine.find(' '), commandLine.size());
+
+        if (numberOfArguments == arguments.size())
+        {
+            print("ERR too many arguments\n");
+            return;
+        }
+
+        arguments[numberOfArguments++] = commandLine.substr(0, End);
+        commandLine.remove_prefix(End);
+    }
+
+    if (numberOfArguments == 0)
+        return;
+
+    const std::string_view Command = arguments[0];
+    const Arguments Parameters{arguments.data() + 1, numberOfArguments - 1};
+    const char *error = nullptr;
+
+    if (Command == "get")
+        error = executeGet(Parameters);
+
+    else if (Command == "set")
+        error = executeSet(Parameters);
+
+    else if (Command == "stats" && Parameters.empty())
+        target.printStats();
+
+    else if (Command == "stacks" && Parameters.empty())
+        target.printStacks();
+
+    else if (Command == "trace" && Parameters.empty())
+        error = target.printTrace() ? nullptr : "tracing disabled";
+
+    else if (Command == "help")
+        printHelp();
+
+    else
+        error = "unknown command";
+
+    if (error != nullptr)
+        print("ERR %s\n", error);
+    else
+        print("OK\n");
+}
+
+//--------------------------------------------------------------------------------------------------
+const char *CommandShell::executeGet(Arguments arguments)
+{
+    if (arguments.empty())
+        return "missing item";
+
+    const std::string_view Item = arguments[0];
+    std::optional<ShellTime> time;
+
+    if (Item == "time" && arguments.size() == 1)
+    {
+        time = target.getTime();
+        if (!time)
+            return "rtc offline";
+
+        print("%02u:%02u:%02u\n", time->hour, time->minute, time->second);
+    }
+    else if (Item == "date" && arguments.size() == 1)
+    {
+        const auto Date = target.getDate();
+        if (!Date)
+            return "rtc offline";
+
+        const auto Weekday = calendar::getWeekday(calendar::toDayNumber(*Date));
+        print("%04u-%02u-%02u %s\n", Date->year, Date->month, Date->day,
+              WeekdayNames[static_cast<uint8_t>(Weekday)]);
+    }
+    else if (Item == "alarm" && arguments.size() == 2)
+    {
+        const auto Index = parseAlarm(arguments[1]);
+        if (!Index)
+            return "invalid alarm";
+
+        const auto TheAlarm = target.getAlarm(*Index);
+        print("%02u:%02u %s %s%s%s\n", TheAlarm.minuteOfDay / 60, TheAlarm.minuteOfDay % 60,
+              formatWeekdays(TheAlarm.weekdays).data(), TheAlarm.isEnabled ? "on" : "off",
+              TheAlarm.isOneShot ? " once" : "", TheAlarm.isSkippingNext ? " skip" : "");
+    }
+    else if (Item == "days" && arguments.size() == 2)
+    {
+        const auto Index = parseAlarm(arguments[1]);
+        if (!Index)
+            return "invalid alarm";
+
+        print("%s\n", formatWeekdays(target.getAlarm(*Index).weekdays).data());
+    }
+    else if (Item == "vibration" && arguments.size() == 2)
+    {
+        const auto Index = parseAlarm(arguments[1]);
+        if (!Index)
+            return "invalid alarm";
+
+        const auto Name = PatternNames[static_cast<size_t>(target.getVibrationPattern(*Index))];
+        print("%.*s\n", static_cast<int>(Name.size()), Name.data());
+    }
+    else if (Item == "snooze" && arguments.size() == 1)
+    {
+        const auto Sequence = target.getAlarmSequence();
+        print("%u %u\n", Sequence.snoozeDuration, Sequence.maximumSnoozeCount);
+    }
+    else if (Item == "autooff" && arguments.size() == 1)
+        print("%u\n", target.getAlarmSequence().autoOffTimeout);
+
+    else if (Item == "brightness" && arguments.size() == 1)
+        print("%u\n", target.getBrightness());
+
+    else if (Item == "cct" && arguments.size() == 1)
+        print("%u\n", target.getColorTemperature());
+
+    else
+        return "unknown item";
+
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+const char *CommandShell::executeSet(Arguments arguments)
+{
+    if (arguments.size() < 2)
+        return "missing value";
+
+    const std::string_view Item = arguments[0];
+
+    if (Item == "time" && arguments.size() == 2)
+    {
+        const auto Time = parseTime(arguments[1], true);
+        if (!Time)
+            return "invalid time";
+
+        if (!target.setTime(*Time))
+            return "rtc offline";
+    }
+    else if (Item == "date" && arguments.size() == 2)
+    {
+        const auto Date = parseDate(arguments[1]);
+        if (!Date)
+            return "invalid date";
+
+        if (!target.setDate(*Date))
+            return "rtc offline";
+    }
+    else if (Item == "alarm" && arguments.size() == 3)
+    {
+        const auto Index = parseAlarm(arguments[1]);
+        if (!Index)
+            return "invalid alarm";
+
+        const auto ChangedAlarm = changeAlarm(target.getAlarm(*Index), arguments[2]);
+        if (!ChangedAlarm)
+            return "invalid alarm";
+
+        target.setAlarm(*Index, *ChangedAlarm);
+    }
+    else if (Item == "days" && arguments.size() == 3)
+    {
+        const auto Index = parseAlarm(arguments[1]);
+        const auto Weekdays = parseWeekdays(arguments[2]);
+        if (!Index || !Weekdays)
+            return "invalid days";
+
+        auto changedAlarm = target.getAlarm(*Index);
+        changedAlarm.weekdays = *Weekdays;
+        target.setAlarm(*Index, changedAlarm);
+    }
+    else if (Item == "vibration" && arguments.size() == 3)
+    {
+        const auto Index = parseAlarm(arguments[1]);
+        const auto Pattern = parsePattern(arguments[2]);
+        if (!Index || !Pattern)
+            return "invalid vibration";
+
+        target.setVibrationPattern(*Index, *Pattern);
+    }
+    else if (Item == "snooze" && (arguments.size() == 2 || arguments.size() == 3))
+    {
+        auto sequence = target.getAlarmSequence();
+        const auto Duration = parseNumber(arguments[1], 1, AlarmSequence::MaximumSnoozeDuration);
+        const auto Count = arguments.size() == 3
+                               ? parseNumber(arguments[2], 0, AlarmSequence::MaximumSnoozeCount)
+                               : std::optional<uint32_t>{sequence.maximumSnoozeCount};
+        if (!Duration || !Count)
+            return "invalid snooze";
+
+        sequence.snoozeDuration = *Duration;
+        sequence.maximumSnoozeCount = *Count;
+        target.setAlarmSequence(sequence);
+    }
+    else if (Item == "autooff" && arguments.size() == 2)
+    {
+        const auto Timeout = parseNumber(arguments[1], 1, AlarmSequence::MaximumAutoOffTimeout);
+        if (!Timeout)
+            return "invalid timeout";
+
+        auto sequence = target.getAlarmSequence();
+        sequence.autoOffTimeout = *Timeout;
+        target.setAlarmSequence(sequence);
+    }
+    else if (Item == "brightness" && arguments.size() == 2)
+    {
+        const auto Brightness = parseNumber(arguments[1], 0, 100);
+        if (!Brightness)
+            return "invalid brightness";
+
+        target.setBrightness(*Brightness);
+    }
+    else if (Item == "cct" && arguments.size() == 2)
+    {
+        const auto Kelvin = parseNumber(arguments[1], cct::WarmKelvin, cct::ColdKelvin);
+        if (!Kelvin)
+            return "invalid color temperature";
+
+        target.setColorTemperature(*Kelvin);
+    }
+    else
+        return "unknown item";
+
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------------------------
+void CommandShell::printHelp()
+{
+    print("get time|date|brightness|cct|snooze|autooff\n");
+    print("get alarm|days|vibration 1..%u\n", MaximumAlarms);
+    print("set time HH:MM[:SS]\n");
+    print("set date YYYY-MM-DD\n");
+    print("set alarm 1..%u HH:MM|on|off|once|daily|skip\n", MaximumAlarms);
+    print("set days 1..%u MTWTFSS\n", MaximumAlarms);
+    print("set brightness 0..100\n");
+    print("set cct %u..%u\n", cct::WarmKelvin, cct::ColdKelvin);
+    print("set snooze 1..%u [0..%u]\n", AlarmSequence::MaximumSnoozeDuration, AlarmSequence::MaximumSnoozeCount);
+    print("set autooff 1..%u\n", AlarmSequence::MaximumAutoOffTimeout);
+    print("set vibration 1..%u pulse|heartbeat|ramp|continuous\n", MaximumAlarms);
+    print("stats\n");
+    print("stacks\n");
+    print("trace\n");
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<uint32_t> CommandShell::parseNumber(std::string_view text, uint32_t minimum, uint32_t maximum)
+{
+    uint32_t value = 0;
+    const auto [End, Error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if (Error != std::errc{} || End != text.data() + text.size() || value < minimum || value > maximum)
+        return {};
+
+    return value;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<ShellTime> CommandShell::parseTime(std::string_view text, bool withSeconds)
+{
+    const auto FirstColon = text.find(':');
+    if (FirstColon == std::string_view::npos)
+        return {};
+
+    const auto SecondColon = text.find(':', FirstColon + 1);
+    if (SecondColon != std::string_view::npos && !withSeconds)
+        return {};
+
+    const auto Hour = parseNumber(text.substr(0, FirstColon), 0, 23);
+    const auto Minute = parseNumber(text.substr(FirstColon + 1, SecondColon - FirstColon - 1), 0, 59);
+    const auto Second = SecondColon == std::string_view::npos ? std::optional<uint32_t>{0}
+                                                              : parseNumber(text.substr(SecondColon + 1), 0, 59);
+
+    if (!Hour || !Minute || !Second)
+        return {};
+
+    return ShellTime{static_cast<uint8_t>(*Hour), static_cast<uint8_t>(*Minute), static_cast<uint8_t>(*Second)};
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<Date> CommandShell::parseDate(std::string_view text)
+{
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-')
+        return {};
+
+    const auto Year = parseNumber(text.substr(0, 4), calendar::FirstYear, calendar::LastYear);
+    const auto Month = parseNumber(text.substr(5, 2), 1, 12);
+    const auto Day = parseNumber(text.substr(8, 2), 1, 31);
+
+    if (!Year || !Month || !Day)
+        return {};
+
+    const Date TheDate{static_cast<uint8_t>(*Day), static_cast<uint8_t>(*Month), static_cast<uint16_t>(*Year), 0};
+    if (!calendar::isValid(TheDate))
+        return {};
+
+    return TheDate;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// @return index of the alarm, the alarms are counted from 1 in commands
+std::optional<uint8_t> CommandShell::parseAlarm(std::string_view text)
+{
+    const auto Number = parseNumber(text, 1, MaximumAlarms);
+    if (!Number)
+        return {};
+
+    return static_cast<uint8_t>(*Number - 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<uint8_t> CommandShell::parseWeekdays(std::string_view text)
+{
+    if (text.size() != WeekdayLetters.size())
+        return {};
+
+    uint8_t weekdays = 0;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] == WeekdayLetters[i] || text[i] == WeekdayLetters[i] - 'A' + 'a')
+            weekdays |= 1U << i;
+
+        else if (text[i] != '-')
+            return {};
+    }
+
+    return weekdays;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<vibration::PatternId> CommandShell::parsePattern(std::string_view text)
+{
+    const auto Name = std::find(PatternNames.begin(), PatternNames.end(), text);
+    if (Name == PatternNames.end())
+        return {};
+
+    return static_cast<vibration::PatternId>(Name - PatternNames.begin());
+}
+
+//--------------------------------------------------------------------------------------------------
+/// a new time enables the alarm and ends skipping, like changing it by the buttons
+std::optional<Alarm> CommandShell::changeAlarm(Alarm alarm, std::string_view change)
+{
+    if (const auto Time = parseTime(change, false))
+    {
+        alarm.minuteOfDay = Time->hour * 60 + Time->minute;
+        alarm.isEnabled = true;
+        alarm.isSkippingNext = false;
+    }
+    else if (change == "on" || change == "off")
+        alarm.isEnabled = change == "on";
+
+    else if (change == "once" || change == "daily")
+        alarm.isOneShot = change == "once";
+
+    else if (change == "skip")
+        alarm.isSkippingNext = true;
+
+    else
+        return {};
+
+    return alarm;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::array<char, 8> CommandShell::formatWeekdays(uint8_t weekdays)
+{
+    std::array<char, WeekdayLetters.size() + 1> days{};
+    for (size_t i = 0; i < WeekdayLetters.size(); i++)
+        days[i] = (weekdays & (1U << i)) != 0 ? WeekdayLetters[i] : '-';
+
+    return days;
+}
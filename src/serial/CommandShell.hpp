@@ -0,0 +1,123 @@
+#pragma once
+
+#include "alarm/Alarm.hpp"
+#include "alarm/AlarmSequence.hpp"
+#include "rtc/Calendar.hpp"
+#include "vibration/VibrationPattern.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+struct ShellTime
+{
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+};
+
+/// Everything the command shell can read or change, implemented by the firmware and by host tools.
+class ShellTarget
+{
+public:
+    virtual void writeOutput(std::string_view text) = 0;
+
+    virtual std::optional<ShellTime> getTime() = 0;
+    virtual bool setTime(const ShellTime &time) = 0;
+
+    virtual std::optional<Date> getDate() = 0;
+    virtual bool setDate(const Date &date) = 0;
+
+    /// @param index 0 ... MaximumAlarms - 1
+    virtual Alarm getAlarm(uint8_t index) = 0;
+    virtual void setAlarm(uint8_t index, const Alarm &alarm) = 0;
+
+    /// snooze and auto-off, the same for all alarms
+    virtual AlarmSequence getAlarmSequence() = 0;
+    virtual void setAlarmSequence(const AlarmSequence &sequence) = 0;
+
+    /// @param index 0 ... MaximumAlarms - 1
+    virtual vibration::PatternId getVibrationPattern(uint8_t index) = 0;
+    virtual void setVibrationPattern(uint8_t index, vibration::PatternId pattern) = 0;
+
+    /// percent
+    virtual uint8_t getBrightness() = 0;
+    virtual void setBrightness(uint8_t brightness) = 0;
+
+    virtual uint16_t getColorTemperature() = 0;
+    virtual void setColorTemperature(uint16_t kelvin) = 0;
+
+    /// one "name: value" line per statistic
+    virtual void printStats() = 0;
+
+    /// size, peak usage and recommended size of each stack
+    virtual void printStacks() = 0;
+
+    /// hex dump of the trace buffer for the host decoder
+    /// @return false if the firmware is built without tracing
+    virtual bool printTrace() = 0;
+};
+
+/// Line oriented command shell for a terminal or another controller. Every command is answered by
+/// its output, followed by "OK" or "ERR <reason>". It does not echo, so terminals need local echo.
+///
+///     get time|date|brightness|cct|autooff
+///     get alarm|days 1..8       alarm: HH:MM MTWTFSS on|off [once] [skip]
+///     get snooze                MINUTES COUNT
+///     get vibration 1..8
+///     set time HH:MM[:SS]
+///     set date YYYY-MM-DD
+///     set alarm 1..8 HH:MM      also enables the alarm
+///     set alarm 1..8 on|off|once|daily|skip
+///     set days 1..8 MTWTFSS     a '-' instead of the letter skips the day, e.g. MTWTF--
+///     set brightness 0..100
+///     set cct 2700..6500
+///     set snooze 1..60 [0..10]  minutes and optionally the number of snoozes
+///     set autooff 1..120        minutes of vibrating until the alarm turns itself off
+///     set vibration 1..8 pulse|heartbeat|ramp|continuous
+///     stats
+///     stacks
+///     trace
+///     help
+class CommandShell
+{
+public:
+    static constexpr size_t MaximumLineLength = 64;
+
+    explicit CommandShell(ShellTarget &target) : target(target) {};
+
+    /// processes received bytes, complete lines are executed immediately
+    void feed(std::span<const uint8_t> data);
+
+    /// formats into a line buffer and writes it to the target
+    void print(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+    static constexpr size_t MaximumArguments = 4;
+    using Arguments = std::span<const std::string_view>;
+
+    ShellTarget &target;
+
+    std::array<char, MaximumLineLength> line{};
+    size_t lineLength = 0;
+    bool isLineTooLong = false;
+
+    void execute(std::string_view commandLine);
+
+    /// @return error reason, nullptr on success
+    const char *executeGet(Arguments arguments);
+    const char *executeSet(Arguments arguments);
+    void printHelp();
+
+    static std::optional<uint32_t> parseNumber(std::string_view text, uint32_t minimum, uint32_t maximum);
+    static std::optional<ShellTime> parseTime(std::string_view text, bool withSeconds);
+    static std::optional<Date> parseDate(std::string_view text);
+    static std::optional<uint8_t> parseAlarm(std::string_view text);
+    static std::optional<uint8_t> parseWeekdays(std::string_view text);
+    static std::optional<vibration::PatternId> parsePattern(std::string_view text);
+    static std::optional<Alarm> changeAlarm(Alarm alarm, std::string_view change);
+    static std::array<char, 8> formatWeekdays(uint8_t weekdays);
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// Lock-free byte FIFO for exactly one producer and one consumer, e.g. a task and an interrupt.
+/// The indices run freely and are masked on access, so all of the capacity is usable.
+template <size_t Capacity>
+class RingBuffer
+{
+public:
+    static_assert(std::has_single_bit(Capacity), "capacity has to be a power of two");
+
+    /// producer side
+    /// @return number of bytes which fitted into the buffer
+    size_t push(std::span<const uint8_t> data)
+    {
+        const size_t Head = head.load(std::memory_order_relaxed);
+        const size_t Length = std::min(data.size(), Capacity - (Head - tail.load(std::memory_order_acquire)));
+
+        for (size_t i = 0; i < Length; i++)
+            buffer[(Head + i) & Mask] = data[i];
+
+        head.store(Head + Length, std::memory_order_release);
+        return Length;
+    }
+
+    /// consumer side, contiguous part of the stored bytes up to the end of the buffer
+    std::span<const uint8_t> peek() const
+    {
+        const size_t Tail = tail.load(std::memory_order_relaxed);
+        const size_t Used = head.load(std::memory_order_acquire) - Tail;
+        const size_t Offset = Tail & Mask;
+
+        return {buffer.data() + Offset, std::min(Used, Capacity - Offset)};
+    }
+
+    /// consumer side, releases bytes returned by peek()
+    void consume(size_t length)
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + length, std::memory_order_release);
+    }
+
+    bool isEmpty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t Mask = Capacity - 1;
+
+    std::array<uint8_t, Capacity> buffer{};
+    std::atomic<size_t> head{0}; // written by producer only
+    std::atomic<size_t> tail{0}; // written by consumer only
+};
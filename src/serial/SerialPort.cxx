@@ -0,0 +1,202 @@
+#include "SerialPort.hpp"
+
+#include "task.h"
+
+namespace
+{
+constexpr uint32_t RxErrorFlags = USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE;
+constexpr uint32_t RxErrorClearFlags = USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF;
+} // namespace
+
+SerialPort::SerialPort(UART_HandleTypeDef *uartHandle, IRQn_Type uartInterrupt, DmaChannel rxChannel,
+                       DmaChannel txChannel)
+    : uartHandle(uartHandle), uartInterruptNumber(uartInterrupt)
+{
+    configASSERT(this->uartHandle != nullptr);
+
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    initDma(rxDmaHandle, rxChannel, DMA_PERIPH_TO_MEMORY, DMA_CIRCULAR);
+    initDma(txDmaHandle, txChannel, DMA_MEMORY_TO_PERIPH, DMA_NORMAL);
+
+    // every buffer half and the end of a burst wake up the reading task
+    rxDmaHandle.XferHalfCpltCallback = &SerialPort::rxDmaEvent;
+    rxDmaHandle.XferCpltCallback = &SerialPort::rxDmaEvent;
+    txDmaHandle.XferCpltCallback = &SerialPort::txDmaComplete;
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialPort::startReception()
+{
+    auto *uart = uartHandle->Instance;
+
+    readPosition = 0;
+    HAL_DMA_Start_IT(&rxDmaHandle, reinterpret_cast<uintptr_t>(&uart->RDR),
+                     reinterpret_cast<uintptr_t>(rxBuffer.data()), RxBufferSize);
+
+    uart->ICR = USART_ICR_IDLECF | RxErrorClearFlags;
+    SET_BIT(uart->CR3, USART_CR3_DMAR | USART_CR3_DMAT | USART_CR3_EIE);
+    SET_BIT(uart->CR1, USART_CR1_IDLEIE);
+
+    HAL_NVIC_SetPriority(uartInterruptNumber, 5, 0);
+    HAL_NVIC_EnableIRQ(uartInterruptNumber);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SerialPort::waitForData(TickType_t timeout)
+{
+    if (!getReceivedData().empty())
+        return true;
+
+    return xSemaphoreTake(rxSignal, timeout) == pdTRUE;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::span<const uint8_t> SerialPort::getReceivedData() const
+{
+    const size_t WritePosition = getWritePosition();
+
+    // wrapped bytes at the start of the buffer are returned by the next call
+    const size_t End = WritePosition >= readPosition ? WritePosition : RxBufferSize;
+    return {rxBuffer.data() + readPosition, End - readPosition};
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialPort::consume(size_t length)
+{
+    readPosition = (readPosition + length) % RxBufferSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SerialPort::write(std::span<const uint8_t> data, TickType_t timeout)
+{
+    TimeOut_t timeOut;
+    vTaskSetTimeOutState(&timeOut);
+
+    xSemaphoreTake(writeMutex, portMAX_DELAY);
+
+    while (true)
+    {
+        data = data.subspan(txBuffer.push(data));
+
+        if (!txBuffer.isEmpty() && !isTransmitting.exchange(true))
+            startTransmission();
+
+        // space is freed by the DMA completion interrupt
+        if (data.empty() || xTaskCheckForTimeOut(&timeOut, &timeout) == pdTRUE ||
+            xSemaphoreTake(txSpaceSignal, timeout) == pdFALSE)
+            break;
+    }
+
+    xSemaphoreGive(writeMutex);
+    return data.empty();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialPort::uartInterrupt()
+{
+    auto *uart = uartHandle->Instance;
+    const uint32_t Flags = uart->ISR;
+
+    // reception continues after an error, the broken byte is dropped by the command parser
+    if ((Flags & RxErrorFlags) != 0)
+    {
+        uart->ICR = RxErrorClearFlags;
+        numberOfRxErrors = numberOfRxErrors + 1;
+    }
+
+    if ((Flags & USART_ISR_IDLE) != 0)
+    {
+        uart->ICR = USART_ICR_IDLECF;
+        signalFromIsr(rxSignal);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialPort::rxDmaInterrupt()
+{
+    HAL_DMA_IRQHandler(&rxDmaHandle);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialPort::txDmaInterrupt()
+{
+    HAL_DMA_IRQHandler(&txDmaHandle);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialPort::initDma(DMA_HandleTypeDef &dmaHandle, DmaChannel channel, uint32_t direction, uint32_t mode)
+{
+    dmaHandle.Instance = channel.instance;
+    dmaHandle.Init.Request = channel.request;
+    dmaHandle.Init.Direction = direction;
+    dmaHandle.Init.PeriphInc = DMA_PINC_DISABLE;
+    dmaHandle.Init.MemInc = DMA_MINC_ENABLE;
+    dmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    dmaHandle.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    dmaHandle.Init.Mode = mode;
+    dmaHandle.Init.Priority = DMA_PRIORITY_MEDIUM;
+
+    const auto Result = HAL_DMA_Init(&dmaHandle);
+    configASSERT(Result == HAL_OK);
+
+    dmaHandle.Parent = this;
+
+    HAL_NVIC_SetPriority(channel.interrupt, 5, 0);
+    HAL_NVIC_EnableIRQ(channel.interrupt);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// the caller has to own isTransmitting
+void SerialPort::startTransmission()
+{
+    const auto Data = txBuffer.peek();
+    transmittingLength = Data.size();
+
+    HAL_DMA_Start_IT(&txDmaHandle, reinterpret_cast<uintptr_t>(Data.data()),
+                     reinterpret_cast<uintptr_t>(&uartHandle->Instance->TDR), Data.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialPort::signalFromIsr(SemaphoreHandle_t semaphore)
+{
+    BaseType_t higherPrioTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(semaphore, &higherPrioTaskWoken);
+    portYIELD_FROM_ISR(higherPrioTaskWoken);
+}
+
+//--------------------------------------------------------------------------------------------------
+size_t SerialPort::getWritePosition() const
+{
+    // the counter is reloaded with the buffer size after it has reached zero
+    return (RxBufferSize - __HAL_DMA_GET_COUNTER(&rxDmaHandle)) % RxBufferSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialPort::rxDmaEvent(DMA_HandleTypeDef *handle)
+{
+    auto &self = *static_cast<SerialPort *>(handle->Parent);
+    self.signalFromIsr(self.rxSignal);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialPort::txDmaComplete(DMA_HandleTypeDef *handle)
+{
+    auto &self = *static_cast<SerialPort *>(handle->Parent);
+
+    self.txBuffer.consume(self.transmittingLength);
+    self.signalFromIsr(self.txSpaceSignal);
+
+    if (!self.txBuffer.isEmpty())
+    {
+        self.startTransmission();
+        return;
+    }
+
+    self.isTransmitting = false;
+
+    // a task may have queued bytes after the check above without starting a transfer
+    if (!self.txBuffer.isEmpty() && !self.isTransmitting.exchange(true))
+        self.startTransmission();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "RingBuffer.hpp"
+
+#include "FreeRTOS.h"
+#include "main.h"
+#include "semphr.h"
+#include "usart.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// UART with DMA in both directions, so no task has to wait for single bytes.
+///
+/// Reception runs continuously into a circular DMA buffer. The reading task is woken up by the
+/// half and full transfer interrupts of the DMA and by the idle line interrupt of the UART, which
+/// marks the end of a burst. Received bytes are read directly out of the DMA buffer.
+///
+/// Transmitted bytes are queued in a ring buffer. Its contiguous part is sent by one DMA transfer,
+/// the completion interrupt starts the next one until the ring buffer is empty.
+class SerialPort
+{
+public:
+    static constexpr size_t RxBufferSize = 512; // 44 ms at 115200 baud
+    static constexpr size_t TxBufferSize = 1024;
+
+    struct DmaChannel
+    {
+        DMA_Channel_TypeDef *instance;
+        uint32_t request;
+        IRQn_Type interrupt;
+    };
+
+    SerialPort(UART_HandleTypeDef *uartHandle, IRQn_Type uartInterrupt, DmaChannel rxChannel, DmaChannel txChannel);
+
+    /// has to be called from task context, the interrupts need the application to be constructed
+    void startReception();
+
+    /// blocks until new bytes are received
+    /// @return false on timeout
+    bool waitForData(TickType_t timeout);
+
+    /// Contiguous part of the received bytes, it points directly into the DMA buffer.
+    /// Only one task may read.
+    std::span<const uint8_t> getReceivedData() const;
+
+    /// releases bytes returned by getReceivedData()
+    void consume(size_t length);
+
+    /// Queues the data for transmission. Blocks while the transmit buffer is full.
+    /// @return false if not all bytes could be queued within the timeout
+    bool write(std::span<const uint8_t> data, TickType_t timeout = portMAX_DELAY);
+
+    /// has to be called by the interrupts
+    void uartInterrupt();
+    void rxDmaInterrupt();
+    void txDmaInterrupt();
+
+    /// framing, noise and overrun errors since start
+    uint32_t getNumberOfRxErrors() const
+    {
+        return numberOfRxErrors;
+    }
+
+private:
+    UART_HandleTypeDef *uartHandle = nullptr;
+    IRQn_Type uartInterruptNumber;
+    DMA_HandleTypeDef rxDmaHandle{};
+    DMA_HandleTypeDef txDmaHandle{};
+
+    std::array<uint8_t, RxBufferSize> rxBuffer{};
+    size_t readPosition = 0;
+
+    RingBuffer<TxBufferSize> txBuffer;
+    std::atomic<bool> isTransmitting{false};
+    size_t transmittingLength = 0;
+
+    StaticSemaphore_t rxSignalBuffer{};
+    StaticSemaphore_t txSpaceSignalBuffer{};
+    StaticSemaphore_t writeMutexBuffer{};
+    SemaphoreHandle_t rxSignal = xSemaphoreCreateBinaryStatic(&rxSignalBuffer);
+    SemaphoreHandle_t txSpaceSignal = xSemaphoreCreateBinaryStatic(&txSpaceSignalBuffer);
+    SemaphoreHandle_t writeMutex = xSemaphoreCreateMutexStatic(&writeMutexBuffer);
+
+    volatile uint32_t numberOfRxErrors = 0;
+
+    void initDma(DMA_HandleTypeDef &dmaHandle, DmaChannel channel, uint32_t direction, uint32_t mode);
+    void startTransmission();
+    void signalFromIsr(SemaphoreHandle_t semaphore);
+
+    size_t getWritePosition() const;
+
+    static void rxDmaEvent(DMA_HandleTypeDef *handle);
+    static void txDmaComplete(DMA_HandleTypeDef *handle);
+};
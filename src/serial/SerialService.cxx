@@ -0,0 +1,328 @@
+#include "SerialService.hpp"
+#include "diagnostics/StackSizing.hpp"
+#include "diagnostics/Trace.hpp"
+
+#include "task.h"
+
+void SerialService::taskMain(void *)
+{
+    serialPort.startReception();
+
+    while (true)
+    {
+        serialPort.waitForData(toOsTicks(PollingInterval));
+
+        // the second part of wrapped data comes with the next round
+        const auto Data = serialPort.getReceivedData();
+        demultiplexer.feed(Data);
+        serialPort.consume(Data.size());
+
+        espLink.update(xTaskGetTickCount());
+
+        if (isTimeRequested && espLink.isIdle())
+            sendTimeRequest();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::writeOutput(std::string_view text)
+{
+    serialPort.write({reinterpret_cast<const uint8_t *>(text.data()), text.size()});
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<ShellTime> SerialService::getTime()
+{
+    if (!rtc.isRtcOnline())
+        return {};
+
+    const auto Time = rtc.getClockTime();
+    return ShellTime{Time.hour, Time.minute, Time.second};
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SerialService::setTime(const ShellTime &time)
+{
+    auto newTime = rtc.getClockTime();
+    newTime.hour = time.hour;
+    newTime.minute = time.minute;
+    newTime.second = time.second;
+
+    return rtc.writeClockTime(newTime);
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<Date> SerialService::getDate()
+{
+    if (!rtc.isRtcOnline())
+        return {};
+
+    return rtc.getDate();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SerialService::setDate(const Date &date)
+{
+    return rtc.writeDate(date);
+}
+
+//--------------------------------------------------------------------------------------------------
+Alarm SerialService::getAlarm(uint8_t index)
+{
+    return rtc.getAlarm(index);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::setAlarm(uint8_t index, const Alarm &alarm)
+{
+    rtc.setAlarm(index, alarm);
+}
+
+//--------------------------------------------------------------------------------------------------
+AlarmSequence SerialService::getAlarmSequence()
+{
+    return alarmEngine.getSequence();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::setAlarmSequence(const AlarmSequence &sequence)
+{
+    alarmEngine.setSequence(sequence);
+}
+
+//--------------------------------------------------------------------------------------------------
+vibration::PatternId SerialService::getVibrationPattern(uint8_t index)
+{
+    return alarmEngine.getVibrationPattern(index);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::setVibrationPattern(uint8_t index, vibration::PatternId pattern)
+{
+    alarmEngine.setVibrationPattern(index, pattern);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint8_t SerialService::getBrightness()
+{
+    return ledStrip.getGlobalBrightness();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::setBrightness(uint8_t brightness)
+{
+    ledStrip.setGlobalBrightness(brightness);
+}
+
+//--------------------------------------------------------------------------------------------------
+uint16_t SerialService::getColorTemperature()
+{
+    return ledStrip.getColorTemperature();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::setColorTemperature(uint16_t kelvin)
+{
+    ledStrip.setColorTemperature(kelvin);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::printStats()
+{
+    shell.print("uptime: %lu s\n", static_cast<unsigned long>(xTaskGetTickCount() / configTICK_RATE_HZ));
+    shell.print("free heap: %lu bytes, minimum %lu bytes\n", static_cast<unsigned long>(xPortGetFreeHeapSize()),
+                static_cast<unsigned long>(xPortGetMinimumEverFreeHeapSize()));
+    shell.print("faults: 0x%02lx\n", static_cast<unsigned long>(faultIndicator.getFaults().getBits()));
+    shell.print("rtc: %s\n", rtc.isRtcOnline() ? "online" : "offline");
+    shell.print("led wakeups: %lu\n", static_cast<unsigned long>(ledService.getWakeupCounter()));
+    shell.print("serial rx errors: %lu\n", static_cast<unsigned long>(serialPort.getNumberOfRxErrors()));
+
+    const auto &LinkStatistics = espLink.getStatistics();
+    shell.print("esp link: %lu frames, %lu invalid, %lu retransmissions, %lu lost\n",
+                static_cast<unsigned long>(LinkStatistics.receivedFrames),
+                static_cast<unsigned long>(LinkStatistics.invalidFrames),
+                static_cast<unsigned long>(LinkStatistics.retransmissions),
+                static_cast<unsigned long>(LinkStatistics.lostMessages));
+
+    printLoads();
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::printLoads()
+{
+    auto &snapshot = statisticsSnapshot;
+    if (!runTimeStatistics.getSnapshot(snapshot))
+        return;
+
+    auto printLoad = [this](const char *name, uint16_t load)
+    { shell.print("%-16s %3u.%02u %%", name, static_cast<unsigned>(load / 100), static_cast<unsigned>(load % 100)); };
+
+    printLoad("cpu", snapshot.cpuLoad);
+    shell.print(" in the last %lu s\n", static_cast<unsigned long>(RunTimeStatistics::WindowLength.getMagnitude()));
+
+    for (size_t i = 0; i < snapshot.numberOfTasks; i++)
+    {
+        const auto &Task = snapshot.tasks[i];
+        printLoad(Task.name, Task.load);
+        shell.print(", stack %u words left\n", static_cast<unsigned>(Task.stackHighWaterMark));
+    }
+
+    for (size_t i = 0; i < diagnostics::NumberOfIsrs; i++)
+    {
+        const auto &Isr = snapshot.isrs[i];
+        printLoad(diagnostics::IsrNames[i], Isr.load);
+        shell.print(", %lu calls\n", static_cast<unsigned long>(Isr.calls));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The high-water marks are the minimum since start-up, so the recommended sizes are only as good
+/// as the workload until now. All values are words.
+void SerialService::printStacks()
+{
+    auto &snapshot = statisticsSnapshot;
+    if (!runTimeStatistics.getSnapshot(snapshot))
+        return;
+
+    auto printStack = [this](const char *name, uint32_t size, uint32_t highWaterMark)
+    {
+        const uint32_t Used = size - highWaterMark;
+        shell.print("%-16s %5lu %5lu %11lu\n", name, static_cast<unsigned long>(size),
+                    static_cast<unsigned long>(Used),
+                    static_cast<unsigned long>(diagnostics::recommendStackSize(Used)));
+    };
+
+    shell.print("%-16s %5s %5s %11s\n", "stack", "size", "used", "recommended");
+
+    for (size_t i = 0; i < snapshot.numberOfTasks; i++)
+    {
+        const auto &Task = snapshot.tasks[i];
+        printStack(Task.name, Task.stackSize, Task.stackHighWaterMark);
+    }
+
+    printStack("interrupts", snapshot.mainStack.size, snapshot.mainStack.highWaterMark);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Format for the host decoder:
+///     trace <capacity> <clock frequency> <write index>
+///     task <number> <name>
+///     <record as 16 hex digits, little endian>
+bool SerialService::printTrace()
+{
+    if constexpr (trace::EnabledCategories == 0)
+        return false;
+    else
+    {
+        // otherwise the oldest records are overwritten while they are printed
+        trace::isPaused = true;
+
+        const auto &Header = trace::buffer.header;
+        shell.print("trace %lu %lu %lu\n", static_cast<unsigned long>(Header.capacity),
+                    static_cast<unsigned long>(Header.clockFrequency), static_cast<unsigned long>(Header.writeIndex));
+
+        static std::array<TaskStatus_t, RunTimeStatistics::MaximumNumberOfTasks> taskStatusArray;
+        const auto NumberOfTasks = uxTaskGetSystemState(taskStatusArray.data(), taskStatusArray.size(), nullptr);
+        for (size_t i = 0; i < NumberOfTasks; i++)
+            shell.print("task %lu %s\n", static_cast<unsigned long>(taskStatusArray[i].xTaskNumber),
+                        taskStatusArray[i].pcTaskName);
+
+        const size_t NumberOfRecords = std::min<size_t>(Header.writeIndex, trace::Capacity);
+        for (size_t i = Header.writeIndex - NumberOfRecords; i < Header.writeIndex; i++)
+        {
+            const auto &Record = trace::buffer.records[i % trace::Capacity];
+            const auto *Bytes = reinterpret_cast<const uint8_t *>(&Record);
+
+            shell.print("%02x%02x%02x%02x%02x%02x%02x%02x\n", Bytes[0], Bytes[1], Bytes[2], Bytes[3], Bytes[4],
+                        Bytes[5], Bytes[6], Bytes[7]);
+        }
+
+        trace::isPaused = false;
+        return true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::writeFrame(std::span<const uint8_t> frame)
+{
+    serialPort.write(frame);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::handleMessage(esp::MessageType type, std::span<const uint8_t> payload)
+{
+    using esp::LinkEndpoint;
+
+    switch (type)
+    {
+    case esp::MessageType::TimeSync:
+    {
+        const auto Message = LinkEndpoint::decodePayload<esp::TimeSync>(payload);
+        setTime({Message.hour, Message.minute, Message.second});
+        break;
+    }
+
+    case esp::MessageType::AlarmConfig:
+    {
+        // like a new time set by the buttons, the alarm is enabled and rings next time
+        const auto Message = LinkEndpoint::decodePayload<esp::AlarmConfig>(payload);
+        if (Message.alarm < 1 || Message.alarm > MaximumAlarms || Message.hour > 23 || Message.minute > 59)
+            break;
+
+        auto changedAlarm = getAlarm(Message.alarm - 1);
+        changedAlarm.minuteOfDay = Message.hour * 60 + Message.minute;
+        changedAlarm.isEnabled = true;
+        changedAlarm.isSkippingNext = false;
+        setAlarm(Message.alarm - 1, changedAlarm);
+        break;
+    }
+
+    case esp::MessageType::LightControl:
+    {
+        const auto Message = LinkEndpoint::decodePayload<esp::LightControl>(payload);
+        setBrightness(Message.brightness);
+        setColorTemperature(Message.colorTemperature);
+        ledStrip.setState(Message.isEnabled != 0);
+        break;
+    }
+
+    case esp::MessageType::TelemetryRequest:
+        sendTelemetry();
+        break;
+
+    case esp::MessageType::TimeResponse:
+        timeResponseHandler.handleTimeResponse(LinkEndpoint::decodePayload<esp::TimeResponse>(payload),
+                                               xTaskGetTickCount());
+        break;
+
+    default:
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::sendTelemetry()
+{
+    const auto Time = rtc.getClockTime();
+
+    const esp::Telemetry Message{Time.hour,
+                                 Time.minute,
+                                 Time.second,
+                                 static_cast<uint8_t>(rtc.getAlarmState()),
+                                 ledStrip.getGlobalBrightness(),
+                                 ledStrip.getColorTemperature(),
+                                 faultIndicator.getFaults().getBits(),
+                                 xTaskGetTickCount() / configTICK_RATE_HZ};
+
+    // an unacknowledged message is still in flight, the ESP asks again
+    espLink.send(Message, xTaskGetTickCount());
+}
+
+//--------------------------------------------------------------------------------------------------
+void SerialService::sendTimeRequest()
+{
+    // the originate time is taken as late as possible, the response echoes it
+    const esp::TimeRequest Message{xTaskGetTickCount()};
+    if (espLink.send(Message, Message.originateTime))
+        isTimeRequested = false;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CommandShell.hpp"
+#include "SerialPort.hpp"
+
+#include "LED/LedService.hpp"
+#include "LED/LedStrip.hpp"
+#include "alarm/AlarmEngine.hpp"
+#include "diagnostics/RunTimeStatistics.hpp"
+#include "health/FaultIndicator.hpp"
+#include "helpers/freertos.hpp"
+#include "link/LinkEndpoint.hpp"
+#include "link/SerialDemultiplexer.hpp"
+#include "rtc/RealTimeClock.hpp"
+#include "timesync/TimeSource.hpp"
+#include "wrappers/Task.hpp"
+
+#include <atomic>
+
+/// Command and telemetry channel on the serial port. The task sleeps until the DMA or the
+/// idle line interrupt signals received bytes and passes them to the command shell or to the
+/// binary link of the ESP co-processor, which share the line.
+class SerialService : public util::wrappers::TaskWithMemberFunctionBase,
+                      public ShellTarget,
+                      public esp::LinkTransport,
+                      public esp::LinkHandler,
+                      public TimeSource
+{
+public:
+    SerialService(SerialPort &serialPort, RealTimeClock &rtc, LedStrip &ledStrip, LedService &ledService,
+                  AlarmEngine &alarmEngine, FaultIndicator &faultIndicator, RunTimeStatistics &runTimeStatistics,
+                  TimeResponseHandler &timeResponseHandler)
+        : TaskWithMemberFunctionBase("serialTask", 512, osPriorityBelowNormal6), //
+          serialPort(serialPort),                                                //
+          rtc(rtc),                                                              //
+          ledStrip(ledStrip),                                                    //
+          ledService(ledService),                                                //
+          alarmEngine(alarmEngine),                                              //
+          faultIndicator(faultIndicator),                                        //
+          runTimeStatistics(runTimeStatistics),                                  //
+          timeResponseHandler(timeResponseHandler) {};
+
+    void writeOutput(std::string_view text) override;
+
+    std::optional<ShellTime> getTime() override;
+    bool setTime(const ShellTime &time) override;
+    std::optional<Date> getDate() override;
+    bool setDate(const Date &date) override;
+    Alarm getAlarm(uint8_t index) override;
+    void setAlarm(uint8_t index, const Alarm &alarm) override;
+    AlarmSequence getAlarmSequence() override;
+    void setAlarmSequence(const AlarmSequence &sequence) override;
+    vibration::PatternId getVibrationPattern(uint8_t index) override;
+    void setVibrationPattern(uint8_t index, vibration::PatternId pattern) override;
+
+    uint8_t getBrightness() override;
+    void setBrightness(uint8_t brightness) override;
+    uint16_t getColorTemperature() override;
+    void setColorTemperature(uint16_t kelvin) override;
+
+    void printStats() override;
+    void printStacks() override;
+    bool printTrace() override;
+
+    void writeFrame(std::span<const uint8_t> frame) override;
+    void handleMessage(esp::MessageType type, std::span<const uint8_t> payload) override;
+
+    void requestTime() override
+    {
+        isTimeRequested = true;
+    }
+
+protected:
+    [[noreturn]] void taskMain(void *) override;
+
+private:
+    SerialPort &serialPort;
+    RealTimeClock &rtc;
+    LedStrip &ledStrip;
+    LedService &ledService;
+    AlarmEngine &alarmEngine;
+    FaultIndicator &faultIndicator;
+    RunTimeStatistics &runTimeStatistics;
+    TimeResponseHandler &timeResponseHandler;
+
+    static constexpr auto RetransmitTimeout = 100.0_ms;
+
+    // wakes up the task for retransmissions of the link
+    static constexpr auto PollingInterval = 20.0_ms;
+
+    CommandShell shell{*this};
+    esp::LinkEndpoint espLink{*this, *this, toOsTicks(RetransmitTimeout)};
+    esp::SerialDemultiplexer demultiplexer{shell, espLink};
+
+    // set by the time sync task, the request is sent once the link is idle
+    std::atomic<bool> isTimeRequested{false};
+
+    // kept off the stack of this task
+    RunTimeStatistics::Snapshot statisticsSnapshot{};
+
+    void printLoads();
+    void sendTelemetry();
+    void sendTimeRequest();
+};
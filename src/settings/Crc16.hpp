@@ -0,0 +1,20 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+/// CRC-16/CCITT-FALSE, polynomial 0x1021
+constexpr uint16_t calculateCrc16(std::span<const uint8_t> data, uint16_t crc = 0xFFFF)
+{
+    for (const auto Byte : data)
+    {
+        crc ^= Byte << 8;
+        for (auto i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+static_assert(calculateCrc16(std::array<uint8_t, 9>{'1', '2', '3', '4', '5', '6', '7', '8', '9'}) == 0x29B1,
+              "check value of CRC-16/CCITT-FALSE");
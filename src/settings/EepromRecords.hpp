@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Crc16.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+enum class RecordId : uint8_t
+{
+    SettingsVersion1, // only read to take over the settings of older firmware
+    AlarmSchedules,
+    Settings,
+    MoreSettings, // keys which do not fit into the settings record
+};
+
+/// Fixed size records in an EEPROM, e.g. the settings or the alarm schedules.
+///
+/// Every record has two slots, which are written alternately. A header with an incrementing
+/// sequence number and a CRC tells which slot is valid and newer. A write torn by a power loss
+/// damages the older slot only, so the previous content of the record stays readable.
+/// Each slot covers whole EEPROM pages, so writing a record costs as few write cycles as possible.
+///
+/// @tparam Eeprom needs read(), write() and flush() like AT24C32
+template <typename Eeprom, size_t PageSize>
+class EepromRecords
+{
+public:
+    static constexpr size_t SlotSize = 2 * PageSize;
+
+    struct Header
+    {
+        uint8_t marker;
+        uint8_t id;
+        uint8_t sequenceNumber;
+        uint8_t length;
+        uint16_t crc;
+    };
+
+    static constexpr size_t MaximumPayload = SlotSize - sizeof(Header);
+    static constexpr uint8_t RecordMarker = 0x5A;
+
+    explicit EepromRecords(Eeprom &eeprom) : eeprom(eeprom) {};
+
+    /// @return nothing, if the record was never written or both slots are damaged
+    template <typename T>
+    std::optional<T> read(RecordId id)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= MaximumPayload);
+
+        const auto NewestSlot = findNewestSlot(id, sizeof(T));
+        if (!NewestSlot)
+            return {};
+
+        T value;
+        std::memcpy(&value, slotBuffer.data() + sizeof(Header), sizeof(T));
+        return value;
+    }
+
+    /// writes into the slot of the older content and flushes the EEPROM
+    template <typename T>
+    bool write(RecordId id, const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= MaximumPayload);
+
+        const auto NewestSlot = findNewestSlot(id, sizeof(T));
+        const size_t Slot = NewestSlot ? 1 - NewestSlot->index : 0;
+
+        Header header{RecordMarker, static_cast<uint8_t>(id),
+                      static_cast<uint8_t>(NewestSlot ? NewestSlot->sequenceNumber + 1 : 0),
+                      static_cast<uint8_t>(sizeof(T)), 0};
+
+        slotBuffer.fill(0xFF);
+        std::memcpy(slotBuffer.data() + sizeof(Header), &value, sizeof(T));
+        header.crc = calculateCrc(header, std::span{slotBuffer}.subspan(sizeof(Header), sizeof(T)));
+        std::memcpy(slotBuffer.data(), &header, sizeof(Header));
+
+        return eeprom.write(getSlotAddress(id, Slot), slotBuffer) && eeprom.flush();
+    }
+
+    static constexpr uint16_t getSlotAddress(RecordId id, size_t slot)
+    {
+        return (static_cast<size_t>(id) * 2 + slot) * SlotSize;
+    }
+
+private:
+    struct SlotInfo
+    {
+        size_t index;
+        uint8_t sequenceNumber;
+    };
+
+    Eeprom &eeprom;
+    std::array<uint8_t, SlotSize> slotBuffer{};
+
+    /// leaves the content of the newest slot in slotBuffer
+    std::optional<SlotInfo> findNewestSlot(RecordId id, size_t length)
+    {
+        std::optional<SlotInfo> newestSlot;
+
+        for (size_t slot = 0; slot < 2; slot++)
+        {
+            const auto SequenceNumber = readSlot(id, slot, length);
+            if (!SequenceNumber)
+                continue;
+
+            // sequence numbers wrap around, the difference tells which one is newer
+            if (!newestSlot || static_cast<int8_t>(*SequenceNumber - newestSlot->sequenceNumber) > 0)
+                newestSlot = SlotInfo{slot, *SequenceNumber};
+        }
+
+        if (newestSlot && newestSlot->index == 0)
+            readSlot(id, 0, length);
+
+        return newestSlot;
+    }
+
+    /// @return sequence number of a valid slot
+    std::optional<uint8_t> readSlot(RecordId id, size_t slot, size_t length)
+    {
+        if (!eeprom.read(getSlotAddress(id, slot), slotBuffer))
+            return {};
+
+        Header header;
+        std::memcpy(&header, slotBuffer.data(), sizeof(Header));
+
+        if (header.marker != RecordMarker || header.id != static_cast<uint8_t>(id) || header.length != length ||
+            header.crc != calculateCrc(header, std::span{slotBuffer}.subspan(sizeof(Header), length)))
+            return {};
+
+        return header.sequenceNumber;
+    }
+
+    /// over the header without CRC and the payload
+    static uint16_t calculateCrc(const Header &header, std::span<const uint8_t> payload)
+    {
+        const std::array<uint8_t, 4> HeaderBytes{header.marker, header.id, header.sequenceNumber, header.length};
+        return calculateCrc16(payload, calculateCrc16(HeaderBytes));
+    }
+};
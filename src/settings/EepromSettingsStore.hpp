@@ -0,0 +1,128 @@
+#pragma once
+
+#include "EepromRecords.hpp"
+#include "SettingsStorage.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+
+/// Keeps the settings in EEPROM records. EEPROM cells endure about 100 times more write cycles
+/// than internal flash and writing does not stall the CPU, so it is preferred if available.
+/// The keys are split into records of KeysPerRecord keys, a change writes only its own record.
+template <typename Eeprom, size_t PageSize>
+class EepromSettingsStore : public SettingsStorage
+{
+public:
+    static constexpr size_t KeysPerRecord = 14;
+    static constexpr std::array<RecordId, 2> RecordIds{RecordId::Settings, RecordId::MoreSettings};
+    static constexpr size_t MaximumKeys = KeysPerRecord * RecordIds.size();
+
+    explicit EepromSettingsStore(Eeprom &eeprom) : eeprom(eeprom), records(eeprom) {};
+
+    /// an empty or damaged record is not an error, its keys are unset then
+    bool mount() override
+    {
+        if (!eeprom.isPresent())
+            return false;
+
+        for (size_t i = 0; i < RecordIds.size(); i++)
+            parts[i] = records.template read<Record>(RecordIds[i]).value_or(Record{});
+
+        dirtyKeys = 0;
+
+        // the keys keep their meaning, they are written into the new record with the next change
+        if (parts[0].validKeys == 0)
+        {
+            if (const auto FormerRecord = records.template read<RecordVersion1>(RecordId::SettingsVersion1))
+            {
+                parts[0].validKeys = static_cast<uint16_t>(FormerRecord->validKeys);
+                std::copy(FormerRecord->values.begin(), FormerRecord->values.end(), parts[0].values.begin());
+            }
+        }
+
+        return true;
+    }
+
+    std::optional<uint32_t> get(uint8_t key) const override
+    {
+        if (key >= MaximumKeys)
+            return {};
+
+        const auto &Part = parts[key / KeysPerRecord];
+        if ((Part.validKeys & getBit(key % KeysPerRecord)) == 0)
+            return {};
+
+        return Part.values[key % KeysPerRecord];
+    }
+
+    bool set(uint8_t key, uint32_t value) override
+    {
+        if (key >= MaximumKeys)
+            return false;
+
+        auto &part = parts[key / KeysPerRecord];
+        const auto Index = key % KeysPerRecord;
+
+        if ((part.validKeys & getBit(Index)) != 0 && part.values[Index] == value)
+            return false;
+
+        part.values[Index] = value;
+        part.validKeys |= getBit(Index);
+        dirtyKeys |= getBit(key);
+        return true;
+    }
+
+    bool hasPendingChanges() const override
+    {
+        return dirtyKeys != 0;
+    }
+
+    bool flush() override
+    {
+        for (size_t i = 0; i < RecordIds.size(); i++)
+        {
+            constexpr uint32_t RecordMask = getBit(KeysPerRecord) - 1;
+            const auto DirtyKeysOfRecord = dirtyKeys & (RecordMask << (i * KeysPerRecord));
+            if (DirtyKeysOfRecord == 0)
+                continue;
+
+            if (!records.write(RecordIds[i], parts[i]))
+                return false;
+
+            dirtyKeys &= ~DirtyKeysOfRecord;
+        }
+
+        return true;
+    }
+
+private:
+    // 16 bits of valid keys leave room for 14 keys in the payload of a record
+    struct [[gnu::packed]] Record
+    {
+        uint16_t validKeys = 0;
+        std::array<uint32_t, KeysPerRecord> values{};
+    };
+
+    struct RecordVersion1
+    {
+        uint32_t validKeys = 0;
+        std::array<uint32_t, 13> values{};
+    };
+
+    static_assert(sizeof(Record) <= EepromRecords<Eeprom, PageSize>::MaximumPayload);
+    static_assert(MaximumKeys <= 32, "dirty keys are a 32 bit mask");
+
+    Eeprom &eeprom;
+    EepromRecords<Eeprom, PageSize> records;
+
+    std::array<Record, RecordIds.size()> parts{};
+    uint32_t dirtyKeys = 0;
+
+    static constexpr uint32_t getBit(size_t key)
+    {
+        return 1UL << key;
+    }
+};
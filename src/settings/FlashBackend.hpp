@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/// Page oriented flash memory as seen by SettingsStore. Addresses are relative to the start of
+/// the region. Like STM32L4 flash, a double word can only be programmed once after an erase.
+class FlashBackend
+{
+public:
+    static constexpr size_t ProgramUnit = sizeof(uint64_t);
+
+    virtual size_t getPageSize() const = 0;
+    virtual size_t getNumberOfPages() const = 0;
+
+    virtual void read(size_t address, std::span<uint8_t> buffer) = 0;
+    virtual bool programDoubleWord(size_t address, uint64_t doubleWord) = 0;
+    virtual bool erasePage(size_t page) = 0;
+};
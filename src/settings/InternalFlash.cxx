@@ -0,0 +1,41 @@
+#include "InternalFlash.hpp"
+
+#include <cstring>
+
+void InternalFlash::read(size_t address, std::span<uint8_t> buffer)
+{
+    // a double ECC error of a torn double word is cleared by NMI handler, the CRC rejects the data
+    std::memcpy(buffer.data(), _settings_start + address, buffer.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+bool InternalFlash::programDoubleWord(size_t address, uint64_t doubleWord)
+{
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+    const auto Result = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD,
+                                          reinterpret_cast<uintptr_t>(_settings_start + address), doubleWord);
+    HAL_FLASH_Lock();
+
+    return Result == HAL_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool InternalFlash::erasePage(size_t page)
+{
+    FLASH_EraseInitTypeDef eraseInit{};
+    eraseInit.TypeErase = FLASH_TYPEERASE_PAGES;
+    eraseInit.Banks = FLASH_BANK_1;
+    eraseInit.Page = (reinterpret_cast<uintptr_t>(_settings_start) - FLASH_BASE) / FLASH_PAGE_SIZE + page;
+    eraseInit.NbPages = 1;
+
+    uint32_t pageError = 0;
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    const auto Result = HAL_FLASHEx_Erase(&eraseInit, &pageError);
+    HAL_FLASH_Lock();
+
+    return Result == HAL_OK;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "FlashBackend.hpp"
+
+#include "main.h"
+
+// reserved by linker script
+extern "C" uint8_t _settings_start[];
+extern "C" uint8_t _settings_end[];
+
+/// Settings region at the end of the internal flash.
+/// Programming and erasing stall every flash access of the CPU, an erase takes about 22ms.
+class InternalFlash : public FlashBackend
+{
+public:
+    size_t getPageSize() const override
+    {
+        return FLASH_PAGE_SIZE;
+    }
+
+    size_t getNumberOfPages() const override
+    {
+        return (_settings_end - _settings_start) / FLASH_PAGE_SIZE;
+    }
+
+    void read(size_t address, std::span<uint8_t> buffer) override;
+    bool programDoubleWord(size_t address, uint64_t doubleWord) override;
+    bool erasePage(size_t page) override;
+};
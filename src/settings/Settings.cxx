@@ -0,0 +1,76 @@
+#include "Settings.hpp"
+
+void Settings::mount()
+{
+    xSemaphoreTake(mutex, portMAX_DELAY);
+
+    if (preferredStorage.mount())
+        storage = &preferredStorage;
+
+    else
+    {
+        const bool IsMounted = fallbackStorage.mount();
+        configASSERT(IsMounted);
+        storage = &fallbackStorage;
+    }
+
+    xSemaphoreGive(mutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<uint32_t> Settings::get(SettingsKey key)
+{
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    const auto Value = storage != nullptr ? storage->get(static_cast<uint8_t>(key)) : std::nullopt;
+    xSemaphoreGive(mutex);
+
+    return Value;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Settings::set(SettingsKey key, uint32_t value)
+{
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    const bool HasChanged = storage != nullptr && storage->set(static_cast<uint8_t>(key), value);
+    xSemaphoreGive(mutex);
+
+    // every change postpones the write
+    if (HasChanged)
+        xTimerChangePeriod(flushTimer, toOsTicks(FlushDelay), 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool Settings::hasPendingChanges()
+{
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    const bool HasPendingChanges = storage != nullptr && storage->hasPendingChanges();
+    xSemaphoreGive(mutex);
+
+    return HasPendingChanges;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Settings::handleFlushTimer()
+{
+    isFlushDue = true;
+}
+
+//--------------------------------------------------------------------------------------------------
+void Settings::flushIfDue()
+{
+    if (isFlushDue.exchange(false))
+        flush();
+}
+
+//--------------------------------------------------------------------------------------------------
+bool Settings::flush()
+{
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    const bool IsFlushed = storage == nullptr || storage->flush();
+    xSemaphoreGive(mutex);
+
+    if (!IsFlushed)
+        xTimerChangePeriod(flushTimer, toOsTicks(RetryDelay), 0);
+
+    return IsFlushed;
+}
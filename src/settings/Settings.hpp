@@ -0,0 +1,76 @@
+#pragma once
+
+#include "SettingsStorage.hpp"
+#include "alarm/Alarm.hpp"
+
+#include "FreeRTOS.h"
+#include "helpers/freertos.hpp"
+#include "semphr.h"
+#include "timers.h"
+
+#include <atomic>
+
+enum class SettingsKey : uint8_t
+{
+    LedBrightness,
+    ColorTemperature,
+    AlarmsEnabled, // former alarm mode, its value is kept as it was: 0 = off
+    Alarm1Weekdays, // only read to take over the alarms of older firmware
+    Alarm2Weekdays,
+    FirstAlarm, // followed by one key per alarm, see Alarm::pack()
+    RtcKeepsUtc = FirstAlarm + MaximumAlarms, // 1 once the local time of older firmware has been converted
+    AlarmSequence,                            // see AlarmSequence::pack()
+    FirstVibrationPattern // followed by one key per alarm, a vibration::PatternId
+};
+
+/// Thread safe access to the settings. Changes are written some seconds after the last change, so a
+/// series of button presses results in a single write.
+///
+/// The write blocks on the I2C bus or while a flash page is erased, which must not happen in the
+/// timer service task. So the timer only marks the write as due and a task polls flushIfDue().
+class Settings
+{
+public:
+    /// @param preferredStorage used if it can be mounted, e.g. the EEPROM of the RTC module
+    /// @param fallbackStorage used otherwise
+    Settings(SettingsStorage &preferredStorage, SettingsStorage &fallbackStorage,
+             TimerCallbackFunction_t flushCallback)
+        : preferredStorage(preferredStorage), fallbackStorage(fallbackStorage), flushCallback(flushCallback)
+    {
+    }
+
+    /// Has to be called from task context before the first access, because the preferred storage
+    /// may need the I2C bus. Values are unset until then.
+    void mount();
+
+    std::optional<uint32_t> get(SettingsKey key);
+    void set(SettingsKey key, uint32_t value);
+
+    /// called by the flush timer
+    void handleFlushTimer();
+
+    /// Writes the changes if the flush timer has expired. Has to be called regularly by a task which
+    /// may block for some milliseconds.
+    void flushIfDue();
+
+    /// Writes the changes at once, for values which have to be stored before going on.
+    bool flush();
+
+    bool hasPendingChanges();
+
+private:
+    static constexpr auto FlushDelay = 5.0_s;
+    static constexpr auto RetryDelay = 60.0_s;
+
+    SettingsStorage &preferredStorage;
+    SettingsStorage &fallbackStorage;
+    SettingsStorage *storage = nullptr;
+    StaticSemaphore_t mutexBuffer{};
+    SemaphoreHandle_t mutex = xSemaphoreCreateMutexStatic(&mutexBuffer);
+    std::atomic<bool> isFlushDue = false;
+
+    TimerCallbackFunction_t flushCallback = nullptr;
+    StaticTimer_t flushTimerBuffer{};
+    TimerHandle_t flushTimer{xTimerCreateStatic("settingsTimer", toOsTicks(FlushDelay), pdFALSE, nullptr,
+                                                flushCallback, &flushTimerBuffer)};
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+/// Common interface of the places where settings can live, e.g. internal flash or an external EEPROM.
+/// Values are cached in RAM, set() changes the cache only and flush() writes all changes at once.
+class SettingsStorage
+{
+public:
+    /// loads all values into the cache
+    /// @return false if the storage is not usable
+    virtual bool mount() = 0;
+
+    virtual std::optional<uint32_t> get(uint8_t key) const = 0;
+
+    /// @return true if the value has changed
+    virtual bool set(uint8_t key, uint32_t value) = 0;
+
+    virtual bool hasPendingChanges() const = 0;
+
+    /// @return false on write errors, changes are kept pending then
+    virtual bool flush() = 0;
+};
@@ -0,0 +1,183 @@
+#include "SettingsStore.hpp"
+
+#include <bit>
+
+bool SettingsStore::mount()
+{
+    std::optional<size_t> newestPage;
+
+    for (size_t page = 0; page < flash.getNumberOfPages(); page++)
+    {
+        const auto Header = readHeader(page);
+        if (Header && (!newestPage || *Header > sequenceNumber))
+        {
+            newestPage = page;
+            sequenceNumber = *Header;
+        }
+    }
+
+    if (!newestPage)
+        return format();
+
+    activePage = *newestPage;
+    loadRecords();
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<uint32_t> SettingsStore::get(uint8_t key) const
+{
+    if (key >= MaximumKeys || (validKeys & getBit(key)) == 0)
+        return {};
+
+    return values[key];
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SettingsStore::set(uint8_t key, uint32_t value)
+{
+    if (key >= MaximumKeys)
+        return false;
+
+    if ((validKeys & getBit(key)) != 0 && values[key] == value)
+        return false;
+
+    values[key] = value;
+    validKeys |= getBit(key);
+    dirtyKeys |= getBit(key);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SettingsStore::flush()
+{
+    while (dirtyKeys != 0)
+    {
+        if (writeOffset + FlashBackend::ProgramUnit > flash.getPageSize())
+        {
+            // compaction writes all values, so there is nothing left to do afterwards
+            if (!compact())
+                return false;
+
+            continue;
+        }
+
+        const auto Key = static_cast<uint8_t>(std::countr_zero(dirtyKeys));
+        if (!appendRecord(Key, values[Key]))
+            return false;
+
+        dirtyKeys &= ~getBit(Key);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+uint64_t SettingsStore::readDoubleWord(size_t address)
+{
+    uint64_t doubleWord = 0;
+    flash.read(address, {reinterpret_cast<uint8_t *>(&doubleWord), sizeof(doubleWord)});
+    return doubleWord;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<uint32_t> SettingsStore::readHeader(size_t page)
+{
+    const auto Header = readDoubleWord(getPageAddress(page));
+
+    if (static_cast<uint32_t>(Header) != HeaderMagic)
+        return {};
+
+    return static_cast<uint32_t>(Header >> 32);
+}
+
+//--------------------------------------------------------------------------------------------------
+void SettingsStore::loadRecords()
+{
+    validKeys = 0;
+    dirtyKeys = 0;
+    writeOffset = flash.getPageSize(); // full, if no erased double word is found
+
+    const auto PageAddress = getPageAddress(activePage);
+
+    for (size_t offset = FlashBackend::ProgramUnit; offset < flash.getPageSize(); offset += FlashBackend::ProgramUnit)
+    {
+        const auto Record = readDoubleWord(PageAddress + offset);
+
+        if (Record == ErasedDoubleWord)
+        {
+            writeOffset = offset;
+            break;
+        }
+
+        const auto Key = static_cast<uint8_t>(Record);
+        const auto Marker = static_cast<uint8_t>(Record >> 8);
+        const auto Crc = static_cast<uint16_t>(Record >> 16);
+        const auto Value = static_cast<uint32_t>(Record >> 32);
+
+        // skip torn or foreign records, the previous value of the key stays valid
+        if (Marker != RecordMarker || Key >= MaximumKeys || Crc != calculateCrc(Key, Value))
+            continue;
+
+        values[Key] = Value;
+        validKeys |= getBit(Key);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SettingsStore::format()
+{
+    activePage = 0;
+    sequenceNumber = 1;
+    validKeys = 0;
+    dirtyKeys = 0;
+
+    if (!flash.erasePage(activePage) || !flash.programDoubleWord(getPageAddress(activePage), makeHeader(sequenceNumber)))
+        return false;
+
+    writeOffset = FlashBackend::ProgramUnit;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SettingsStore::appendRecord(uint8_t key, uint32_t value)
+{
+    const auto Address = getPageAddress(activePage) + writeOffset;
+
+    // a failed double word cannot be programmed again, the next try uses the following one
+    writeOffset += FlashBackend::ProgramUnit;
+    return flash.programDoubleWord(Address, makeRecord(key, value));
+}
+
+//--------------------------------------------------------------------------------------------------
+bool SettingsStore::compact()
+{
+    const size_t NextPage = (activePage + 1) % flash.getNumberOfPages();
+    const auto PageAddress = getPageAddress(NextPage);
+
+    if (!flash.erasePage(NextPage))
+        return false;
+
+    size_t offset = FlashBackend::ProgramUnit;
+    for (uint8_t key = 0; key < MaximumKeys; key++)
+    {
+        if ((validKeys & getBit(key)) == 0)
+            continue;
+
+        if (!flash.programDoubleWord(PageAddress + offset, makeRecord(key, values[key])))
+            return false;
+
+        offset += FlashBackend::ProgramUnit;
+    }
+
+    // header comes last, so the old page stays active until the new one is complete
+    if (!flash.programDoubleWord(PageAddress, makeHeader(sequenceNumber + 1)))
+        return false;
+
+    activePage = NextPage;
+    sequenceNumber++;
+    writeOffset = offset;
+    dirtyKeys = 0;
+    numberOfCompactions++;
+    return true;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Crc16.hpp"
+#include "FlashBackend.hpp"
+#include "SettingsStorage.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/// Log-structured key/value store for 32 bit values in a ring of flash pages.
+///
+/// Every page starts with a header containing a sequence number, the page with the highest one
+/// is active. Changes are appended as records of one double word, each protected by a CRC.
+/// A record with a bad CRC (e.g. torn by a power loss) is skipped, so the previous value of the
+/// key stays valid. If the active page is full, the latest values are copied to the next page
+/// of the ring and its header is programmed at last, so a power loss during compaction keeps
+/// the old page active. Pages are erased in turn, which spreads the wear over all of them.
+///
+/// Reads are served by a RAM cache. set() only touches the cache, flush() writes all changed
+/// keys at once, so repeated changes of the same key cost one flash write only.
+class SettingsStore : public SettingsStorage
+{
+public:
+    static constexpr size_t MaximumKeys = 32;
+
+    explicit SettingsStore(FlashBackend &flash) : flash(flash)
+    {
+    }
+
+    /// Finds the active page and fills the cache, formats the flash if there is no valid page.
+    /// @return false if formatting has failed
+    bool mount() override;
+
+    std::optional<uint32_t> get(uint8_t key) const override;
+
+    /// changes the cached value only, see flush()
+    /// @return true if the value has changed
+    bool set(uint8_t key, uint32_t value) override;
+
+    bool hasPendingChanges() const override
+    {
+        return dirtyKeys != 0;
+    }
+
+    /// writes all changed values to flash
+    /// @return false on flash errors, changes are kept pending then
+    bool flush() override;
+
+    size_t getActivePage() const
+    {
+        return activePage;
+    }
+
+    uint32_t getSequenceNumber() const
+    {
+        return sequenceNumber;
+    }
+
+    /// number of compactions since mount, each of them has erased one page
+    size_t getNumberOfCompactions() const
+    {
+        return numberOfCompactions;
+    }
+
+    static constexpr uint32_t HeaderMagic = 0x5345'5453; // "STES"
+    static constexpr uint8_t RecordMarker = 0xA5;
+
+    static constexpr uint64_t makeHeader(uint32_t sequenceNumber)
+    {
+        return static_cast<uint64_t>(sequenceNumber) << 32 | HeaderMagic;
+    }
+
+    /// layout: key (8 bit), marker (8 bit), CRC16 (16 bit), value (32 bit)
+    static constexpr uint64_t makeRecord(uint8_t key, uint32_t value)
+    {
+        const uint64_t Crc = calculateCrc(key, value);
+        return static_cast<uint64_t>(value) << 32 | Crc << 16 | RecordMarker << 8 | key;
+    }
+
+    /// CRC-16/CCITT-FALSE over key and value
+    static constexpr uint16_t calculateCrc(uint8_t key, uint32_t value)
+    {
+        const std::array<uint8_t, 6> Bytes{key,
+                                           RecordMarker,
+                                           static_cast<uint8_t>(value),
+                                           static_cast<uint8_t>(value >> 8),
+                                           static_cast<uint8_t>(value >> 16),
+                                           static_cast<uint8_t>(value >> 24)};
+        return calculateCrc16(Bytes);
+    }
+
+    static constexpr uint64_t ErasedDoubleWord = UINT64_MAX;
+
+private:
+    FlashBackend &flash;
+
+    std::array<uint32_t, MaximumKeys> values{};
+    uint32_t validKeys = 0;
+    uint32_t dirtyKeys = 0;
+
+    size_t activePage = 0;
+    uint32_t sequenceNumber = 0;
+    size_t writeOffset = 0;
+    size_t numberOfCompactions = 0;
+
+    uint64_t readDoubleWord(size_t address);
+    std::optional<uint32_t> readHeader(size_t page);
+    void loadRecords();
+    bool format();
+    bool appendRecord(uint8_t key, uint32_t value);
+    bool compact();
+
+    size_t getPageAddress(size_t page) const
+    {
+        return page * flash.getPageSize();
+    }
+
+    static constexpr uint32_t getBit(uint8_t key)
+    {
+        return 1UL << key;
+    }
+};
@@ -4,15 +4,13 @@ void StateMachine::handleTimeoutTimer()
 {
     switch (displayState)
     {
-    case DisplayState::ChangeAlarm1Hour:
-    case DisplayState::ChangeAlarm2Hour:
+    case DisplayState::ChangeAlarmHour:
     case DisplayState::ChangeClockHour:
         blink = false;
         isIncrementing ? timeToModify.addHours(1) : timeToModify.subHours(1);
         break;
 
-    case DisplayState::ChangeAlarm1Minute:
-    case DisplayState::ChangeAlarm2Minute:
+    case DisplayState::ChangeAlarmMinute:
         blink = false;
         isIncrementing ? timeToModify.addMinutes(5) : timeToModify.subMinutes(5);
         break;
@@ -54,37 +52,24 @@ void StateMachine::buttonLeftCallback(util::Button::Action action)
         {
         case DisplayState::Clock:
         case DisplayState::ClockWithAlarmLeds:
-            timeToModify = rtc.getAlarmTime1();
-            updateDisplayState(DisplayState::DisplayAlarm1);
+            showAlarmPage(0);
             break;
 
-        case DisplayState::DisplayAlarm1:
-            timeToModify = rtc.getAlarmTime2();
-            updateDisplayState(DisplayState::DisplayAlarm2);
+        case DisplayState::DisplayAlarm:
+            // page through all alarms, then back to the clock
+            if (alarmIndex + 1 < MaximumAlarms)
+                showAlarmPage(alarmIndex + 1);
+            else
+                goToDefaultState();
             break;
 
-        case DisplayState::DisplayAlarm2:
-            goToDefaultState();
-            break;
-
-        case DisplayState::ChangeAlarm1Hour:
-            updateDisplayState(DisplayState::ChangeAlarm1Minute);
-            break;
-
-        case DisplayState::ChangeAlarm1Minute:
-            signalResult(rtc.writeAlarmTime1(timeToModify));
-            rtc.setAlarmMode(RealTimeClock::AlarmMode::Alarm1);
-            updateDisplayState(DisplayState::DisplayAlarm1);
+        case DisplayState::ChangeAlarmHour:
+            updateDisplayState(DisplayState::ChangeAlarmMinute);
             break;
 
-        case DisplayState::ChangeAlarm2Hour:
-            updateDisplayState(DisplayState::ChangeAlarm2Minute);
-            break;
-
-        case DisplayState::ChangeAlarm2Minute:
-            signalResult(rtc.writeAlarmTime2(timeToModify));
-            rtc.setAlarmMode(RealTimeClock::AlarmMode::Alarm2);
-            updateDisplayState(DisplayState::DisplayAlarm2);
+        case DisplayState::ChangeAlarmMinute:
+            saveAlarmTime();
+            updateDisplayState(DisplayState::DisplayAlarm);
             break;
 
         case DisplayState::ChangeClockHour:
@@ -115,14 +100,9 @@ void StateMachine::buttonLeftCallback(util::Button::Action action)
 
         switch (displayState)
         {
-        case DisplayState::DisplayAlarm1:
+        case DisplayState::DisplayAlarm:
             blink = true;
-            updateDisplayState(DisplayState::ChangeAlarm1Hour);
-            break;
-
-        case DisplayState::DisplayAlarm2:
-            blink = true;
-            updateDisplayState(DisplayState::ChangeAlarm2Hour);
+            updateDisplayState(DisplayState::ChangeAlarmHour);
             break;
 
         default:
@@ -134,8 +114,7 @@ void StateMachine::buttonLeftCallback(util::Button::Action action)
     {
         if (rtc.getAlarmState() != RealTimeClock::AlarmState::Off)
         {
-            rtc.setAlarmState(RealTimeClock::AlarmState::Off);
-            initialAlarm = true;
+            alarmEngine.stop();
             revokeDisplayDelay();
             return;
         }
@@ -183,28 +162,14 @@ void StateMachine::buttonRightCallback(util::Button::Action action)
             break;
 
         case DisplayState::DisplayAlarmStatus:
-        {
-            switch (rtc.getAlarmMode())
-            {
-            case RealTimeClock::AlarmMode::Off:
-                rtc.setAlarmMode(RealTimeClock::AlarmMode::Alarm1);
-                break;
-
-            case RealTimeClock::AlarmMode::Alarm1:
-                rtc.setAlarmMode(RealTimeClock::AlarmMode::Alarm2);
-                break;
-
-            case RealTimeClock::AlarmMode::Alarm2:
-                rtc.setAlarmMode(RealTimeClock::AlarmMode::Both);
-                break;
-
-            case RealTimeClock::AlarmMode::Both:
-                rtc.setAlarmMode(RealTimeClock::AlarmMode::Off);
-                break;
-            }
+            rtc.setAlarmsEnabled(!rtc.areAlarmsEnabled());
             revokeDisplayDelay();
-        }
-        break;
+            break;
+
+        case DisplayState::DisplayAlarm:
+            cycleAlarmState();
+            revokeDisplayDelay();
+            break;
 
         case DisplayState::Standby:
             goToDefaultState();
@@ -247,7 +212,7 @@ void StateMachine::buttonSnoozeCallback(util::Button::Action action)
     {
         if (rtc.getAlarmState() == RealTimeClock::AlarmState::Vibration)
         {
-            rtc.setAlarmState(RealTimeClock::AlarmState::Snooze);
+            alarmEngine.snooze();
             revokeDisplayDelay();
         }
 
@@ -260,10 +225,8 @@ void StateMachine::buttonSnoozeCallback(util::Button::Action action)
     {
         switch (displayState)
         {
-        case DisplayState::ChangeAlarm1Hour:
-        case DisplayState::ChangeAlarm2Hour:
-        case DisplayState::ChangeAlarm1Minute:
-        case DisplayState::ChangeAlarm2Minute:
+        case DisplayState::ChangeAlarmHour:
+        case DisplayState::ChangeAlarmMinute:
             // do nothing
             break;
 
@@ -317,9 +280,8 @@ void StateMachine::buttonCCTMinusCallback(util::Button::Action action)
 //-----------------------------------------------------------------
 bool StateMachine::isInChangeScreen()
 {
-    return displayState == DisplayState::ChangeAlarm1Hour || displayState == DisplayState::ChangeAlarm2Hour ||
-           displayState == DisplayState::ChangeClockHour || displayState == DisplayState::ChangeAlarm1Minute ||
-           displayState == DisplayState::ChangeAlarm2Minute || displayState == DisplayState::ChangeClockMinute;
+    return displayState == DisplayState::ChangeAlarmHour || displayState == DisplayState::ChangeClockHour ||
+           displayState == DisplayState::ChangeAlarmMinute || displayState == DisplayState::ChangeClockMinute;
 }
 
 //-----------------------------------------------------------------
@@ -329,14 +291,12 @@ void StateMachine::incrementNumber()
 
     switch (displayState)
     {
-    case DisplayState::ChangeAlarm1Hour:
-    case DisplayState::ChangeAlarm2Hour:
+    case DisplayState::ChangeAlarmHour:
     case DisplayState::ChangeClockHour:
         timeToModify.addHours(1);
         break;
 
-    case DisplayState::ChangeAlarm1Minute:
-    case DisplayState::ChangeAlarm2Minute:
+    case DisplayState::ChangeAlarmMinute:
         timeToModify.addMinutes(5);
         break;
 
@@ -356,14 +316,12 @@ void StateMachine::decrementNumber()
 
     switch (displayState)
     {
-    case DisplayState::ChangeAlarm1Hour:
-    case DisplayState::ChangeAlarm2Hour:
+    case DisplayState::ChangeAlarmHour:
     case DisplayState::ChangeClockHour:
         timeToModify.subHours(1);
         break;
 
-    case DisplayState::ChangeAlarm1Minute:
-    case DisplayState::ChangeAlarm2Minute:
+    case DisplayState::ChangeAlarmMinute:
         timeToModify.subMinutes(5);
         break;
 
@@ -5,17 +5,13 @@
 void StateMachine::taskMain(void *)
 {
     waitForRtc();
+    restoreSettings();
+    convertRtcToUtc();
     displayLedInitialization();
 
     while (true)
     {
-        display.clearGridDataArray();
-        statusLeds.ledAlarm1.turnOff();
-        statusLeds.ledAlarm2.turnOff();
-
-        // ToDo: replace it with reading general error state
-        if (!rtc.isRtcOnline())
-            statusLeds.ledRedGreen.setColor(util::led::pwm::DualLedColor::Red);
+        turnOffUnusedAlarmLeds();
 
         // check if alarm is activated
         if (rtc.getAlarmState() != RealTimeClock::AlarmState::Off)
@@ -23,34 +19,206 @@ void StateMachine::taskMain(void *)
             if (initialAlarm)
             {
                 initialAlarm = false;
-                alarmStateCounter = 0;
                 updateDisplayState(DisplayState::Clock); // also wake up display
-                ledStrip.turnOn();
+                alarmEngine.start();                     // takes over the timeline until alarm is off
             }
 
-            showClockWithBlinkingAlarm();
-            // ToDo: transition sunrise -> vibration -snooze - off
+            renderFrame();
+            showBlinkingAlarmLeds();
             delayUntilEventOrTimeout(1.0_s);
             continue; // bypass displayState evaluation
         }
 
+        initialAlarm = true; // alarm is off again, the next one starts a new timeline
+
         checkIfGoToStandby();
+        renderFrame();
         evaluateDisplayState();
+        persistSettings();
     }
 };
 
 // -----------------------------------------------------------------
-/// draw display with clock and blinking alarm LEDs
-void StateMachine::showClockWithBlinkingAlarm()
-{
-    auto currentClockTime = rtc.getClockTime();
-    display.setClock(currentClockTime);
-    display.showClock();
-    bool shouldBlink = currentClockTime.second % 2 == 0;
-    statusLeds.ledAlarm1.setState(shouldBlink && (rtc.getAlarmMode() == RealTimeClock::AlarmMode::Alarm1 ||
-                                                  rtc.getAlarmMode() == RealTimeClock::AlarmMode::Both));
-    statusLeds.ledAlarm2.setState(shouldBlink && (rtc.getAlarmMode() == RealTimeClock::AlarmMode::Alarm2 ||
-                                                  rtc.getAlarmMode() == RealTimeClock::AlarmMode::Both));
+/// redraw the display only if at least one input of the current screen has changed
+void StateMachine::renderFrame()
+{
+    const auto Inputs = collectRenderInputs();
+
+    if (hasRenderedOnce && Inputs == lastRenderInputs)
+    {
+        display.skipFrame();
+        return;
+    }
+
+    hasRenderedOnce = true;
+    lastRenderInputs = Inputs;
+
+    display.clearGridDataArray();
+    renderScreen();
+    display.publishFrame();
+}
+
+// -----------------------------------------------------------------
+/// collect all values the current screen depends on, unused fields stay at their defaults
+StateMachine::RenderInputs StateMachine::collectRenderInputs()
+{
+    RenderInputs inputs{};
+    inputs.displayState = displayState;
+    inputs.isAlarmActive = rtc.getAlarmState() != RealTimeClock::AlarmState::Off;
+
+    auto takeTime = [&inputs](const Time &time, bool withSeconds)
+    {
+        inputs.hour = time.hour;
+        inputs.minute = time.minute;
+        inputs.isSecondEven = withSeconds && (time.second % 2) == 0;
+    };
+
+    if (inputs.isAlarmActive)
+    {
+        takeTime(rtc.getClockTime(), true);
+        return inputs;
+    }
+
+    switch (displayState)
+    {
+    case DisplayState::Clock:
+    case DisplayState::ClockWithAlarmLeds:
+        takeTime(rtc.getClockTime(), true);
+        break;
+
+    case DisplayState::DisplayAlarm:
+        takeTime(timeToModify, false);
+        inputs.alarmIndex = alarmIndex;
+        inputs.packedAlarm = rtc.getAlarm(alarmIndex).pack();
+        break;
+
+    case DisplayState::ChangeAlarmHour:
+    case DisplayState::ChangeAlarmMinute:
+        inputs.alarmIndex = alarmIndex;
+        [[fallthrough]];
+    case DisplayState::ChangeClockHour:
+    case DisplayState::ChangeClockMinute:
+        takeTime(timeToModify, false);
+        inputs.blink = blink;
+        break;
+
+    case DisplayState::DisplayAlarmStatus:
+        inputs.areAlarmsEnabled = rtc.areAlarmsEnabled();
+        inputs.enabledAlarms = countEnabledAlarms();
+        break;
+
+    case DisplayState::LedBrightness:
+        inputs.brightness = ledStrip.getGlobalBrightness();
+        break;
+
+    case DisplayState::LedCCT:
+        inputs.colorTemperature = ledStrip.getColorTemperature();
+        break;
+
+    default:
+        break;
+    }
+
+    return inputs;
+}
+
+// -----------------------------------------------------------------
+void StateMachine::renderScreen()
+{
+    if (rtc.getAlarmState() != RealTimeClock::AlarmState::Off)
+    {
+        display.setClock(rtc.getClockTime());
+        display.showClock();
+        return;
+    }
+
+    switch (displayState)
+    {
+    case DisplayState::Clock:
+    case DisplayState::ClockWithAlarmLeds:
+        display.setClock(rtc.getClockTime());
+        display.showClock();
+        break;
+
+    case DisplayState::DisplayAlarm:
+        showAlarm();
+        break;
+
+    case DisplayState::ChangeAlarmHour:
+        showHourChanging();
+        showAlarmNumber();
+        break;
+
+    case DisplayState::ChangeClockHour:
+        showHourChanging();
+        break;
+
+    case DisplayState::ChangeAlarmMinute:
+        showMinuteChanging();
+        showAlarmNumber();
+        break;
+
+    case DisplayState::ChangeClockMinute:
+        showMinuteChanging();
+        break;
+
+    case DisplayState::DisplayAlarmStatus:
+        showAlarmStatus();
+        break;
+
+    case DisplayState::LedBrightness:
+        showCurrentBrightness();
+        break;
+
+    case DisplayState::LedCCT:
+        showCurrentCCT();
+        break;
+
+    default:
+        break;
+    }
+}
+
+// -----------------------------------------------------------------
+/// The alarm LEDs of the current screen are set by the screen itself, all others are off. So every
+/// LED is set only once per cycle and an unchanged LED does not wake up the LED service.
+void StateMachine::turnOffUnusedAlarmLeds()
+{
+    bool isFirstLedUsed = rtc.getAlarmState() != RealTimeClock::AlarmState::Off;
+    bool isSecondLedUsed = isFirstLedUsed;
+
+    switch (displayState)
+    {
+    case DisplayState::ClockWithAlarmLeds:
+    case DisplayState::DisplayAlarmStatus:
+        isFirstLedUsed = true;
+        isSecondLedUsed = true;
+        break;
+
+    case DisplayState::DisplayAlarm:
+    case DisplayState::ChangeAlarmHour:
+    case DisplayState::ChangeAlarmMinute:
+        isFirstLedUsed = true;
+        break;
+
+    default:
+        break;
+    }
+
+    if (!isFirstLedUsed)
+        statusLeds.ledAlarm1.turnOff();
+
+    if (!isSecondLedUsed)
+        statusLeds.ledAlarm2.turnOff();
+}
+
+// -----------------------------------------------------------------
+/// blink alarm LEDs while alarm is active
+void StateMachine::showBlinkingAlarmLeds()
+{
+    bool shouldBlink = rtc.getClockTime().second % 2 == 0;
+    statusLeds.ledAlarm1.setState(shouldBlink);
+    statusLeds.ledAlarm2.setState(shouldBlink);
 }
 
 //-----------------------------------------------------------------
@@ -82,18 +250,11 @@ void StateMachine::evaluateDisplayState()
         break;
 
     case DisplayState::Clock:
-        display.setClock(rtc.getClockTime());
-        display.showClock();
         delayUntilEventOrTimeout(1.0_s);
         break;
 
     case DisplayState::ClockWithAlarmLeds:
-        display.setClock(rtc.getClockTime());
-        display.showClock();
-        statusLeds.ledAlarm1.setState(rtc.getAlarmMode() == RealTimeClock::AlarmMode::Alarm1 ||
-                                      rtc.getAlarmMode() == RealTimeClock::AlarmMode::Both);
-        statusLeds.ledAlarm2.setState(rtc.getAlarmMode() == RealTimeClock::AlarmMode::Alarm2 ||
-                                      rtc.getAlarmMode() == RealTimeClock::AlarmMode::Both);
+        showArmedAlarmLeds();
         if (delayUntilEventOrTimeout(1.0_s))
             if (secondsCounter++ >= 3)
             {
@@ -102,76 +263,41 @@ void StateMachine::evaluateDisplayState()
             }
         break;
 
-    case DisplayState::DisplayAlarm1:
-        display.setClock(rtc.getAlarmTime1());
-        display.showClock(true);
+    case DisplayState::DisplayAlarm:
         statusLeds.ledAlarm1.setState(blink);
         blink = !blink;
         delayUntilEventOrTimeout(500.0_ms);
         break;
 
-    case DisplayState::DisplayAlarm2:
-        display.setClock(rtc.getAlarmTime2());
-        display.showClock(true);
-        statusLeds.ledAlarm2.setState(blink);
-        blink = !blink;
-        delayUntilEventOrTimeout(500.0_ms);
-        break;
-
-    case DisplayState::ChangeAlarm1Hour:
-        showHourChanging();
-        statusLeds.ledAlarm1.turnOn();
-        blink = !blink;
-        delayUntilEventOrTimeout(500.0_ms);
-        break;
-
-    case DisplayState::ChangeAlarm2Hour:
-        showHourChanging();
-        statusLeds.ledAlarm2.turnOn();
-        blink = !blink;
-        delayUntilEventOrTimeout(500.0_ms);
-        break;
-
-    case DisplayState::ChangeAlarm1Minute:
-        showMinuteChanging();
+    case DisplayState::ChangeAlarmHour:
+    case DisplayState::ChangeAlarmMinute:
         statusLeds.ledAlarm1.turnOn();
         blink = !blink;
         delayUntilEventOrTimeout(500.0_ms);
         break;
 
-    case DisplayState::ChangeAlarm2Minute:
-        showMinuteChanging();
-        statusLeds.ledAlarm2.turnOn();
-        blink = !blink;
-        delayUntilEventOrTimeout(500.0_ms);
-        break;
-
     case DisplayState::DisplayAlarmStatus:
-        showCurrentAlarmMode();
+        showArmedAlarmLeds();
         if (delayUntilEventOrTimeout(3.0_s))
             goToDefaultState();
         break;
 
     case DisplayState::ChangeClockHour:
-        showHourChanging();
         blink = !blink;
         delayUntilEventOrTimeout(500.0_ms);
         break;
 
     case DisplayState::ChangeClockMinute:
-        showMinuteChanging();
         blink = !blink;
         delayUntilEventOrTimeout(500.0_ms);
         break;
 
     case DisplayState::LedBrightness:
-        showCurrentBrightness();
         if (delayUntilEventOrTimeout(4.0_s))
             restorePreviousState();
         break;
 
     case DisplayState::LedCCT:
-        showCurrentCCT();
         if (delayUntilEventOrTimeout(4.0_s))
             restorePreviousState();
         break;
@@ -197,11 +323,129 @@ void StateMachine::displayLedInitialization()
 }
 
 //-----------------------------------------------------------------
+/// a missing RTC is signaled by FaultIndicator
 void StateMachine::waitForRtc()
 {
-    statusLeds.ledRedGreen.setColorBlinking(util::led::pwm::DualLedColor::Red, 2.0_Hz);
-    syncEventGroup.waitBits(sync::RtcHasRespondedOnce, pdFALSE, pdFALSE, portMAX_DELAY);
-    statusLeds.ledRedGreen.turnOff();
+    syncEventGroup.waitBits(synchronization::RtcHasRespondedOnce, pdFALSE, pdFALSE, portMAX_DELAY);
+}
+
+//-----------------------------------------------------------------
+/// the settings may live in the EEPROM of the RTC module, so the RTC has to be online before
+void StateMachine::restoreSettings()
+{
+    settings.mount();
+
+    if (const auto Brightness = settings.get(SettingsKey::LedBrightness))
+        ledStrip.setGlobalBrightness(*Brightness);
+
+    if (const auto ColorTemperature = settings.get(SettingsKey::ColorTemperature))
+        ledStrip.setColorTemperature(*ColorTemperature);
+
+    const auto AlarmsEnabled = settings.get(SettingsKey::AlarmsEnabled);
+    if (AlarmsEnabled)
+        rtc.setAlarmsEnabled(*AlarmsEnabled != 0);
+
+    if (const auto Sequence = settings.get(SettingsKey::AlarmSequence))
+        alarmEngine.setSequence(AlarmSequence::unpack(*Sequence).value_or(AlarmSequence{}));
+
+    for (uint8_t i = 0; i < MaximumAlarms; i++)
+    {
+        const auto Key = static_cast<SettingsKey>(static_cast<uint8_t>(SettingsKey::FirstVibrationPattern) + i);
+        const auto Pattern = settings.get(Key);
+        if (Pattern && *Pattern < vibration::Patterns.size())
+            alarmEngine.setVibrationPattern(i, static_cast<vibration::PatternId>(*Pattern));
+    }
+
+    if (settings.get(SettingsKey::FirstAlarm))
+    {
+        for (uint8_t i = 0; i < MaximumAlarms; i++)
+        {
+            const auto Key = static_cast<SettingsKey>(static_cast<uint8_t>(SettingsKey::FirstAlarm) + i);
+            const auto Packed = settings.get(Key);
+            rtc.setAlarm(i, Packed ? Alarm::unpack(*Packed).value_or(Alarm{}) : Alarm{});
+        }
+        return;
+    }
+
+    // Older firmware has kept the times of two alarms in the alarm registers of the DS3231 and has
+    // stored their mode (1 = first, 2 = second, 3 = both) and their weekdays. The registers are
+    // re-purposed as soon as an alarm is set, so the alarms are stored before.
+    const SettingsKey WeekdayKeys[] = {SettingsKey::Alarm1Weekdays, SettingsKey::Alarm2Weekdays};
+    const auto FormerAlarmTimes = rtc.getFormerAlarmTimes();
+    std::array<Alarm, MaximumAlarms> alarms{};
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        const auto &AlarmTime = FormerAlarmTimes[i];
+        if (AlarmTime.hour >= 24 || AlarmTime.minute >= 60)
+            continue;
+
+        // cap alarm minutes to factor 5
+        alarms[i].minuteOfDay = AlarmTime.hour * 60 + AlarmTime.minute - AlarmTime.minute % 5;
+        alarms[i].isEnabled = !AlarmsEnabled || (*AlarmsEnabled & (1U << i)) != 0;
+
+        if (const auto Weekdays = settings.get(WeekdayKeys[i]))
+            alarms[i].weekdays = *Weekdays & Alarm::EveryDay;
+    }
+
+    for (uint8_t i = 0; i < MaximumAlarms; i++)
+    {
+        const auto Key = static_cast<SettingsKey>(static_cast<uint8_t>(SettingsKey::FirstAlarm) + i);
+        settings.set(Key, alarms[i].pack());
+    }
+
+    // the flush is retried by the flush timer, the registers are kept until it succeeds
+    if (!settings.flush())
+        rtc.keepFormerAlarmRegisters(true);
+
+    for (uint8_t i = 0; i < MaximumAlarms; i++)
+        rtc.setAlarm(i, alarms[i]);
+}
+
+//-----------------------------------------------------------------
+/// Runs once after the update from older firmware. The marker is stored first, so a power loss in
+/// between may leave local time in the RTC until the next sync, but the time is never converted twice.
+void StateMachine::convertRtcToUtc()
+{
+    if (settings.get(SettingsKey::RtcKeepsUtc) == 1)
+        return;
+
+    settings.set(SettingsKey::RtcKeepsUtc, 1);
+    if (!settings.flush())
+    {
+        // the RTC is left alone, the conversion is tried again at the next start
+        settings.set(SettingsKey::RtcKeepsUtc, 0);
+        return;
+    }
+
+    rtc.convertLocalTimeToUtc();
+}
+
+//-----------------------------------------------------------------
+/// only changed values are written, delayed and coalesced by Settings
+void StateMachine::persistSettings()
+{
+    settings.set(SettingsKey::LedBrightness, ledStrip.getGlobalBrightness());
+    settings.set(SettingsKey::ColorTemperature, ledStrip.getColorTemperature());
+    settings.set(SettingsKey::AlarmsEnabled, rtc.areAlarmsEnabled() ? 1 : 0);
+
+    for (uint8_t i = 0; i < MaximumAlarms; i++)
+    {
+        const auto Key = static_cast<SettingsKey>(static_cast<uint8_t>(SettingsKey::FirstAlarm) + i);
+        settings.set(Key, rtc.getAlarm(i).pack());
+
+        const auto PatternKey =
+            static_cast<SettingsKey>(static_cast<uint8_t>(SettingsKey::FirstVibrationPattern) + i);
+        settings.set(PatternKey, static_cast<uint32_t>(alarmEngine.getVibrationPattern(i)));
+    }
+
+    settings.set(SettingsKey::AlarmSequence, alarmEngine.getSequence().pack());
+
+    // the flush timer only marks the write as due, it blocks the bus or the flash for some milliseconds
+    settings.flushIfDue();
+
+    if (!settings.hasPendingChanges())
+        rtc.keepFormerAlarmRegisters(false);
 }
 
 //-----------------------------------------------------------------
@@ -229,37 +473,69 @@ void StateMachine::showMinuteChanging()
 }
 
 //-----------------------------------------------------------------
-void StateMachine::showCurrentAlarmMode()
+/// timeToModify holds the alarm time read once when entering this screen, so the RTC must not be
+/// polled for every frame. The last grid shows an alarm which is off or skips its next ring.
+void StateMachine::showAlarm()
+{
+    display.setClock(timeToModify);
+    display.showClock(true);
+    showAlarmNumber();
+
+    const auto ShownAlarm = rtc.getAlarm(alarmIndex);
+    if (!ShownAlarm.isEnabled)
+        display.getGridDataArray()[5].segments = font.getGlyph('-');
+
+    else if (ShownAlarm.isSkippingNext)
+        display.getGridDataArray()[5].segments = font.getGlyph('S');
+}
+
+//-----------------------------------------------------------------
+void StateMachine::showAlarmNumber()
+{
+    display.getGridDataArray()[0].segments = font.getGlyph('1' + alarmIndex);
+}
+
+//-----------------------------------------------------------------
+/// "A:Off" if all alarms are switched off, the number of enabled alarms otherwise
+void StateMachine::showAlarmStatus()
 {
     display.getGridDataArray()[2].segments = font.getGlyph('A');
     display.getGridDataArray()[2].enableDots = true;
 
-    switch (rtc.getAlarmMode())
+    if (!rtc.areAlarmsEnabled())
     {
-    case RealTimeClock::AlarmMode::Off:
         display.getGridDataArray()[3].segments = font.getGlyph('O');
         display.getGridDataArray()[4].segments = font.getGlyph('f');
         display.getGridDataArray()[5].segments = font.getGlyph('f');
-        break;
-
-    case RealTimeClock::AlarmMode::Alarm1:
-        display.getGridDataArray()[4].segments = font.getGlyph('1');
-        statusLeds.ledAlarm1.turnOn();
-        break;
+        return;
+    }
 
-    case RealTimeClock::AlarmMode::Alarm2:
-        display.getGridDataArray()[4].segments = font.getGlyph('2');
-        statusLeds.ledAlarm2.turnOn();
-        break;
+    display.getGridDataArray()[4].segments = font.getGlyph('0' + countEnabledAlarms());
+}
 
-    case RealTimeClock::AlarmMode::Both:
-        display.getGridDataArray()[3].segments = font.getGlyph('1');
-        display.getGridDataArray()[4].segments = font.getGlyph('+');
-        display.getGridDataArray()[5].segments = font.getGlyph('2');
-        statusLeds.ledAlarm1.turnOn();
-        statusLeds.ledAlarm2.turnOn();
-        break;
+//-----------------------------------------------------------------
+/// the first LED shows that an alarm is going to ring, the second one that a ring is skipped
+void StateMachine::showArmedAlarmLeds()
+{
+    bool isSkipping = false;
+    for (uint8_t i = 0; i < MaximumAlarms; i++)
+    {
+        const auto ArmedAlarm = rtc.getAlarm(i);
+        isSkipping |= ArmedAlarm.isEnabled && ArmedAlarm.isSkippingNext;
     }
+
+    statusLeds.ledAlarm1.setState(rtc.areAlarmsEnabled() && countEnabledAlarms() != 0);
+    statusLeds.ledAlarm2.setState(rtc.areAlarmsEnabled() && isSkipping);
+}
+
+//-----------------------------------------------------------------
+uint8_t StateMachine::countEnabledAlarms()
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MaximumAlarms; i++)
+        count += rtc.getAlarm(i).isEnabled ? 1 : 0;
+
+    return count;
 }
 
 //-----------------------------------------------------------------
@@ -277,7 +553,7 @@ void StateMachine::showCurrentBrightness()
 //-----------------------------------------------------------------
 void StateMachine::showCurrentCCT()
 {
-    const uint16_t Cct = ledStrip.getColorTemperature().getMagnitude<uint16_t>();
+    const uint16_t Cct = ledStrip.getColorTemperature();
 
     display.getGridDataArray()[1].segments = font.getGlyph('0' + Cct / 1000);
     display.getGridDataArray()[1].segments = font.getGlyph('0' + Cct / 1000);
@@ -294,6 +570,7 @@ void StateMachine::updateDisplayState(DisplayState newState)
         display.enableDisplay();
 
     displayState = newState;
+    trace::record<trace::Event::DisplayState>(static_cast<uint16_t>(newState));
 
     if (displayState == DisplayState::Standby)
         display.disableDisplay();
@@ -321,6 +598,48 @@ void StateMachine::goToDefaultState()
     updateDisplayState(DisplayState::ClockWithAlarmLeds);
 }
 
+//-----------------------------------------------------------------
+void StateMachine::showAlarmPage(uint8_t index)
+{
+    alarmIndex = index;
+
+    const auto MinuteOfDay = rtc.getAlarm(index).minuteOfDay;
+    timeToModify = Time(MinuteOfDay / 60, MinuteOfDay % 60, 0);
+    updateDisplayState(DisplayState::DisplayAlarm);
+}
+
+//-----------------------------------------------------------------
+/// a changed alarm is enabled and rings next time, like the alarm mode was set before
+void StateMachine::saveAlarmTime()
+{
+    auto changedAlarm = rtc.getAlarm(alarmIndex);
+    changedAlarm.minuteOfDay = timeToModify.hour * 60 + timeToModify.minute;
+    changedAlarm.isEnabled = true;
+    changedAlarm.isSkippingNext = false;
+
+    rtc.setAlarm(alarmIndex, changedAlarm);
+    rtc.setAlarmsEnabled(true);
+    signalResult(true);
+}
+
+//-----------------------------------------------------------------
+/// on, skipping the next ring, off
+void StateMachine::cycleAlarmState()
+{
+    auto changedAlarm = rtc.getAlarm(alarmIndex);
+
+    if (!changedAlarm.isEnabled)
+        changedAlarm.isEnabled = true;
+
+    else if (!changedAlarm.isSkippingNext)
+        changedAlarm.isSkippingNext = true;
+
+    else
+        changedAlarm.isEnabled = changedAlarm.isSkippingNext = false;
+
+    rtc.setAlarm(alarmIndex, changedAlarm);
+}
+
 //-----------------------------------------------------------------
 void StateMachine::savePreviousState()
 {
@@ -336,13 +655,21 @@ void StateMachine::restorePreviousState()
 //-----------------------------------------------------------------
 void StateMachine::assignButtonCallbacks()
 {
-    buttons.left.setCallback(std::bind(&StateMachine::buttonLeftCallback, this, std::placeholders::_1));
-    buttons.right.setCallback(std::bind(&StateMachine::buttonRightCallback, this, std::placeholders::_1));
-    buttons.snooze.setCallback(std::bind(&StateMachine::buttonSnoozeCallback, this, std::placeholders::_1));
-    buttons.brightnessPlus.setCallback(
-        std::bind(&StateMachine::buttonBrightnessPlusCallback, this, std::placeholders::_1));
-    buttons.brightnessMinus.setCallback(
-        std::bind(&StateMachine::buttonBrightnessMinusCallback, this, std::placeholders::_1));
-    buttons.cctPlus.setCallback(std::bind(&StateMachine::buttonCCTPlusCallback, this, std::placeholders::_1));
-    buttons.cctMinus.setCallback(std::bind(&StateMachine::buttonCCTMinusCallback, this, std::placeholders::_1));
+    auto assign = [this](util::Button &button, trace::Button id, void (StateMachine::*callback)(util::Button::Action))
+    {
+        button.setCallback(
+            [this, id, callback](util::Button::Action action)
+            {
+                trace::record<trace::Event::ButtonAction>(static_cast<uint8_t>(id) << 8 | static_cast<uint8_t>(action));
+                (this->*callback)(action);
+            });
+    };
+
+    assign(buttons.left, trace::Button::Left, &StateMachine::buttonLeftCallback);
+    assign(buttons.right, trace::Button::Right, &StateMachine::buttonRightCallback);
+    assign(buttons.snooze, trace::Button::Snooze, &StateMachine::buttonSnoozeCallback);
+    assign(buttons.brightnessPlus, trace::Button::BrightnessPlus, &StateMachine::buttonBrightnessPlusCallback);
+    assign(buttons.brightnessMinus, trace::Button::BrightnessMinus, &StateMachine::buttonBrightnessMinusCallback);
+    assign(buttons.cctPlus, trace::Button::CctPlus, &StateMachine::buttonCCTPlusCallback);
+    assign(buttons.cctMinus, trace::Button::CctMinus, &StateMachine::buttonCCTMinusCallback);
 }
\ No newline at end of file
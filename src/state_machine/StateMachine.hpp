@@ -2,9 +2,12 @@
 
 #include "LED/LedStrip.hpp"
 #include "LED/StatusLeds.hpp"
+#include "alarm/AlarmEngine.hpp"
 #include "buttons/Buttons.hpp"
+#include "diagnostics/Trace.hpp"
 #include "display/Display.hpp"
 #include "rtc/RealTimeClock.hpp"
+#include "settings/Settings.hpp"
 
 #include "util/gpio.hpp"
 #include "wrappers/Task.hpp"
@@ -15,13 +18,15 @@ class StateMachine : public util::wrappers::TaskWithMemberFunctionBase
 {
 public:
     StateMachine(Display &display, StatusLeds &statusLeds, LedStrip &ledStrip, Buttons &buttons, RealTimeClock &rtc,
-                 TimerCallbackFunction_t timeoutCallback)
+                 AlarmEngine &alarmEngine, Settings &settings, TimerCallbackFunction_t timeoutCallback)
         : TaskWithMemberFunctionBase("stateMachineTask", 512, osPriorityBelowNormal4), //
           display(display),                                                            //
           statusLeds(statusLeds),                                                      //
           ledStrip(ledStrip),                                                          //
           buttons(buttons),                                                            //
           rtc(rtc),                                                                    //
+          alarmEngine(alarmEngine),                                                    //
+          settings(settings),                                                          //
           timeoutCallback(timeoutCallback)
     {
         assignButtonCallbacks();
@@ -32,12 +37,9 @@ public:
         Standby,
         Clock,
         ClockWithAlarmLeds,
-        DisplayAlarm1,
-        DisplayAlarm2,
-        ChangeAlarm1Hour,
-        ChangeAlarm1Minute,
-        ChangeAlarm2Hour,
-        ChangeAlarm2Minute,
+        DisplayAlarm,
+        ChangeAlarmHour,
+        ChangeAlarmMinute,
         ChangeClockHour,
         ChangeClockMinute,
         DisplayAlarmStatus,
@@ -57,6 +59,8 @@ private:
     LedStrip &ledStrip;
     Buttons &buttons;
     RealTimeClock &rtc;
+    AlarmEngine &alarmEngine;
+    Settings &settings;
 
     DisplayState displayState = DisplayState::Clock;
     DisplayState previousDisplayState = DisplayState::Standby;
@@ -64,20 +68,53 @@ private:
     size_t secondsCounter = 0;
 
     bool initialAlarm = true;
-    size_t alarmStateCounter = 0;
 
     Time timeToModify;
+    uint8_t alarmIndex = 0; // of the alarm page
 
-    void showClockWithBlinkingAlarm();
+    /// everything a screen depends on, a frame is only rendered if one of them has changed
+    struct RenderInputs
+    {
+        DisplayState displayState = DisplayState::Standby;
+        bool isAlarmActive = false;
+        uint8_t hour = 0;
+        uint8_t minute = 0;
+        bool isSecondEven = false;
+        uint8_t alarmIndex = 0;
+        uint32_t packedAlarm = 0;
+        bool areAlarmsEnabled = false;
+        uint8_t enabledAlarms = 0;
+        uint8_t brightness = 0;
+        uint16_t colorTemperature = 0;
+        bool blink = false;
+
+        bool operator==(const RenderInputs &) const = default;
+    };
+
+    RenderInputs lastRenderInputs{};
+    bool hasRenderedOnce = false;
+
+    void renderFrame();
+    RenderInputs collectRenderInputs();
+    void renderScreen();
+
+    void turnOffUnusedAlarmLeds();
+    void showBlinkingAlarmLeds();
     void evaluateDisplayState();
     void checkIfGoToStandby();
 
     void displayLedInitialization();
     void waitForRtc();
+    void restoreSettings();
+    void convertRtcToUtc();
+    void persistSettings();
 
     void showHourChanging();
     void showMinuteChanging();
-    void showCurrentAlarmMode();
+    void showAlarm();
+    void showAlarmNumber();
+    void showAlarmStatus();
+    void showArmedAlarmLeds();
     void showCurrentBrightness();
     void showCurrentCCT();
 
@@ -87,6 +124,10 @@ private:
     void savePreviousState();
     void restorePreviousState();
     void goToDefaultState();
+    void showAlarmPage(uint8_t index);
+    void saveAlarmTime();
+    void cycleAlarmState();
+    uint8_t countEnabledAlarms();
 
     void assignButtonCallbacks();
 
@@ -108,8 +149,11 @@ private:
 
     TimerCallbackFunction_t timeoutCallback = nullptr;
 
+    StaticTimer_t timeoutTimerBuffer{};
+
     // with enabled auto reload
-    TimerHandle_t timeoutTimer{xTimerCreate("timeoutTimer", toOsTicks(4.0_s), pdTRUE, nullptr, timeoutCallback)};
+    TimerHandle_t timeoutTimer{xTimerCreateStatic("timeoutTimer", toOsTicks(4.0_s), pdTRUE, nullptr, timeoutCallback,
+                                                  &timeoutTimerBuffer)};
 
     void setTimeoutAndStart(units::si::Time period)
     {
@@ -1,6 +1,6 @@
 #include "wrappers/EventGroup.hpp"
 
-namespace sync
+namespace synchronization
 {
 constexpr EventBits_t RtcHasRespondedOnce = 1 << 1;
-} // namespace sync
\ No newline at end of file
+} // namespace synchronization
\ No newline at end of file
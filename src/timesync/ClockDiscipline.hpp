@@ -0,0 +1,168 @@
+#pragma once
+
+#include "rtc/Calendar.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+
+/// Maths of the time synchronization, independent of the hardware.
+/// All times are milliseconds. Local times are milliseconds of the day.
+namespace timesync
+{
+constexpr int64_t MillisecondsPerDay = 24 * 60 * 60 * 1000;
+
+/// result of one request/response exchange
+struct Sample
+{
+    int64_t offset;     // server time minus local tick count
+    uint32_t roundTrip; // without the processing time of the server
+};
+
+/// NTP on-wire calculation
+/// @param originateTime local tick count when the request was sent
+/// @param receiveTime server time when the request has arrived
+/// @param transmitTime server time when the response was sent
+/// @param destinationTime local tick count when the response has arrived
+constexpr Sample calculateSample(uint32_t originateTime, int64_t receiveTime, int64_t transmitTime,
+                                 uint32_t destinationTime)
+{
+    const int64_t RoundTrip = static_cast<uint32_t>(destinationTime - originateTime) - (transmitTime - receiveTime);
+
+    // the tick count may have wrapped around, but not during the exchange
+    const int64_t Originate = destinationTime - static_cast<uint32_t>(destinationTime - originateTime);
+    const int64_t Offset = ((receiveTime - Originate) + (transmitTime - destinationTime)) / 2;
+
+    return {Offset, static_cast<uint32_t>(std::max<int64_t>(RoundTrip, 0))};
+}
+
+static_assert(calculateSample(1000, 5100, 5110, 1030).offset == 4090);
+static_assert(calculateSample(1000, 5100, 5110, 1030).roundTrip == 20);
+
+constexpr int64_t wrapToDay(int64_t milliseconds)
+{
+    return ((milliseconds % MillisecondsPerDay) + MillisecondsPerDay) % MillisecondsPerDay;
+}
+
+/// @return local time of the day for an UTC time
+constexpr int64_t toLocalTimeOfDay(int64_t utcTime, int16_t utcOffset)
+{
+    return wrapToDay(utcTime + utcOffset * 60 * 1000);
+}
+
+/// milliseconds from 1970-01-01 to 2000-01-01, where the calendar of the RTC begins
+constexpr int64_t UnixTimeOf2000 = 946'684'800'000;
+
+/// @return instant of the RTC calendar for an UTC time, times before 2000 are taken as 2000-01-01
+constexpr calendar::Instant toInstant(int64_t utcTime)
+{
+    return static_cast<calendar::Instant>(std::max<int64_t>(utcTime - UnixTimeOf2000, 0) / 1000);
+}
+
+static_assert(toInstant(UnixTimeOf2000 + 86'400'999) == calendar::SecondsPerDay);
+static_assert(toInstant(0) == 0);
+
+/// @return a - b as short way around midnight, between -12 h and +12 h
+constexpr int64_t getDifferenceOfDay(int64_t a, int64_t b)
+{
+    const auto Difference = wrapToDay(a - b);
+    return Difference >= MillisecondsPerDay / 2 ? Difference - MillisecondsPerDay : Difference;
+}
+
+static_assert(getDifferenceOfDay(100, MillisecondsPerDay - 100) == 200);
+static_assert(getDifferenceOfDay(MillisecondsPerDay - 100, 100) == -200);
+
+/// Decides when the RTC has to be set and tunes its aging offset against the drift.
+///
+/// The RTC is only set if its error exceeds a threshold, otherwise the error keeps growing
+/// and reveals the drift. The drift is measured since the aging offset has changed last time,
+/// the steps of setting the RTC are taken out of it. Each error is only known within half of
+/// the round trip, so the aging offset is changed only if the drift is larger than this
+/// uncertainty. Until then the measuring period keeps growing and the uncertainty shrinks.
+/// A single change is limited to one ppm, so a bad measurement cannot detune the oscillator.
+class ClockDiscipline
+{
+public:
+    static constexpr int32_t AlignmentThreshold = 50;
+    static constexpr uint32_t MinimumDriftInterval = 6 * 60 * 60 * 1000;
+    static constexpr float PpmPerAgingStep = 0.1f;
+    static constexpr int32_t MaximumAgingChange = 10;
+
+    struct Decision
+    {
+        bool shouldAlign;
+        std::optional<int8_t> newAgingOffset;
+    };
+
+    /// @param error RTC time minus server time at tick
+    /// @param uncertainty maximum deviation of error from the true value
+    Decision update(int32_t error, uint32_t uncertainty, uint32_t tick, int8_t agingOffset)
+    {
+        lastError = error;
+        lastUncertainty = uncertainty;
+
+        Decision decision{!hasReference || error > AlignmentThreshold || error < -AlignmentThreshold, {}};
+
+        const uint32_t Elapsed = tick - referenceTick;
+        if (!hasReference || Elapsed < MinimumDriftInterval)
+            return decision;
+
+        // positive drift means the RTC is too fast, which is slowed down by a higher aging offset
+        const float DriftPpm = (error - referenceError) * 1e6f / Elapsed;
+        const float UncertaintyPpm = (uncertainty + referenceUncertainty) * 1e6f / Elapsed;
+
+        const float SignificantDrift = std::max(std::abs(DriftPpm) - UncertaintyPpm, 0.0f);
+        const auto Steps =
+            std::min(static_cast<int32_t>(SignificantDrift / PpmPerAgingStep + 0.5f), MaximumAgingChange);
+        if (Steps == 0)
+            return decision;
+
+        const auto NewOffset = std::clamp<int32_t>(agingOffset + (DriftPpm < 0 ? -Steps : Steps), INT8_MIN, INT8_MAX);
+        if (NewOffset != agingOffset)
+            decision.newAgingOffset = static_cast<int8_t>(NewOffset);
+
+        // the next drift is measured with the new offset
+        setReference(tick, error, uncertainty);
+        return decision;
+    }
+
+    /// called after the RTC was set to the server time of the last update
+    void markAligned(uint32_t tick)
+    {
+        if (!hasReference)
+        {
+            hasReference = true;
+            setReference(tick, 0, lastUncertainty);
+            return;
+        }
+
+        // the error has been set to zero, which must not be taken as drift
+        referenceError -= lastError;
+        referenceUncertainty += lastUncertainty;
+    }
+
+private:
+    bool hasReference = false;
+    uint32_t referenceTick = 0;
+    int32_t referenceError = 0;
+    uint32_t referenceUncertainty = 0;
+
+    int32_t lastError = 0;
+    uint32_t lastUncertainty = 0;
+
+    void setReference(uint32_t tick, int32_t error, uint32_t uncertainty)
+    {
+        referenceTick = tick;
+        referenceError = error;
+        referenceUncertainty = uncertainty;
+    }
+};
+
+/// @return ticks until the server time reaches the next full second
+constexpr uint32_t getTicksToNextSecond(int64_t serverTime)
+{
+    return 1000 - static_cast<uint32_t>(wrapToDay(serverTime) % 1000);
+}
+} // namespace timesync
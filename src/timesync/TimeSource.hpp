@@ -0,0 +1,20 @@
+#pragma once
+
+#include "link/LinkMessages.hpp"
+
+#include <cstdint>
+
+/// server of the network time, e.g. the ESP co-processor
+class TimeSource
+{
+public:
+    /// sends a TimeRequest, the response is passed to the TimeResponseHandler
+    virtual void requestTime() = 0;
+};
+
+class TimeResponseHandler
+{
+public:
+    /// @param destinationTime tick count when the response has arrived
+    virtual void handleTimeResponse(const esp::TimeResponse &response, uint32_t destinationTime) = 0;
+};
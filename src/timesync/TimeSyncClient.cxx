@@ -0,0 +1,106 @@
+#include "TimeSyncClient.hpp"
+#include "sync.hpp"
+
+#include "task.h"
+
+#include <climits>
+
+void TimeSyncClient::taskMain(void *)
+{
+    syncEventGroup.waitBits(synchronization::RtcHasRespondedOnce, pdFALSE, pdFALSE, portMAX_DELAY);
+    vTaskDelay(toOsTicks(StartupDelay));
+
+    while (true)
+    {
+        const bool WasSuccessful = synchronize();
+        vTaskDelay(toOsTicks(WasSuccessful ? SyncInterval : RetryInterval));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+void TimeSyncClient::handleTimeResponse(const esp::TimeResponse &response, uint32_t destinationTime)
+{
+    lastResponse = response;
+    lastDestinationTime = destinationTime;
+    notify(1, util::wrappers::NotifyAction::SetBits);
+}
+
+//--------------------------------------------------------------------------------------------------
+bool TimeSyncClient::synchronize()
+{
+    std::optional<Measurement> best;
+    for (auto i = 0; i < NumberOfSamples; i++)
+    {
+        const auto Result = takeSample();
+        if (Result && (!best || Result->sample.roundTrip < best->sample.roundTrip))
+            best = Result;
+    }
+
+    if (!best || best->sample.roundTrip > MaximumRoundTrip)
+        return false;
+
+    const auto Edge = rtc.waitForSecondsEdge();
+    const auto AgingOffset = rtc.getAgingOffset();
+    if (!Edge || !AgingOffset)
+        return false;
+
+    const auto ServerTime = best->getServerTime(Edge->tick);
+    rtc.setStandardOffset(best->utcOffset - dst::getShift(timesync::toInstant(ServerTime)));
+
+    // the seconds register has just changed, so the sub-second part of the RTC is zero
+    const int64_t RtcTime = (Edge->time.hour * 3600 + Edge->time.minute * 60 + Edge->time.second) * 1000LL;
+    const auto NetworkTime = timesync::wrapToDay(ServerTime);
+    const auto Error = static_cast<int32_t>(timesync::getDifferenceOfDay(RtcTime, NetworkTime));
+
+    const auto Decision = discipline.update(Error, getUncertainty(*best), Edge->tick, *AgingOffset);
+    if (Decision.newAgingOffset && !rtc.writeAgingOffset(*Decision.newAgingOffset))
+        return false;
+
+    // a wrong date, e.g. of a RTC which was set to local time before, is not seen in the time of day
+    const bool IsDateWrong = calendar::getDayNumber(rtc.getUtcInstant()) !=
+                             calendar::getDayNumber(timesync::toInstant(ServerTime + Error));
+
+    if (Decision.shouldAlign || IsDateWrong)
+        alignClock(*best);
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+std::optional<TimeSyncClient::Measurement> TimeSyncClient::takeSample()
+{
+    // drop a late response of the previous request
+    notifyWait(ULONG_MAX, ULONG_MAX, (uint32_t *)0, 0);
+
+    const auto RequestTime = xTaskGetTickCount();
+    timeSource.requestTime();
+
+    while (notifyWait(ULONG_MAX, ULONG_MAX, (uint32_t *)0, toOsTicks(ResponseTimeout)) != 0)
+    {
+        // the request is sent by the serial task, so its originate time is at or after ours
+        const auto Response = lastResponse;
+        if (Response.originateTime - RequestTime > toOsTicks(ResponseTimeout))
+            continue;
+
+        const auto Sample = timesync::calculateSample(Response.originateTime, Response.receiveTime,
+                                                      Response.transmitTime, lastDestinationTime);
+        return Measurement{Sample, lastDestinationTime, Response.utcOffset};
+    }
+
+    return {};
+}
+
+//--------------------------------------------------------------------------------------------------
+void TimeSyncClient::alignClock(const Measurement &measurement)
+{
+    auto lastWakeTime = xTaskGetTickCount();
+
+    auto delay = timesync::getTicksToNextSecond(measurement.getServerTime(lastWakeTime));
+    if (delay < MinimumAlignmentDelay)
+        delay += 1000;
+
+    vTaskDelayUntil(&lastWakeTime, delay);
+
+    if (rtc.writeUtcTime(timesync::toInstant(measurement.getServerTime(lastWakeTime) + 500)))
+        discipline.markAligned(lastWakeTime);
+}
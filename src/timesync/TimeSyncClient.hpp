@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ClockDiscipline.hpp"
+#include "TimeSource.hpp"
+
+#include "helpers/freertos.hpp"
+#include "rtc/RealTimeClock.hpp"
+#include "wrappers/Task.hpp"
+
+#include <optional>
+
+/// Keeps the RTC in sync with the network time of the ESP.
+///
+/// Each sync takes some request/response samples and keeps the one with the shortest round trip,
+/// because its offset has the smallest error from asymmetric delays. The phase of the RTC is
+/// measured at its seconds edge. If the RTC is off by more than the alignment threshold, the time is
+/// written exactly when the network time reaches a full second; the DS3231 restarts its
+/// sub-second countdown with each write of the seconds register.
+///
+/// The RTC keeps UTC. The offset of the ESP includes daylight saving time, so the standard offset
+/// of the local time zone is learned by taking out the shift of the EU rules.
+class TimeSyncClient : public util::wrappers::TaskWithMemberFunctionBase, public TimeResponseHandler
+{
+public:
+    TimeSyncClient(RealTimeClock &rtc, TimeSource &timeSource)
+        : TaskWithMemberFunctionBase("timeSyncTask", 256, osPriorityBelowNormal7), //
+          rtc(rtc),                                                                //
+          timeSource(timeSource) {};
+
+    void handleTimeResponse(const esp::TimeResponse &response, uint32_t destinationTime) override;
+
+protected:
+    [[noreturn]] void taskMain(void *) override;
+
+private:
+    RealTimeClock &rtc;
+    TimeSource &timeSource;
+
+    // the ESP needs some time to get its own time via NTP
+    static constexpr auto StartupDelay = 30.0_s;
+    static constexpr auto SyncInterval = 3600.0_s;
+    static constexpr auto RetryInterval = 300.0_s;
+
+    static constexpr auto NumberOfSamples = 4;
+    static constexpr auto ResponseTimeout = 1.0_s;
+    static constexpr uint32_t MaximumRoundTrip = 250; // ms
+
+    // a full second must not be missed while writing the RTC
+    static constexpr uint32_t MinimumAlignmentDelay = 5; // ms
+
+    static_assert(configTICK_RATE_HZ == 1000, "the network time is based on ticks of one millisecond");
+
+    struct Measurement
+    {
+        timesync::Sample sample;
+        uint32_t tick; // destination time of the sample
+        int16_t utcOffset;
+
+        /// @return network time in milliseconds since 1970 at the given tick count
+        int64_t getServerTime(uint32_t now) const
+        {
+            // relative to the sample, so it works across an overflow of the tick count
+            return tick + sample.offset + static_cast<uint32_t>(now - tick);
+        }
+    };
+
+    // written by the serial task before it notifies this task
+    esp::TimeResponse lastResponse{};
+    uint32_t lastDestinationTime = 0;
+
+    timesync::ClockDiscipline discipline;
+
+    /// the offset is known within half of the round trip, the seconds edge within one tick
+    static uint32_t getUncertainty(const Measurement &measurement)
+    {
+        return measurement.sample.roundTrip / 2 + 1;
+    }
+
+    bool synchronize();
+    std::optional<Measurement> takeSample();
+    void alignClock(const Measurement &measurement);
+};
@@ -0,0 +1,63 @@
+#include "VibrationCushion.hpp"
+
+void VibrationCushion::play(vibration::PatternId patternId)
+{
+    player.start(vibration::getPattern(patternId));
+    applyNextStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+void VibrationCushion::stop()
+{
+    player.stop();
+    xTimerStop(stepTimer, 0);
+    setIntensity(0);
+}
+
+//--------------------------------------------------------------------------------------------------
+void VibrationCushion::handleStepTimer()
+{
+    applyNextStep();
+}
+
+//--------------------------------------------------------------------------------------------------
+void VibrationCushion::pwmTick()
+{
+    const uint8_t CurrentIntensity = intensity;
+
+    // pin is already set statically by setIntensity()
+    if (CurrentIntensity == 0 || CurrentIntensity >= vibration::MaximumIntensity)
+        return;
+
+    if (++pwmCounter >= vibration::MaximumIntensity)
+        pwmCounter = 0;
+
+    output.write(pwmCounter < CurrentIntensity);
+}
+
+//--------------------------------------------------------------------------------------------------
+void VibrationCushion::applyNextStep()
+{
+    const auto Step = player.nextStep();
+
+    if (!Step)
+    {
+        stop();
+        return;
+    }
+
+    setIntensity(Step->intensity);
+    xTimerChangePeriod(stepTimer, pdMS_TO_TICKS(Step->durationMs), 0); // this starts the timer too
+}
+
+//--------------------------------------------------------------------------------------------------
+void VibrationCushion::setIntensity(uint8_t newIntensity)
+{
+    intensity = newIntensity;
+
+    if (newIntensity == 0)
+        output.write(false);
+
+    else if (newIntensity >= vibration::MaximumIntensity)
+        output.write(true);
+}
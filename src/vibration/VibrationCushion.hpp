@@ -0,0 +1,52 @@
+#pragma once
+
+#include "VibrationPattern.hpp"
+
+#include "FreeRTOS.h"
+#include "main.h"
+#include "timers.h"
+#include "util/gpio.hpp"
+
+/// Drives the vibration cushion on PH1 with a pattern.
+/// Steps are advanced by a one-shot software timer, so there are only wakeups at step changes.
+/// PH1 has no timer channel, so intermediate intensities are generated by software PWM inside the
+/// display multiplexing interrupt (4kHz). It is always running during an alarm, because the alarm
+/// wakes up the display. Full and zero intensity do not depend on the interrupt.
+class VibrationCushion
+{
+public:
+    explicit VibrationCushion(TimerCallbackFunction_t stepCallback) : stepCallback(stepCallback)
+    {
+    }
+
+    /// has to be called from timer service task
+    void play(vibration::PatternId patternId);
+
+    /// has to be called from timer service task
+    void stop();
+
+    bool isPlaying() const
+    {
+        return player.isPlaying();
+    }
+
+    void handleStepTimer();
+
+    /// called by display multiplexing interrupt
+    void pwmTick();
+
+private:
+    vibration::PatternPlayer player;
+    util::Gpio output{VibrationCushion_GPIO_Port, VibrationCushion_Pin};
+
+    volatile uint8_t intensity = 0;
+    uint8_t pwmCounter = 0;
+
+    TimerCallbackFunction_t stepCallback = nullptr;
+    StaticTimer_t stepTimerBuffer{};
+    TimerHandle_t stepTimer{
+        xTimerCreateStatic("vibrationTimer", 1, pdFALSE, nullptr, stepCallback, &stepTimerBuffer)};
+
+    void applyNextStep();
+    void setIntensity(uint8_t newIntensity);
+};
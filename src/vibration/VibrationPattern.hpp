@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/// Vibration patterns are stored as one byte per step:
+/// bit 7..5 intensity (0 = off ... 7 = full power), bit 4..0 duration in units of 50ms.
+/// A step with zero duration marks the end, afterwards the pattern starts over again.
+namespace vibration
+{
+using Step = uint8_t;
+
+constexpr auto DurationBits = 5;
+constexpr uint8_t DurationMask = (1 << DurationBits) - 1;
+constexpr uint16_t DurationUnitMs = 50;
+constexpr uint8_t MaximumIntensity = 7;
+constexpr Step EndOfPattern = 0;
+
+constexpr Step makeStep(uint8_t intensity, uint16_t durationMs)
+{
+    return (intensity << DurationBits) | ((durationMs / DurationUnitMs) & DurationMask);
+}
+
+constexpr uint8_t getIntensity(Step step)
+{
+    return step >> DurationBits;
+}
+
+constexpr uint16_t getDurationMs(Step step)
+{
+    return (step & DurationMask) * DurationUnitMs;
+}
+
+constexpr auto MaximumStepsPerPattern = 8;
+using Pattern = std::array<Step, MaximumStepsPerPattern>;
+
+enum class PatternId : uint8_t
+{
+    Pulse,
+    Heartbeat,
+    Ramp,
+    Continuous
+};
+
+// clang-format off
+constexpr std::array<Pattern, 4> Patterns =
+{{
+    // Pulse
+    {makeStep(7, 500), makeStep(0, 500)},
+
+    // Heartbeat
+    {makeStep(7, 150), makeStep(0, 100), makeStep(7, 150), makeStep(0, 800)},
+
+    // Ramp
+    {makeStep(2, 400), makeStep(3, 400), makeStep(4, 400), makeStep(5, 400), makeStep(6, 400),
+     makeStep(7, 800), makeStep(0, 600)},
+
+    // Continuous
+    {makeStep(7, 1550)},
+}};
+// clang-format on
+
+constexpr const Pattern &getPattern(PatternId id)
+{
+    return Patterns[static_cast<size_t>(id)];
+}
+
+/// Steps through a pattern, independent from any hardware or RTOS.
+/// The caller applies the intensity and calls nextStep() again after the returned duration,
+/// so the output timeline can be recorded on host easily.
+class PatternPlayer
+{
+public:
+    struct Output
+    {
+        uint8_t intensity = 0;
+        uint16_t durationMs = 0;
+    };
+
+    void start(const Pattern &newPattern)
+    {
+        pattern = &newPattern;
+        stepIndex = 0;
+    }
+
+    void stop()
+    {
+        pattern = nullptr;
+    }
+
+    bool isPlaying() const
+    {
+        return pattern != nullptr;
+    }
+
+    /// @return output for the next step, nothing if the player is stopped or the pattern is empty
+    std::optional<Output> nextStep()
+    {
+        if (pattern == nullptr)
+            return {};
+
+        if (stepIndex >= pattern->size() || (*pattern)[stepIndex] == EndOfPattern)
+            stepIndex = 0;
+
+        const Step CurrentStep = (*pattern)[stepIndex++];
+        if (CurrentStep == EndOfPattern)
+            return {};
+
+        return Output{getIntensity(CurrentStep), getDurationMs(CurrentStep)};
+    }
+
+private:
+    const Pattern *pattern = nullptr;
+    size_t stepIndex = 0;
+};
+} // namespace vibration